@@ -0,0 +1,696 @@
+/**
+ *  Benchmarks mfpkg::forward_list against std::forward_list, std::list
+ *  and std::vector.
+ *
+ *  Every operation is timed for int, float, std::string and a 64 byte
+ *  struct at sizes 10, 100, ... up to --max elements.  An operation runs
+ *  once to warm up the caches and the allocator, then --repeat more
+ *  times on a freshly built container each time.  Each row reports the
+ *  run with the median time: the throughput in million elements (or
+ *  calls) per second, the time, the number of heap allocations made
+ *  during its timed region, and the peak resident set size of all
+ *  runs.  Every operation of every container, type and size runs in its
+ *  own child process, so the node cache and peak RSS are not inherited
+ *  from earlier operations and one run exhausting memory does not end
+ *  the others.
+ *
+ *  Operations that are linear per call, such as pop_back() on a singly
+ *  linked list or push_front() on a vector, make only as many calls as
+ *  keep the run near 10^8 element steps.
+ *
+ *  Usage: mfpkg_benchmark [--min N] [--max N] [--repeat N]
+ *                         [--container NAME] [--type NAME] [--op NAME]
+ *
+ *  --max defaults to 10^6; pass --max 100000000 for the full range.
+ *  --repeat defaults to 5 timed runs per operation.
+ *  The filters select one container (mfpkg, forward_list, list, vector),
+ *  one type (int, float, string, blob64) or the operations whose name
+ *  contains NAME.
+ *
+ *  @file benchmark.cpp
+ */
+
+#include <forward_list>
+#include <list>
+
+#include "common.h"
+
+namespace bench
+{
+    struct blob64
+    {
+        std::uint64_t words[8];
+
+        bool operator<(const blob64& __b) const noexcept { return words[0] < __b.words[0]; }
+        bool operator>(const blob64& __b) const noexcept { return words[0] > __b.words[0]; }
+        bool operator==(const blob64& __b) const noexcept { return words[0] == __b.words[0]; }
+    };
+
+    static_assert(sizeof(blob64) == 64, "blob64 must be 64 bytes");
+
+    template <typename _Tp> struct type_name;
+    template <> struct type_name<int> { static constexpr const char* value = "int"; };
+    template <> struct type_name<float> { static constexpr const char* value = "float"; };
+    template <> struct type_name<std::string> { static constexpr const char* value = "string"; };
+    template <> struct type_name<blob64> { static constexpr const char* value = "blob64"; };
+
+    template <typename _Tp>
+    _Tp make(std::uint64_t __k)
+    {
+        if constexpr (std::is_same<_Tp, std::string>::value)
+        {
+            return "v" + std::to_string(__k);
+        }
+        else if constexpr (std::is_same<_Tp, blob64>::value)
+        {
+            blob64 __b;
+            for (auto& __w : __b.words)
+            {
+                __w = __k;
+            }
+            return __b;
+        }
+        else
+        {
+            return _Tp(__k);
+        }
+    }
+
+    template <typename _Tp>
+    std::uint64_t key(const _Tp& __x)
+    {
+        if constexpr (std::is_same<_Tp, std::string>::value)
+        {
+            return std::uint64_t(__x.back());
+        }
+        else if constexpr (std::is_same<_Tp, blob64>::value)
+        {
+            return __x.words[0];
+        }
+        else
+        {
+            return std::uint64_t(__x);
+        }
+    }
+
+    template <typename _Tp>
+    bool odd(const _Tp& __x)
+    {
+        return key(__x) & 1;
+    }
+
+    enum class order { sorted, reversed, random, runs };
+
+    inline std::uint64_t key_at(order __o, std::size_t __i, std::size_t __n)
+    {
+        switch (__o)
+        {
+        case order::sorted:
+            return __i;
+        case order::reversed:
+            return __n - 1 - __i;
+        case order::runs:
+            return __i / 4;
+        default:
+            {
+                std::uint64_t __z = __i + 0x9e3779b97f4a7c15ull;
+                __z = (__z ^ (__z >> 30)) * 0xbf58476d1ce4e5b9ull;
+                __z = (__z ^ (__z >> 27)) * 0x94d049bb133111ebull;
+                return (__z ^ (__z >> 31)) % __n;
+            }
+        }
+    }
+
+    template <typename _Cont> struct kind { static constexpr int value = -1; };
+    template <typename _Tp, typename _Pp> struct kind<mfpkg::forward_list<_Tp, _Pp>>
+    { static constexpr int value = 0; static constexpr const char* name = "mfpkg"; };
+    template <typename _Tp, typename _Ap> struct kind<std::forward_list<_Tp, _Ap>>
+    { static constexpr int value = 1; static constexpr const char* name = "forward_list"; };
+    template <typename _Tp, typename _Ap> struct kind<std::list<_Tp, _Ap>>
+    { static constexpr int value = 2; static constexpr const char* name = "list"; };
+    template <typename _Tp, typename _Ap> struct kind<std::vector<_Tp, _Ap>>
+    { static constexpr int value = 3; static constexpr const char* name = "vector"; };
+
+    template <typename _Cont> constexpr bool is_mfpkg = kind<_Cont>::value == 0;
+    template <typename _Cont> constexpr bool is_flist = kind<_Cont>::value == 1;
+    template <typename _Cont> constexpr bool is_list = kind<_Cont>::value == 2;
+    template <typename _Cont> constexpr bool is_vector = kind<_Cont>::value == 3;
+
+    /**
+     * Number of calls of an operation that is linear per call on a
+     * container of @a __n elements.
+     */
+    inline std::size_t bounded(std::size_t __n)
+    {
+        return std::max<std::size_t>(1, std::min<std::size_t>(__n, 100000000 / __n));
+    }
+
+    template <typename _Cont>
+    _Cont build(std::size_t __n, order __o = order::random)
+    {
+        typedef typename _Cont::value_type _Tp;
+        _Cont __c;
+        if constexpr (is_flist<_Cont>)
+        {
+            auto __tail = __c.before_begin();
+            for (std::size_t __i = 0; __i < __n; ++__i)
+            {
+                __tail = __c.insert_after(__tail, make<_Tp>(key_at(__o, __i, __n)));
+            }
+        }
+        else
+        {
+            for (std::size_t __i = 0; __i < __n; ++__i)
+            {
+                __c.push_back(make<_Tp>(key_at(__o, __i, __n)));
+            }
+        }
+        return __c;
+    }
+
+    struct result
+    {
+        std::size_t items;
+        double seconds;
+        std::uint64_t allocations;
+    };
+
+    template <typename _Function>
+    result measure(std::size_t __items, _Function __f)
+    {
+        std::uint64_t __a = allocations.load(std::memory_order_relaxed);
+        auto __t = std::chrono::steady_clock::now();
+        __f();
+        std::chrono::duration<double> __d = std::chrono::steady_clock::now() - __t;
+        return {__items, __d.count(), allocations.load(std::memory_order_relaxed) - __a};
+    }
+
+    template <typename _Cont>
+    result push_back(std::size_t __n)
+    {
+        typedef typename _Cont::value_type _Tp;
+        _Cont __c;
+        return measure(__n, [&]
+        {
+            if constexpr (is_flist<_Cont>)
+            {
+                auto __tail = __c.before_begin();
+                for (std::size_t __i = 0; __i < __n; ++__i)
+                {
+                    __tail = __c.insert_after(__tail, make<_Tp>(__i));
+                }
+            }
+            else
+            {
+                for (std::size_t __i = 0; __i < __n; ++__i)
+                {
+                    __c.push_back(make<_Tp>(__i));
+                }
+            }
+        });
+    }
+
+    template <typename _Cont>
+    result push_front(std::size_t __n)
+    {
+        typedef typename _Cont::value_type _Tp;
+        _Cont __c;
+        if constexpr (is_vector<_Cont>)
+        {
+            __c = build<_Cont>(__n);
+            const std::size_t __m = bounded(__n);
+            return measure(__m, [&]
+            {
+                for (std::size_t __i = 0; __i < __m; ++__i)
+                {
+                    __c.insert(__c.begin(), make<_Tp>(__i));
+                }
+            });
+        }
+        else
+        {
+            return measure(__n, [&]
+            {
+                for (std::size_t __i = 0; __i < __n; ++__i)
+                {
+                    __c.push_front(make<_Tp>(__i));
+                }
+            });
+        }
+    }
+
+    template <typename _Cont>
+    result pop_front(std::size_t __n)
+    {
+        _Cont __c = build<_Cont>(__n);
+        if constexpr (is_vector<_Cont>)
+        {
+            const std::size_t __m = bounded(__n);
+            return measure(__m, [&]
+            {
+                for (std::size_t __i = 0; __i < __m; ++__i)
+                {
+                    __c.erase(__c.begin());
+                }
+            });
+        }
+        else
+        {
+            return measure(__n, [&]
+            {
+                for (std::size_t __i = 0; __i < __n; ++__i)
+                {
+                    __c.pop_front();
+                }
+            });
+        }
+    }
+
+    template <typename _Cont>
+    result pop_back(std::size_t __n)
+    {
+        _Cont __c = build<_Cont>(__n);
+        if constexpr (is_flist<_Cont>)
+        {
+            const std::size_t __m = bounded(__n);
+            return measure(__m, [&]
+            {
+                for (std::size_t __i = 0; __i < __m; ++__i)
+                {
+                    auto __prev = __c.before_begin();
+                    for (auto __it = __c.begin(); std::next(__it) != __c.end(); ++__it)
+                    {
+                        __prev = __it;
+                    }
+                    __c.erase_after(__prev);
+                }
+            });
+        }
+        else
+        {
+            const std::size_t __m = is_mfpkg<_Cont> ? bounded(__n) : __n;
+            return measure(__m, [&]
+            {
+                for (std::size_t __i = 0; __i < __m; ++__i)
+                {
+                    __c.pop_back();
+                }
+            });
+        }
+    }
+
+    /**
+     * Inserts after a fixed position in the middle of the container.
+     */
+    template <typename _Cont>
+    result insert_after(std::size_t __n)
+    {
+        typedef typename _Cont::value_type _Tp;
+        _Cont __c = build<_Cont>(__n);
+        if constexpr (is_vector<_Cont>)
+        {
+            const std::size_t __m = bounded(__n);
+            return measure(__m, [&]
+            {
+                for (std::size_t __i = 0; __i < __m; ++__i)
+                {
+                    __c.insert(__c.begin() + __n / 2 + 1, make<_Tp>(__i));
+                }
+            });
+        }
+        else
+        {
+            auto __mid = __c.begin();
+            std::advance(__mid, __n / 2);
+            return measure(__n, [&]
+            {
+                for (std::size_t __i = 0; __i < __n; ++__i)
+                {
+                    if constexpr (is_list<_Cont>)
+                    {
+                        __c.insert(std::next(__mid), make<_Tp>(__i));
+                    }
+                    else
+                    {
+                        __c.insert_after(__mid, make<_Tp>(__i));
+                    }
+                }
+            });
+        }
+    }
+
+    /**
+     * Moves every element of one container to another, one at a time.
+     * The vector moves from the back of one to the back of the other.
+     */
+    template <typename _Cont>
+    result splice_element(std::size_t __n)
+    {
+        _Cont __a = build<_Cont>(__n);
+        _Cont __b;
+        return measure(__n, [&]
+        {
+            for (std::size_t __i = 0; __i < __n; ++__i)
+            {
+                if constexpr (is_vector<_Cont>)
+                {
+                    __b.push_back(std::move(__a.back()));
+                    __a.pop_back();
+                }
+                else if constexpr (is_list<_Cont>)
+                {
+                    __b.splice(__b.begin(), __a, __a.begin());
+                }
+                else
+                {
+                    __b.splice_after(__b.before_begin(), __a, __a.before_begin());
+                }
+            }
+        });
+    }
+
+    /**
+     * Moves every element of one container to another in ranges of 64.
+     */
+    template <typename _Cont>
+    result splice_range(std::size_t __n)
+    {
+        _Cont __a = build<_Cont>(__n);
+        _Cont __b;
+        return measure(__n, [&]
+        {
+            for (std::size_t __left = __n; __left; )
+            {
+                std::size_t __k = std::min<std::size_t>(__left, 64);
+                if constexpr (is_vector<_Cont>)
+                {
+                    __b.insert(__b.end(), std::make_move_iterator(__a.end() - __k),
+                                          std::make_move_iterator(__a.end()));
+                    __a.erase(__a.end() - __k, __a.end());
+                }
+                else if constexpr (is_list<_Cont>)
+                {
+                    __b.splice(__b.begin(), __a, __a.begin(), std::next(__a.begin(), __k));
+                }
+                else
+                {
+                    __b.splice_after(__b.before_begin(), __a, __a.before_begin(),
+                                     std::next(__a.begin(), __k));
+                }
+                __left -= __k;
+            }
+        });
+    }
+
+    /**
+     * Moves whole containers of 64 elements into one container.
+     */
+    template <typename _Cont>
+    result splice_list(std::size_t __n)
+    {
+        std::vector<_Cont> __parts;
+        for (std::size_t __left = __n; __left; )
+        {
+            std::size_t __k = std::min<std::size_t>(__left, 64);
+            __parts.push_back(build<_Cont>(__k));
+            __left -= __k;
+        }
+        _Cont __b;
+        return measure(__n, [&]
+        {
+            for (auto& __part : __parts)
+            {
+                if constexpr (is_vector<_Cont>)
+                {
+                    __b.insert(__b.end(), std::make_move_iterator(__part.begin()),
+                                          std::make_move_iterator(__part.end()));
+                    __part.clear();
+                }
+                else if constexpr (is_list<_Cont>)
+                {
+                    __b.splice(__b.begin(), __part);
+                }
+                else
+                {
+                    __b.splice_after(__b.before_begin(), __part);
+                }
+            }
+        });
+    }
+
+    template <typename _Cont>
+    result sort(std::size_t __n, order __o)
+    {
+        _Cont __c = build<_Cont>(__n, __o);
+        return measure(__n, [&]
+        {
+            if constexpr (is_vector<_Cont>)
+            {
+                std::sort(__c.begin(), __c.end());
+            }
+            else
+            {
+                __c.sort();
+            }
+        });
+    }
+
+    template <typename _Cont>
+    result remove_if(std::size_t __n)
+    {
+        typedef typename _Cont::value_type _Tp;
+        _Cont __c = build<_Cont>(__n);
+        return measure(__n, [&]
+        {
+            if constexpr (is_vector<_Cont>)
+            {
+                __c.erase(std::remove_if(__c.begin(), __c.end(), odd<_Tp>), __c.end());
+            }
+            else
+            {
+                __c.remove_if(odd<_Tp>);
+            }
+        });
+    }
+
+    template <typename _Cont>
+    result unique(std::size_t __n)
+    {
+        _Cont __c = build<_Cont>(__n, order::runs);
+        return measure(__n, [&]
+        {
+            if constexpr (is_vector<_Cont>)
+            {
+                __c.erase(std::unique(__c.begin(), __c.end()), __c.end());
+            }
+            else
+            {
+                __c.unique();
+            }
+        });
+    }
+
+    template <typename _Cont>
+    result reverse(std::size_t __n)
+    {
+        _Cont __c = build<_Cont>(__n);
+        return measure(__n, [&]
+        {
+            if constexpr (is_vector<_Cont>)
+            {
+                std::reverse(__c.begin(), __c.end());
+            }
+            else
+            {
+                __c.reverse();
+            }
+        });
+    }
+
+    /**
+     * Truncates to half the size and grows back.
+     */
+    template <typename _Cont>
+    result resize(std::size_t __n)
+    {
+        _Cont __c = build<_Cont>(__n);
+        return measure(__n, [&]
+        {
+            __c.resize(__n / 2);
+            __c.resize(__n);
+        });
+    }
+
+    template <typename _Cont>
+    result copy(std::size_t __n)
+    {
+        _Cont __c = build<_Cont>(__n);
+        std::vector<_Cont> __d;
+        __d.reserve(1);
+        return measure(__n, [&]
+        {
+            __d.emplace_back(__c);
+        });
+    }
+
+    template <typename _Cont>
+    result assign(std::size_t __n)
+    {
+        _Cont __a = build<_Cont>(__n);
+        _Cont __b = build<_Cont>(__n, order::sorted);
+        return measure(__n, [&]
+        {
+            __b = __a;
+        });
+    }
+
+    struct options
+    {
+        std::size_t min = 10;
+        std::size_t max = 1000000;
+        std::size_t repeat = 5;
+        const char* container = nullptr;
+        const char* type = nullptr;
+        const char* op = nullptr;
+    };
+
+    inline void report(const char* __container, const char* __type, std::size_t __n,
+                       const char* __op, const result& __r)
+    {
+        double __rate = __r.seconds > 0 ? double(__r.items) / __r.seconds / 1e6 : 0.0;
+        std::printf("%-13s %-7s %10zu %-15s %10zu %12.4g %12.3f %12" PRIu64 " %10.1f\n",
+                    __container, __type, __n, __op, __r.items, __rate,
+                    __r.seconds * 1e3, __r.allocations, peak_rss_mib());
+    }
+
+    /**
+     * Runs @a __f once as a warm-up, then @a __times more, and returns
+     * the timed run with the median time.
+     */
+    template <typename _Function>
+    result repeated(std::size_t __times, _Function __f)
+    {
+        __f();
+        std::vector<result> __runs;
+        for (std::size_t __i = 0; __i < std::max<std::size_t>(1, __times); ++__i)
+        {
+            __runs.push_back(__f());
+        }
+        auto __mid = __runs.begin() + std::ptrdiff_t(__runs.size() / 2);
+        std::nth_element(__runs.begin(), __mid, __runs.end(), [](const result& __a, const result& __b)
+        {
+            return __a.seconds < __b.seconds;
+        });
+        return *__mid;
+    }
+
+    template <typename _Cont>
+    void run_case(const options& __opt, std::size_t __n)
+    {
+        const char* __c = kind<_Cont>::name;
+        const char* __t = type_name<typename _Cont::value_type>::value;
+        auto __run = [&](const char* __op, auto __f)
+        {
+            if(__opt.op && !std::strstr(__op, __opt.op))
+            {
+                return;
+            }
+            if(!run_isolated([&] { report(__c, __t, __n, __op, repeated(__opt.repeat, __f)); }))
+            {
+                std::printf("%-13s %-7s %10zu %-15s failed (out of memory?)\n", __c, __t, __n, __op);
+            }
+            std::fflush(stdout);
+        };
+        __run("push_back", [&] { return push_back<_Cont>(__n); });
+        __run("push_front", [&] { return push_front<_Cont>(__n); });
+        __run("pop_front", [&] { return pop_front<_Cont>(__n); });
+        __run("pop_back", [&] { return pop_back<_Cont>(__n); });
+        __run("insert_after", [&] { return insert_after<_Cont>(__n); });
+        __run("splice_element", [&] { return splice_element<_Cont>(__n); });
+        __run("splice_range", [&] { return splice_range<_Cont>(__n); });
+        __run("splice_list", [&] { return splice_list<_Cont>(__n); });
+        __run("sort_random", [&] { return sort<_Cont>(__n, order::random); });
+        __run("sort_sorted", [&] { return sort<_Cont>(__n, order::sorted); });
+        __run("sort_reversed", [&] { return sort<_Cont>(__n, order::reversed); });
+        __run("remove_if", [&] { return remove_if<_Cont>(__n); });
+        __run("unique", [&] { return unique<_Cont>(__n); });
+        __run("reverse", [&] { return reverse<_Cont>(__n); });
+        __run("resize", [&] { return resize<_Cont>(__n); });
+        __run("copy", [&] { return copy<_Cont>(__n); });
+        __run("assign", [&] { return assign<_Cont>(__n); });
+    }
+
+    template <typename _Cont>
+    void run_container(const options& __opt, std::size_t __n)
+    {
+        if(__opt.container && std::strcmp(__opt.container, kind<_Cont>::name))
+        {
+            return;
+        }
+        if(__opt.type && std::strcmp(__opt.type, type_name<typename _Cont::value_type>::value))
+        {
+            return;
+        }
+        run_case<_Cont>(__opt, __n);
+    }
+
+    template <typename _Tp>
+    void run_type(const options& __opt, std::size_t __n)
+    {
+        run_container<mfpkg::forward_list<_Tp>>(__opt, __n);
+        run_container<std::forward_list<_Tp>>(__opt, __n);
+        run_container<std::list<_Tp>>(__opt, __n);
+        run_container<std::vector<_Tp>>(__opt, __n);
+    }
+};
+
+int main(int argc, char** argv)
+{
+    bench::options __opt;
+    for (int __i = 1; __i + 1 < argc; __i += 2)
+    {
+        const char* __flag = argv[__i];
+        const char* __value = argv[__i + 1];
+        if(!std::strcmp(__flag, "--min"))
+        {
+            __opt.min = std::max<std::size_t>(1, std::strtoull(__value, nullptr, 10));
+        }
+        else if(!std::strcmp(__flag, "--max"))
+        {
+            __opt.max = std::strtoull(__value, nullptr, 10);
+        }
+        else if(!std::strcmp(__flag, "--repeat"))
+        {
+            __opt.repeat = std::max<std::size_t>(1, std::strtoull(__value, nullptr, 10));
+        }
+        else if(!std::strcmp(__flag, "--container"))
+        {
+            __opt.container = __value;
+        }
+        else if(!std::strcmp(__flag, "--type"))
+        {
+            __opt.type = __value;
+        }
+        else if(!std::strcmp(__flag, "--op"))
+        {
+            __opt.op = __value;
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--min N] [--max N] [--repeat N] "
+                                 "[--container NAME] [--type NAME] [--op NAME]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::printf("%-13s %-7s %10s %-15s %10s %12s %12s %12s %10s\n", "container", "type",
+                "size", "operation", "items", "Mitems/s", "ms", "allocations", "peak MiB");
+    for (std::size_t __n = __opt.min; __n <= __opt.max; __n *= 10)
+    {
+        bench::run_type<int>(__opt, __n);
+        bench::run_type<float>(__opt, __n);
+        bench::run_type<std::string>(__opt, __n);
+        bench::run_type<bench::blob64>(__opt, __n);
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ *  Shared by the benchmark executables: a global operator new that
+ *  counts heap allocations, peak RSS, and running a piece of work in a
+ *  child process.  Include it from exactly one translation unit per
+ *  executable, since it replaces the global allocation functions.
+ *
+ *  @file common.h
+ */
+
+#ifndef MFPKG_BENCHMARK_COMMON_H
+#define MFPKG_BENCHMARK_COMMON_H
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#if defined(__unix__)
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "../include/mfpkg.h"
+
+static std::atomic<std::uint64_t> allocations {0};
+
+void* operator new(std::size_t __n)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void* __p = std::malloc(__n ? __n : 1))
+    {
+        return __p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t __n, const std::nothrow_t&) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(__n ? __n : 1);
+}
+
+void* operator new(std::size_t __n, std::align_val_t __a)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t __align = std::max(std::size_t(__a), sizeof(void*));
+    void* __p = nullptr;
+    if(::posix_memalign(&__p, __align, __n ? __n : 1))
+    {
+        throw std::bad_alloc();
+    }
+    return __p;
+}
+
+void* operator new(std::size_t __n, std::align_val_t __a, const std::nothrow_t&) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t __align = std::max(std::size_t(__a), sizeof(void*));
+    void* __p = nullptr;
+    return ::posix_memalign(&__p, __align, __n ? __n : 1) ? nullptr : __p;
+}
+
+/**
+ * Kept out of line so that the compiler does not pair the inlined
+ * std::free with a visible operator new and warn about the mismatch.
+ */
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static void release(void* __p) noexcept
+{
+    std::free(__p);
+}
+
+void operator delete(void* __p) noexcept { release(__p); }
+void operator delete(void* __p, std::size_t) noexcept { release(__p); }
+void operator delete(void* __p, std::align_val_t) noexcept { release(__p); }
+void operator delete(void* __p, std::size_t, std::align_val_t) noexcept { release(__p); }
+
+namespace bench
+{
+    inline double peak_rss_mib(void)
+    {
+#if defined(__unix__)
+        struct rusage __u;
+        getrusage(RUSAGE_SELF, &__u);
+        return double(__u.ru_maxrss) / 1024.0;
+#else
+        return 0.0;
+#endif
+    }
+
+    /**
+     * Runs @a __f in a child process where fork() is available, so that
+     * peak RSS starts afresh and running out of memory ends only the
+     * child.  Returns false if the child did not exit normally.
+     */
+    template <typename _Function>
+    bool run_isolated(_Function __f)
+    {
+#if defined(__unix__)
+        std::fflush(stdout);
+        pid_t __pid = fork();
+        if(__pid == 0)
+        {
+            __f();
+            std::fflush(stdout);
+            _exit(0);
+        }
+        int __status = 0;
+        return __pid > 0 && waitpid(__pid, &__status, 0) == __pid
+                         && WIFEXITED(__status) && !WEXITSTATUS(__status);
+#else
+        __f();
+        return true;
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ *  Replays an operation trace recorded by mfpkg::traced_forward_list
+ *  against every list backend the library offers and reports the time,
+ *  heap allocations and peak RSS of each.
+ *
+ *  Backends:
+ *    mfpkg    mfpkg::forward_list with nodes from node_cache and the heap
+ *    arena    mfpkg::forward_list with nodes from a mfpkg::node_arena
+ *    compact  mfpkg::compact_forward_list, all lists sharing one arena
+ *             per element type, sorted by the index_chain merge sort
+ *    std      std::forward_list, as the baseline
+ *
+ *  Elements are replaced by payloads of the recorded size with random
+ *  keys: trivially copyable types by a struct of 8 to 256 bytes, other
+ *  types by a std::string of the recorded length.  remove and unique
+ *  drop as many evenly spaced elements as they did when recorded.
+ *  Positions are reached from a cursor kept at the last position used,
+ *  so sequential access replays in constant time per operation.
+ *
+ *  Usage: mfpkg_replay TRACE [--backend NAME] [--repeat N]
+ *
+ *  @file replay.cpp
+ */
+
+#include <fstream>
+
+#include "common.h"
+#include "replay.h"
+
+namespace bench
+{
+    template <backend _Backend>
+    void run(const std::vector<mfpkg::trace_record>& __trace, unsigned __repeat)
+    {
+        double __best = 0;
+        std::uint64_t __allocations = 0;
+        for (unsigned __i = 0; __i < __repeat; ++__i)
+        {
+            std::uint64_t __a = allocations.load(std::memory_order_relaxed);
+            auto __t = std::chrono::steady_clock::now();
+            if constexpr (_Backend == backend::arena)
+            {
+#if defined(MFPKG_HAS_NODE_ARENA)
+                mfpkg::node_arena __arena;
+                mfpkg::node_arena::scope __scope(__arena);
+                replay<_Backend>(__trace);
+#endif
+            }
+            else
+            {
+                replay<_Backend>(__trace);
+            }
+            std::chrono::duration<double> __d = std::chrono::steady_clock::now() - __t;
+            if(!__i || __d.count() < __best)
+            {
+                __best = __d.count();
+            }
+            __allocations = allocations.load(std::memory_order_relaxed) - __a;
+        }
+        std::printf("%-8s %12.3f %14.3f %12" PRIu64 " %10.1f\n", backend_name(_Backend),
+                    __best * 1e3, double(__trace.size()) / __best / 1e6, __allocations,
+                    peak_rss_mib());
+    }
+};
+
+int main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        std::fprintf(stderr, "usage: %s TRACE [--backend NAME] [--repeat N]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    const char* __only = nullptr;
+    unsigned __repeat = 3;
+    for (int __i = 2; __i + 1 < argc; __i += 2)
+    {
+        if(!std::strcmp(argv[__i], "--backend"))
+        {
+            __only = argv[__i + 1];
+        }
+        else if(!std::strcmp(argv[__i], "--repeat"))
+        {
+            __repeat = std::max(1, std::atoi(argv[__i + 1]));
+        }
+    }
+
+    std::vector<mfpkg::trace_record> __trace;
+    try
+    {
+        std::ifstream __in(argv[1], std::ios::binary);
+        if(!__in)
+        {
+            std::fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[1]);
+            return EXIT_FAILURE;
+        }
+        __trace = mfpkg::trace_log::read(__in);
+    }
+    catch (const std::exception& __e)
+    {
+        std::fprintf(stderr, "%s: %s\n", argv[1], __e.what());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("%zu operations, best of %u runs\n", __trace.size(), __repeat);
+    std::printf("%-8s %12s %14s %12s %10s\n", "backend", "ms", "Mops/s", "allocations", "peak MiB");
+    auto __each = [&](bench::backend __b, auto __run)
+    {
+        if(!__only || !std::strcmp(__only, bench::backend_name(__b)))
+        {
+            if(!bench::run_isolated(__run))
+            {
+                std::printf("%-8s failed\n", bench::backend_name(__b));
+            }
+        }
+    };
+    __each(bench::backend::mfpkg, [&] { bench::run<bench::backend::mfpkg>(__trace, __repeat); });
+#if defined(MFPKG_HAS_NODE_ARENA)
+    __each(bench::backend::arena, [&] { bench::run<bench::backend::arena>(__trace, __repeat); });
+#endif
+    __each(bench::backend::compact, [&] { bench::run<bench::backend::compact>(__trace, __repeat); });
+    __each(bench::backend::standard, [&] { bench::run<bench::backend::standard>(__trace, __repeat); });
+    return 0;
+}
@@ -0,0 +1,476 @@
+/**
+ *  The replay machinery of mfpkg_replay: one list per traced list id,
+ *  each replaying the recorded operations on a chosen backend.  Shared
+ *  with the tests, which check the bookkeeping of every backend.
+ *
+ *  @file replay.h
+ */
+
+#ifndef MFPKG_BENCHMARK_REPLAY_H
+#define MFPKG_BENCHMARK_REPLAY_H
+
+#include <cstring>
+#include <forward_list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/mfpkg.h"
+
+namespace bench
+{
+    inline std::uint64_t random_key(void) noexcept
+    {
+        static std::uint64_t __state = 0x9e3779b97f4a7c15ull;
+        __state ^= __state << 13;
+        __state ^= __state >> 7;
+        __state ^= __state << 17;
+        return __state;
+    }
+
+    template <std::size_t _Width>
+    struct payload
+    {
+        std::uint64_t key;
+        char pad[_Width - sizeof(std::uint64_t)];
+
+        bool operator<(const payload& __p) const noexcept { return key < __p.key; }
+        bool operator>(const payload& __p) const noexcept { return key > __p.key; }
+        bool operator==(const payload& __p) const noexcept { return key == __p.key; }
+    };
+
+    template <>
+    struct payload<sizeof(std::uint64_t)>
+    {
+        std::uint64_t key;
+
+        bool operator<(const payload& __p) const noexcept { return key < __p.key; }
+        bool operator>(const payload& __p) const noexcept { return key > __p.key; }
+        bool operator==(const payload& __p) const noexcept { return key == __p.key; }
+    };
+
+    template <typename _Pp>
+    _Pp make(std::uint64_t __size)
+    {
+        if constexpr (std::is_same<_Pp, std::string>::value)
+        {
+            std::string __s(__size, ' ');
+            std::uint64_t __k = random_key();
+            for (std::size_t __i = 0; __i < __s.size() && __i < 8; ++__i, __k >>= 8)
+            {
+                __s[__i] = char('a' + __k % 26);
+            }
+            return __s;
+        }
+        else
+        {
+            _Pp __p;
+            std::memset(&__p, 0, sizeof __p);
+            __p.key = random_key();
+            return __p;
+        }
+    }
+
+    /**
+     * Predicate state for replaying remove and unique through the
+     * function pointer remove_if() of the lists: drops every stride-th
+     * element until the budget runs out.
+     */
+    struct dropper
+    {
+        static inline std::size_t stride = 1;
+        static inline std::size_t seen = 0;
+        static inline std::size_t left = 0;
+
+        template <typename _Pp>
+        static bool drop(const _Pp&)
+        {
+            if(left && ++seen % stride == 0)
+            {
+                --left;
+                return true;
+            }
+            return false;
+        }
+    };
+
+    enum class backend { mfpkg, arena, compact, standard };
+
+    inline const char* backend_name(backend __b) noexcept
+    {
+        static const char* const __names[] = {"mfpkg", "arena", "compact", "std"};
+        return __names[int(__b)];
+    }
+
+    class replay_list
+    {
+    public:
+
+        virtual ~replay_list() { }
+        virtual void apply(const mfpkg::trace_record& __r) = 0;
+        virtual std::unique_ptr<replay_list> clone(void) const = 0;
+
+        /**
+         * Walks the list and returns false if the element count, the
+         * cursor or the remembered tail disagree with it.
+         */
+        virtual bool consistent(void) = 0;
+    };
+
+    template <backend _Backend, typename _Pp>
+    class list_of : public replay_list
+    {
+    private:
+
+        typedef std::conditional_t<_Backend == backend::compact, mfpkg::compact_forward_list<_Pp>,
+                std::conditional_t<_Backend == backend::standard, std::forward_list<_Pp>,
+                                   mfpkg::forward_list<_Pp>>> list_type;
+        typedef decltype(std::declval<list_type&>().before_begin()) iterator;
+
+        list_type items;
+        std::size_t count;
+        iterator cursor;
+        std::size_t index;
+        iterator tail;
+        bool tail_known;
+
+        static list_type create(void)
+        {
+            if constexpr (_Backend == backend::compact)
+            {
+                static mfpkg::compact_arena<_Pp> __arena;
+                return list_type(__arena);
+            }
+            else
+            {
+                return list_type();
+            }
+        }
+
+        /**
+         * Elements spliced out of one list and not yet spliced into another.
+         */
+        static list_type& pending(void)
+        {
+            static list_type __pending = create();
+            return __pending;
+        }
+
+    public:
+
+        static void drop_pending(void)
+        {
+            pending().clear();
+        }
+
+    private:
+
+        void rewind(void) noexcept
+        {
+            cursor = items.before_begin();
+            index = 0;
+        }
+
+        /**
+         * Moves the cursor to the position after @a __pos elements.  The
+         * last element is remembered, as a std::forward_list user would
+         * keep an iterator to it for appending.
+         */
+        iterator& seek(std::size_t __pos) noexcept
+        {
+            __pos = std::min(__pos, count);
+            if(__pos < index)
+            {
+                rewind();
+            }
+            if(__pos == count && tail_known)
+            {
+                cursor = tail;
+                index = count;
+            }
+            for (; index < __pos; ++index)
+            {
+                ++cursor;
+            }
+            if(index == count)
+            {
+                tail = cursor;
+                tail_known = true;
+            }
+            return cursor;
+        }
+
+        void remove_some(std::size_t __n)
+        {
+            if(!__n || !count)
+            {
+                return;
+            }
+            dropper::stride = std::max<std::size_t>(1, count / __n);
+            dropper::seen = 0;
+            dropper::left = __n;
+            items.remove_if(dropper::drop<_Pp>);
+            count -= __n - dropper::left;
+            tail_known = false;
+            rewind();
+        }
+
+    public:
+
+        list_of() : items(create()), count(0), tail_known(false)
+        {
+            rewind();
+        }
+
+        list_of(const list_of& __l) : items(__l.items), count(__l.count), tail_known(false)
+        {
+            rewind();
+        }
+
+        std::unique_ptr<replay_list> clone(void) const override
+        {
+            return std::unique_ptr<replay_list>(new list_of(*this));
+        }
+
+        bool consistent(void) override
+        {
+            if(index > count)
+            {
+                return false;
+            }
+            bool __cursor = false;
+            std::size_t __n = 0;
+            iterator __it = items.before_begin();
+            for (;; ++__n)
+            {
+                __cursor = __cursor || (__n == index && __it == cursor);
+                iterator __next = __it;
+                if(++__next == items.end())
+                {
+                    break;
+                }
+                __it = __next;
+            }
+            return __n == count && __cursor && (!tail_known || __it == tail);
+        }
+
+        void apply(const mfpkg::trace_record& __r) override
+        {
+            switch (__r.op)
+            {
+            case mfpkg::trace_op::push_front:
+                items.push_front(make<_Pp>(__r.size));
+                tail_known = tail_known && count;
+                ++count;
+                index += index != 0;
+                break;
+            case mfpkg::trace_op::push_back:
+                if constexpr (_Backend == backend::standard)
+                {
+                    tail = cursor = items.insert_after(seek(count), make<_Pp>(__r.size));
+                    ++index;
+                }
+                else
+                {
+                    items.push_back(make<_Pp>(__r.size));
+                    tail_known = false;
+                }
+                ++count;
+                break;
+            case mfpkg::trace_op::insert_after:
+                cursor = items.insert_after(seek(__r.position), make<_Pp>(__r.size));
+                if(index++ == count++)
+                {
+                    tail = cursor;
+                }
+                break;
+            case mfpkg::trace_op::pop_front:
+                if(count)
+                {
+                    items.pop_front();
+                    --count;
+                    tail_known = tail_known && count;
+                    rewind();
+                }
+                break;
+            case mfpkg::trace_op::pop_back:
+                if constexpr (_Backend != backend::standard)
+                {
+                    if(count)
+                    {
+                        items.pop_back();
+                        tail_known = false;
+                        if(index >= count--)
+                        {
+                            rewind();
+                        }
+                    }
+                    break;
+                }
+                [[fallthrough]];
+            case mfpkg::trace_op::erase_after:
+            case mfpkg::trace_op::erase_range:
+                if(count)
+                {
+                    std::size_t __pos = __r.op == mfpkg::trace_op::pop_back
+                                        ? count - 1 : std::min(__r.position, count - 1);
+                    std::size_t __n = __r.op == mfpkg::trace_op::erase_range ? __r.size : 1;
+                    seek(__pos);
+                    for (; __n && index < count; --__n, --count)
+                    {
+                        items.erase_after(cursor);
+                    }
+                    tail_known = tail_known && index < count;
+                }
+                break;
+            case mfpkg::trace_op::splice_out:
+                seek(__r.position);
+                for (std::size_t __n = __r.size; __n && index < count; --__n, --count)
+                {
+                    pending().splice_after(pending().before_begin(), items, cursor);
+                }
+                tail_known = tail_known && index < count;
+                break;
+            case mfpkg::trace_op::splice_in:
+                seek(__r.position);
+                tail_known = tail_known && index < count;
+                for (std::size_t __n = __r.size; __n; --__n, ++count)
+                {
+                    if(pending().empty())
+                    {
+                        items.insert_after(cursor, make<_Pp>(sizeof(_Pp)));
+                    }
+                    else
+                    {
+                        items.splice_after(cursor, pending(), pending().before_begin());
+                    }
+                }
+                break;
+            case mfpkg::trace_op::sort:
+                items.sort();
+                tail_known = false;
+                rewind();
+                break;
+            case mfpkg::trace_op::reverse:
+                items.reverse();
+                tail_known = false;
+                rewind();
+                break;
+            case mfpkg::trace_op::unique:
+            case mfpkg::trace_op::remove:
+                remove_some(__r.size);
+                break;
+            case mfpkg::trace_op::resize:
+                items.resize(__r.position, make<_Pp>(__r.size));
+                count = __r.position;
+                tail_known = false;
+                rewind();
+                break;
+            case mfpkg::trace_op::clear:
+                items.clear();
+                count = 0;
+                tail_known = false;
+                rewind();
+                break;
+            default:
+                break;
+            }
+        }
+    };
+
+    template <backend _Backend>
+    std::unique_ptr<replay_list> create_list(std::uint64_t __width)
+    {
+        replay_list* __l;
+        if(!__width)
+        {
+            __l = new list_of<_Backend, std::string>;
+        }
+        else if(__width <= 8)
+        {
+            __l = new list_of<_Backend, payload<8>>;
+        }
+        else if(__width <= 16)
+        {
+            __l = new list_of<_Backend, payload<16>>;
+        }
+        else if(__width <= 32)
+        {
+            __l = new list_of<_Backend, payload<32>>;
+        }
+        else if(__width <= 64)
+        {
+            __l = new list_of<_Backend, payload<64>>;
+        }
+        else if(__width <= 128)
+        {
+            __l = new list_of<_Backend, payload<128>>;
+        }
+        else
+        {
+            __l = new list_of<_Backend, payload<256>>;
+        }
+        return std::unique_ptr<replay_list>(__l);
+    }
+
+    template <backend _Backend>
+    void drop_pending(void)
+    {
+        list_of<_Backend, std::string>::drop_pending();
+        list_of<_Backend, payload<8>>::drop_pending();
+        list_of<_Backend, payload<16>>::drop_pending();
+        list_of<_Backend, payload<32>>::drop_pending();
+        list_of<_Backend, payload<64>>::drop_pending();
+        list_of<_Backend, payload<128>>::drop_pending();
+        list_of<_Backend, payload<256>>::drop_pending();
+    }
+
+    /**
+     * Spliced out elements that were never spliced back are dropped at
+     * the end, before an arena backing them goes away.  @a __check, if
+     * given, is called with every list after each operation applied to it.
+     */
+    template <backend _Backend>
+    void replay(const std::vector<mfpkg::trace_record>& __trace,
+                void (*__check)(replay_list&) = nullptr)
+    {
+        std::unordered_map<std::uint64_t, std::unique_ptr<replay_list>> __lists;
+        for (const auto& __r : __trace)
+        {
+            switch (__r.op)
+            {
+            case mfpkg::trace_op::create:
+                __lists[__r.list] = create_list<_Backend>(__r.size);
+                break;
+            case mfpkg::trace_op::copy:
+                {
+                    auto __from = __lists.find(__r.position);
+                    __lists[__r.list] = __from != __lists.end() ? __from->second->clone()
+                                                                : create_list<_Backend>(__r.size);
+                }
+                break;
+            case mfpkg::trace_op::destroy:
+                __lists.erase(__r.list);
+                break;
+            default:
+                {
+                    auto __it = __lists.find(__r.list);
+                    if(__it != __lists.end())
+                    {
+                        __it->second->apply(__r);
+                        if(__check)
+                        {
+                            __check(*__it->second);
+                        }
+                    }
+                }
+                break;
+            }
+        }
+        __lists.clear();
+        drop_pending<_Backend>();
+    }
+};
+
+#endif
@@ -0,0 +1,261 @@
+/**
+ *  @brief An awaitable FIFO queue backed by a %forward_list.
+ *
+ *  @tparam _Tp          Type of element.
+ *  @tparam _ThreadSafe  When true, every operation is guarded by a mutex
+ *                       so producers and consumers may live on different
+ *                       threads.  When false, no locking is done at all.
+ *
+ *  Items are kept in a mfpkg::forward_list.  A coroutine that executes
+ *  @c co_await q.pop() on an empty queue is suspended rather than
+ *  blocking its thread; the awaiter itself is the link of an intrusive
+ *  chain of waiters, so waiting never allocates.  push() hands the value
+ *  directly to the oldest waiter and then either resumes it inline or
+ *  passes it to the scheduler given at construction.
+ *
+ *  A suspended pop() must not be destroyed before it is resumed.
+ *
+ *  @file async_queue.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef ASYNC_QUEUE_H
+#define ASYNC_QUEUE_H
+
+template <typename _Tp, bool _ThreadSafe>
+class mfpkg::async_queue : public basic_mfpkg::basic_forward_list
+{
+public:
+
+    /**
+     * Called by push() instead of resuming a waiter inline.
+     * @a __ctx is the context pointer given at construction.
+     */
+    typedef void (*scheduler_type)(std::coroutine_handle<> __h, void* __ctx);
+
+private:
+
+    typedef async_queue<_Tp, _ThreadSafe> _Self;
+
+    struct null_mutex
+    {
+        void lock(void) noexcept {}
+        void unlock(void) noexcept {}
+    };
+
+    typedef typename std::conditional<_ThreadSafe, std::mutex, null_mutex>::type mutex_type;
+    typedef std::lock_guard<mutex_type> lock_type;
+
+    struct waiter : node_base
+    {
+        std::coroutine_handle<> handle;
+        std::optional<_Tp> result;
+    };
+
+    mfpkg::forward_list<_Tp> items;
+    node_base waiters_head;
+    node_base* waiters_tail;
+    std::size_t waiters;
+    scheduler_type scheduler;
+    void* scheduler_ctx;
+    mutable mutex_type mutex;
+
+    bool take(std::optional<_Tp>& __out)
+    {
+        if(items.empty())
+        {
+            return false;
+        }
+        __out.emplace(std::move(items.front()));
+        items.pop_front();
+        return true;
+    }
+
+    void enqueue_waiter(waiter* __w) noexcept
+    {
+        __w->link = nullptr;
+        waiters_tail->link = __w;
+        waiters_tail = __w;
+        ++waiters;
+    }
+
+    waiter* dequeue_waiter(void) noexcept
+    {
+        node_base* __w = waiters_head.link;
+        if(__w)
+        {
+            waiters_head.link = __w->link;
+            if(!waiters_head.link)
+            {
+                waiters_tail = &waiters_head;
+            }
+            --waiters;
+        }
+        return static_cast<waiter*>(__w);
+    }
+
+    void wake(waiter* __w)
+    {
+        if(scheduler)
+        {
+            scheduler(__w->handle, scheduler_ctx);
+        }
+        else
+        {
+            __w->handle.resume();
+        }
+    }
+
+    template <typename _Up>
+    void push_value(_Up&& __val)
+    {
+        waiter* __w = nullptr;
+        {
+            lock_type __lock(mutex);
+            __w = dequeue_waiter();
+            if(!__w)
+            {
+                items.push_back(std::forward<_Up>(__val));
+                return;
+            }
+            __w->result.emplace(std::forward<_Up>(__val));
+        }
+        wake(__w);
+    }
+
+public:
+
+    /**
+     * Awaitable returned by pop().  Completes with the front element of
+     * the queue, suspending the awaiting coroutine while the queue is empty.
+     */
+    class pop_awaiter : private waiter
+    {
+        friend class async_queue;
+
+        _Self* queue;
+
+        explicit pop_awaiter(_Self* __q) noexcept : waiter(), queue(__q) {}
+
+        public:
+
+        bool await_ready(void)
+        {
+            lock_type __lock(queue->mutex);
+            return queue->take(this->result);
+        }
+
+        bool await_suspend(std::coroutine_handle<> __h)
+        {
+            lock_type __lock(queue->mutex);
+            if(queue->take(this->result))
+            {
+                return false;
+            }
+            this->handle = __h;
+            queue->enqueue_waiter(this);
+            return true;
+        }
+
+        _Tp await_resume(void)
+        {
+            return std::move(*this->result);
+        }
+    };
+
+    /**
+     * Creates an empty queue whose waiters are resumed inline by push().
+     */
+    async_queue() noexcept
+    : waiters_head({nullptr}), waiters_tail(&waiters_head), waiters(0),
+      scheduler(nullptr), scheduler_ctx(nullptr) {}
+
+    /**
+     * @brief Creates an empty queue that hands woken waiters to a scheduler.
+     * @param __s   Function receiving each coroutine to be resumed.
+     * @param __ctx Opaque pointer passed back to @a __s.
+     */
+    explicit async_queue(scheduler_type __s, void* __ctx = nullptr) noexcept
+    : waiters_head({nullptr}), waiters_tail(&waiters_head), waiters(0),
+      scheduler(__s), scheduler_ctx(__ctx) {}
+
+    async_queue(const _Self&) = delete;
+
+    _Self& operator=(const _Self&) = delete;
+
+    ~async_queue() noexcept { }
+
+    /**
+     * @brief  Add data to the back of the queue.
+     * @param  __val  Data to be added.
+     *
+     * If a coroutine is waiting in pop(), the value is given to it directly
+     * and the coroutine is resumed (or scheduled) before push() returns;
+     * otherwise the value is appended to the queue in constant time.
+     */
+    void push(const _Tp& __val)
+    {
+        push_value(__val);
+    }
+
+    void push(_Tp&& __val)
+    {
+        push_value(std::move(__val));
+    }
+
+    /**
+     * Returns an awaitable that removes and yields the front element,
+     * suspending the awaiting coroutine until one is pushed.
+     */
+    pop_awaiter pop(void) noexcept
+    {
+        return pop_awaiter(this);
+    }
+
+    /**
+     * @brief  Removes the front element without waiting.
+     * @param  __out  Receives the removed element.
+     * @return true if an element was removed, false if the queue was empty.
+     */
+    bool try_pop(_Tp& __out)
+    {
+        lock_type __lock(mutex);
+        if(items.empty())
+        {
+            return false;
+        }
+        __out = std::move(items.front());
+        items.pop_front();
+        return true;
+    }
+
+    /**
+     * @brief  Returns true if no elements are queued.
+     */
+    bool empty(void) const
+    {
+        lock_type __lock(mutex);
+        return items.empty();
+    }
+
+    /**
+     * @brief  Returns the number of queued elements.
+     */
+    std::size_t size(void) const
+    {
+        lock_type __lock(mutex);
+        return items.size();
+    }
+
+    /**
+     * @brief  Returns the number of coroutines suspended in pop().
+     */
+    std::size_t waiting(void) const
+    {
+        lock_type __lock(mutex);
+        return waiters;
+    }
+};
+
+#endif
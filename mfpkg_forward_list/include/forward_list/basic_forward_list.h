@@ -22,12 +22,201 @@ protected:
         _Tp storage;
     };
 
+    template <typename _Tp>
+    static constexpr bool over_aligned(void) noexcept
+    {
+        return alignof(node<_Tp>) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    }
+
+    /**
+     * Returns heap memory for @a __n nodes, or nullptr when out of memory
+     * or when the size in bytes would overflow.
+     */
+    template <typename _Tp>
+    static void* heap_memory(std::size_t __n) noexcept
+    {
+        if(__n > std::size_t(-1) / sizeof(node<_Tp>))
+        {
+            return nullptr;
+        }
+        if constexpr (over_aligned<_Tp>())
+        {
+            return ::operator new(__n * sizeof(node<_Tp>),
+                                  std::align_val_t(alignof(node<_Tp>)), std::nothrow);
+        }
+        else
+        {
+            return ::operator new(__n * sizeof(node<_Tp>), std::nothrow);
+        }
+    }
+
+    template <typename _Tp>
+    static void free_memory(void* __p) noexcept
+    {
+        if constexpr (over_aligned<_Tp>())
+        {
+            ::operator delete(__p, std::align_val_t(alignof(node<_Tp>)));
+        }
+        else
+        {
+            ::operator delete(__p);
+        }
+    }
+
+    /**
+     * Returns raw memory for a single node, taken from the active
+     * node_arena of the calling thread if any, then from node_cache.
+     * Returns nullptr when out of memory.
+     */
+    template <typename _Tp>
+    static void* node_memory(void) noexcept
+    {
+#if defined(MFPKG_HAS_NODE_ARENA)
+        if(mfpkg::node_arena* __a = mfpkg::node_arena::active())
+        {
+            if(void* __p = __a->allocate(sizeof(node<_Tp>), alignof(node<_Tp>)))
+            {
+                return __p;
+            }
+        }
+#endif
+        if constexpr (basic_mfpkg::node_cache::cached(sizeof(node<_Tp>), alignof(node<_Tp>)))
+        {
+            return basic_mfpkg::node_cache::allocate(sizeof(node<_Tp>));
+        }
+        else
+        {
+            return heap_memory<_Tp>(1);
+        }
+    }
+
+    /**
+     * Releases the memory of a single node whose payload is already
+     * destroyed, either to the region it was carved from, to node_cache
+     * or to the heap.
+     */
+    template <typename _Tp>
+    static void free_node_memory(void* __p) noexcept
+    {
+        if(basic_mfpkg::node_regions::release(__p, sizeof(node<_Tp>), alignof(node<_Tp>)))
+        {
+            return;
+        }
+        if constexpr (basic_mfpkg::node_cache::cached(sizeof(node<_Tp>), alignof(node<_Tp>)))
+        {
+            basic_mfpkg::node_cache::deallocate(__p, sizeof(node<_Tp>));
+        }
+        else
+        {
+            free_memory<_Tp>(__p);
+        }
+    }
+
+    /**
+     * Allocates and constructs a node holding @a __val.
+     * Returns nullptr when out of memory.
+     */
+    template <typename _Tp, typename _Arg>
+    static node<_Tp>* new_node(_Arg&& __val)
+    {
+        void* __p = node_memory<_Tp>();
+        if(!__p)
+        {
+            return nullptr;
+        }
+        try
+        {
+            return ::new (__p) node<_Tp>{{nullptr}, std::forward<_Arg>(__val)};
+        }
+        catch (...)
+        {
+            free_node_memory<_Tp>(__p);
+            throw;
+        }
+    }
+
+    template <typename _Tp>
+    static void delete_node(node_base* __n) noexcept
+    {
+        node<_Tp>* __node = static_cast<node<_Tp>*>(__n);
+        __node->~node();
+        free_node_memory<_Tp>(__node);
+    }
+
+    /**
+     * A contiguous array of nodes registered with node_regions, so that
+     * each of its nodes can still be released one at a time.  The block
+     * frees itself when its last node is released.
+     */
+    template <typename _Tp>
+    struct node_block : basic_mfpkg::node_regions::region
+    {
+        std::atomic<std::size_t> live;
+        node<_Tp>* nodes;
+
+        /**
+         * Allocates room for @a __n nodes; all of them count as live
+         * until released.  Returns nullptr when out of memory.
+         */
+        static node_block* create(std::size_t __n) noexcept
+        {
+            node_block* __b = new (std::nothrow) node_block;
+            if(!__b)
+            {
+                return nullptr;
+            }
+            __b->nodes = static_cast<node<_Tp>*>(heap_memory<_Tp>(__n));
+            if(!__b->nodes)
+            {
+                delete __b;
+                return nullptr;
+            }
+            __b->first = reinterpret_cast<const char*>(__b->nodes);
+            __b->last = reinterpret_cast<const char*>(__b->nodes + __n);
+            __b->release = &node_block::release_one;
+            __b->live.store(__n, std::memory_order_relaxed);
+            try
+            {
+                basic_mfpkg::node_regions::insert(__b);
+            }
+            catch (...)
+            {
+                free_memory<_Tp>(__b->nodes);
+                delete __b;
+                return nullptr;
+            }
+            return __b;
+        }
+
+        /**
+         * Releases @a __k nodes that were never handed out.
+         */
+        void drop(std::size_t __k) noexcept
+        {
+            if(__k && live.fetch_sub(__k, std::memory_order_acq_rel) == __k)
+            {
+                basic_mfpkg::node_regions::erase(this);
+                free_memory<_Tp>(nodes);
+                delete this;
+            }
+        }
+
+        static void release_one(basic_mfpkg::node_regions::region* __r, void*,
+                                std::size_t, std::size_t) noexcept
+        {
+            static_cast<node_block*>(__r)->drop(1);
+        }
+    };
+
 public:
 
     template <typename _Tp>
     struct iterator
     {
         typedef iterator<_Tp> _Self;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
         typedef _Tp& reference;
         typedef _Tp* pointer;
 
@@ -57,20 +246,14 @@ public:
 
         _Self& operator++() noexcept
         {
-            if(_M_node)
-            {
-                _M_node = _M_node->link;
-            }
+            _M_node = _M_node->link;
             return *this;
         }
 
         _Self operator++(int) noexcept
         {
             _Self __tmp(*this);
-            if(_M_node)
-            {
-                _M_node = _M_node->link;
-            }
+            _M_node = _M_node->link;
             return __tmp;
         }
 
@@ -128,6 +311,9 @@ public:
     {
         typedef const_iterator<_Tp> _Self;
         typedef iterator<_Tp> Iterator;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
         typedef const _Tp& reference;
         typedef const _Tp* pointer;
 
@@ -157,20 +343,14 @@ public:
 
         _Self& operator++() noexcept
         {
-            if(_M_node)
-            {
-                _M_node = _M_node->link;
-            }
+            _M_node = _M_node->link;
             return *this;
         }
 
         _Self operator++(int) noexcept
         {
             _Self __tmp(*this);
-            if(_M_node)
-            {
-                _M_node = _M_node->link;
-            }
+            _M_node = _M_node->link;
             return __tmp;
         }
 
@@ -223,21 +403,161 @@ public:
         }
     };
 
+    /**
+     * Owns a single node taken out of a %list, together with its element.
+     * The node can be kept, handed to another thread and linked into any
+     * mfpkg::forward_list or mfpkg::indexed_forward_list of the same
+     * element type without allocating or copying.  An empty handle owns nothing; a non-empty one destroys its
+     * node when it goes out of scope.
+     */
+    template <typename _Tp>
+    class node_handle
+    {
+        typedef node_handle<_Tp> _Self;
+
+        node_base* _M_node;
+
+        template <typename, typename> friend class mfpkg::forward_list;
+        template <typename, typename, typename> friend class mfpkg::indexed_forward_list;
+
+        explicit node_handle(node_base* __n) noexcept : _M_node(__n) {}
+
+        node_base* release(void) noexcept
+        {
+            node_base* __n = _M_node;
+            _M_node = nullptr;
+            return __n;
+        }
+
+        public:
+
+        typedef _Tp value_type;
+
+        node_handle() noexcept : _M_node(nullptr) {}
+
+        node_handle(_Self&& __nh) noexcept : _M_node(__nh.release()) {}
+
+        node_handle(const _Self&) = delete;
+
+        ~node_handle()
+        {
+            if(_M_node)
+            {
+                delete_node<_Tp>(_M_node);
+            }
+        }
+
+        _Self& operator=(_Self&& __nh) noexcept
+        {
+            if(this != &__nh)
+            {
+                _Self __old(release());
+                _M_node = __nh.release();
+            }
+            return *this;
+        }
+
+        _Self& operator=(const _Self&) = delete;
+
+        bool empty(void) const noexcept
+        {
+            return _M_node == nullptr;
+        }
+
+        explicit operator bool(void) const noexcept
+        {
+            return _M_node != nullptr;
+        }
+
+        /**
+         * Returns the element of a non-empty handle.
+         */
+        value_type& value(void) const noexcept
+        {
+            return static_cast<node<_Tp>*>(_M_node)->storage;
+        }
+
+        void swap(_Self& __nh) noexcept
+        {
+            std::swap(_M_node, __nh._M_node);
+        }
+    };
+
 protected:
 
-    template <typename _Tp>
-    class forward_list
+    /**
+     * Optional parts of a basic %list header.  Without them the header
+     * is the start link alone; rbegin() and size() then walk the %list.
+     */
+    struct tail_link
+    {
+        node_base finish;
+    };
+
+    struct no_tail_link { };
+
+    struct size_count
+    {
+        std::size_t count;
+    };
+
+    struct no_size_count { };
+
+    template <typename _Tp, bool _Tail = true, bool _Size = true>
+    class forward_list : private std::conditional_t<_Tail, tail_link, no_tail_link>,
+                         private std::conditional_t<_Size, size_count, no_size_count>
     {
         private:
-        typedef forward_list<_Tp> _Self;
+        typedef forward_list<_Tp, _Tail, _Size> _Self;
         
         node_base start;
-        node_base finish;
-        std::size_t count;
+
+        void set_last(node_base* __node) noexcept
+        {
+            if constexpr (_Tail)
+            {
+                this->finish.link = __node;
+            }
+        }
+
+        void set_count(std::size_t __n) noexcept
+        {
+            if constexpr (_Size)
+            {
+                this->count = __n;
+            }
+        }
+
+        void added(std::size_t __n) noexcept
+        {
+            if constexpr (_Size)
+            {
+                this->count += __n;
+            }
+        }
+
+        void removed(std::size_t __n) noexcept
+        {
+            if constexpr (_Size)
+            {
+                this->count -= __n;
+            }
+        }
 
         node<_Tp>* get_node(const _Tp& __val)
         {
-            node<_Tp>* __node = new (std::nothrow) node<_Tp>({nullptr, __val});
+            node<_Tp>* __node = new_node<_Tp>(__val);
+            if(!__node)
+            {
+                clear();
+                exit(__PRETTY_FUNCTION__);
+            }
+            return __node;
+        }
+
+        node<_Tp>* get_node(_Tp&& __val)
+        {
+            node<_Tp>* __node = new_node<_Tp>(std::move(__val));
             if(!__node)
             {
                 clear();
@@ -246,11 +566,16 @@ protected:
             return __node;
         }
 
+        void put_node(node_base* __node) noexcept
+        {
+            delete_node<_Tp>(__node);
+        }
+
         void init_list(node_base* __node) noexcept
         {
             __node->link = nullptr;
             start.link = __node;
-            finish.link = __node;
+            set_last(__node);
         }
         
         void insert_before_begin(node_base* __node) noexcept
@@ -264,7 +589,7 @@ protected:
             __node->link = __pos->link;
             if(__node->link == nullptr)
             {
-                finish.link = __node;
+                set_last(__node);
             }
             __pos->link = __node;
         }
@@ -275,16 +600,16 @@ protected:
             start.link = start.link->link;
             if(!start.link)
             {
-                finish.link = start.link;
+                set_last(nullptr);
             }
-            delete __temp;
+            put_node(__temp);
             return start.link;
         }
 
         void erase_last_element(node_base* __pos) noexcept
         {
-            delete finish.link;
-            finish.link = __pos;
+            put_node(__pos->link);
+            set_last(__pos);
             __pos->link = nullptr;
         }
 
@@ -292,7 +617,7 @@ protected:
         {
             node_base* __temp = __pos->link;
             __pos->link = __pos->link->link;
-            delete __temp;
+            put_node(__temp);
             return __pos;
         }
 
@@ -312,13 +637,13 @@ protected:
                 __list.start.link = __list.start.link->link;
                 if(__list.start.link == __list.end())
                 {
-                    __list.finish.link = __list.start.link;
+                    __list.set_last(nullptr);
                 }
             }
-            else if(__i->link == __list.rbegin())
+            else if(!__i->link->link)
             {
-                __list.finish.link = __i;
-                __list.finish.link->link = nullptr;
+                __list.set_last(__i);
+                __i->link = nullptr;
             }
             else
             {
@@ -327,7 +652,7 @@ protected:
                     __i->link = __i->link->link;
                 }
             }
-            --__list.count;
+            __list.removed(1);
             return __node;
         }
 
@@ -349,20 +674,20 @@ protected:
             {
                 insert_after(__pos, __node);
             }
-            ++count;
+            added(1);
         }
 
         void truncate(node_base* __curr, node_base* __prev) noexcept
         {
             node_base* __temp = nullptr;
-            for (; __curr != nullptr; --count)
+            for (; __curr != nullptr; removed(1))
             {
                 __temp = __curr;
                 __curr = __curr->link;
-                delete __temp;
+                put_node(__temp);
             }
-            finish.link = __prev;
-            finish.link->link = nullptr;
+            set_last(__prev);
+            __prev->link = nullptr;
         }
 
         void shrink_list(std::size_t __n) noexcept
@@ -383,17 +708,21 @@ protected:
 
         void extend_list(std::size_t __n)
         {
-            node<_Tp>* __node = nullptr;
-            if(empty())
+            std::size_t __size = size();
+            node_base* __last = rbegin();
+            if(!__last)
             {
-                __node = get_node({});
-                init_list(__node);
-                ++count;
+                __last = get_node({});
+                init_list(__last);
+                added(1);
+                ++__size;
             }
-            for (; count < __n; ++count)
+            for (; __size < __n; ++__size)
             {
-                __node = get_node({});
-                insert_after(rbegin(), __node);
+                node_base* __node = get_node({});
+                insert_after(__last, __node);
+                __last = __node;
+                added(1);
             }
         }
 
@@ -404,18 +733,30 @@ protected:
             __p2 = __tmp;
         }
 
-        void swap(std::size_t& __c) noexcept
+        void free_chains(std::vector<node_base>& __heads) noexcept
+        {
+            for (auto& __head : __heads)
+            {
+                for (node_base* __it = __head.link; __it; )
+                {
+                    node_base* __temp = __it;
+                    __it = __it->link;
+                    put_node(__temp);
+                }
+            }
+        }
+
+        static std::size_t parallel_pieces(std::size_t __n, std::size_t __threads) noexcept
         {
-            auto __tmp = __c;
-            __c = count;
-            count = __tmp;
+            std::size_t __t = __threads ? __threads : basic_mfpkg::task_pool::instance().capacity();
+            return std::min(__t, __n / 4096);
         }
 
         void reset(void) noexcept
         {
             start.link = nullptr;
-            finish.link = nullptr;
-            count = 0;
+            set_last(nullptr);
+            set_count(0);
         }
 
         void exit(const char* __msg) noexcept
@@ -426,10 +767,23 @@ protected:
 
         public:
 
-        explicit forward_list() : start({nullptr}), finish({nullptr}), count(0) {}
+        struct no_steps
+        {
+            void operator()(void) const noexcept { }
+        };
+
+        explicit forward_list() : start({nullptr})
+        {
+            set_last(nullptr);
+            set_count(0);
+        }
 
         explicit forward_list(node_base* __s, node_base* __f, std::size_t __c) 
-        : start({__s}), finish({__f}), count(__c) {}
+        : start({__s})
+        {
+            set_last(__f);
+            set_count(__c);
+        }
         
         ~forward_list() noexcept
         {
@@ -480,7 +834,7 @@ protected:
             return &start;
         }
 
-        node_base* before_begin(void) const noexcept
+        const node_base* before_begin(void) const noexcept
         {
             return &start;
         }
@@ -497,12 +851,27 @@ protected:
 
         node_base* rbegin(void) noexcept
         {
-            return finish.link;
+            return static_cast<const _Self*>(this)->rbegin();
         }
 
+        /**
+         * Walks the %list when there is no tail link.
+         */
         node_base* rbegin(void) const noexcept
         {
-            return finish.link;
+            if constexpr (_Tail)
+            {
+                return this->finish.link;
+            }
+            else
+            {
+                node_base* __last = start.link;
+                while (__last && __last->link)
+                {
+                    __last = __last->link;
+                }
+                return __last;
+            }
         }
 
         node_base* end(void) noexcept
@@ -517,7 +886,19 @@ protected:
 
         node_base* insert_after(node_base* __pos, const _Tp& __val)
         {
-            node<_Tp>* __node = get_node(__val);
+            return link_after(__pos, get_node(__val));
+        }
+
+        node_base* insert_after(node_base* __pos, _Tp&& __val)
+        {
+            return link_after(__pos, get_node(std::move(__val)));
+        }
+
+        /**
+         * Links the detached @a __node after @a __pos and returns it.
+         */
+        node_base* link_after(node_base* __pos, node_base* __node) noexcept
+        {
             if(empty())
             {
                 init_list(__node);
@@ -533,16 +914,88 @@ protected:
                     insert_after(__pos, __node);
                 }
             }
-            ++count;
+            added(1);
+            return __node;
+        }
+
+        /**
+         * Links the detached chain from @a __first to @a __last, holding
+         * @a __n nodes, after @a __pos.
+         */
+        void link_chain(node_base* __pos, node_base* __first, node_base* __last, std::size_t __n) noexcept
+        {
+            if(empty())
+            {
+                __pos = &start;
+            }
+            __last->link = __pos->link;
+            __pos->link = __first;
+            if(!__last->link)
+            {
+                set_last(__last);
+            }
+            added(__n);
+        }
+
+        /**
+         * Unlinks the node after @a __pos without destroying it.  Returns
+         * nullptr if @a __pos is the last node.
+         */
+        node_base* unlink_after(node_base* __pos) noexcept
+        {
+            node_base* __node = __pos->link;
+            if(!__node)
+            {
+                return nullptr;
+            }
+            __pos->link = __node->link;
+            if(!__pos->link)
+            {
+                set_last(__pos == before_begin() ? nullptr : __pos);
+            }
+            __node->link = nullptr;
+            removed(1);
             return __node;
         }
 
+        template <typename _InputIt>
+        node_base* insert_after(node_base* __pos, _InputIt __first, _InputIt __last)
+        {
+            node_base __head({nullptr});
+            node_base* __tail = &__head;
+            std::size_t __n = 0;
+            try
+            {
+                for (; __first != __last; ++__first, ++__n)
+                {
+                    __tail->link = get_node(*__first);
+                    __tail = __tail->link;
+                }
+            }
+            catch (...)
+            {
+                for (node_base* __it = __head.link; __it; )
+                {
+                    node_base* __temp = __it;
+                    __it = __it->link;
+                    put_node(__temp);
+                }
+                throw;
+            }
+            if(!__n)
+            {
+                return __pos;
+            }
+            link_chain(__pos, __head.link, __tail, __n);
+            return __tail;
+        }
+
         void pop_front(void) noexcept
         {
             if(!empty())
             {
                 erase_first_element();
-                --count;
+                removed(1);
             }
         }
 
@@ -557,16 +1010,15 @@ protected:
             {
                 __ret = erase_first_element();
             }
-            else if(__pos->link == rbegin())
+            else if(!__pos->link->link)
             {
                 erase_last_element(__pos);
             }
-            else if(__pos->link->link)
+            else
             {
                 __ret = erase_next_element(__pos);
             }
-            else { }
-            --count;
+            removed(1);
             return __ret;
         }
 
@@ -600,31 +1052,11 @@ protected:
 
         void splice_after(node_base* __pos, _Self& __list) noexcept
         {
-            if(!__pos)
+            if(!__pos || __list.empty())
             {
                 return;
             }
-            if(empty())
-            {
-                start.link = __list.start.link;
-                finish.link = __list.finish.link;
-            }
-            else if(__pos == before_begin())
-            {
-                __list.finish.link->link = start.link;
-                start.link = __list.start.link;
-            }
-            else if(__pos == rbegin())
-            {
-                finish.link->link = __list.start.link;
-                finish.link = __list.finish.link;
-            }
-            else
-            {
-                __list.finish.link->link = __pos->link;
-                __pos->link = __list.start.link;
-            }
-            count += __list.count;
+            link_chain(__pos, __list.start.link, __list.rbegin(), _Size ? __list.size() : 0);
             __list.reset();
         }
 
@@ -649,22 +1081,12 @@ protected:
             __before->link = __last;
             if(__before->link == nullptr)
             {
-                if(__before == __list.before_begin())
-                {
-                    __list.start.link = __before->link;
-                    __list.finish.link = __before->link;
-                }
-                else
-                {
-                    __list.finish.link = __before;
-                }
+                __list.set_last(__before == __list.before_begin() ? nullptr : __before);
             }
             std::size_t __i = 0;
             for (; __it->link != __end; __it = __it->link, ++__i);
-            __it->link = nullptr;
-            __list.count -= __i+1;
-            _Self __temp(__start, __it, 1+__i);
-            splice_after(__pos, __temp);
+            __list.removed(__i+1);
+            link_chain(__pos, __start, __it, 1+__i);
         }
 
         bool empty(void) noexcept
@@ -679,19 +1101,39 @@ protected:
 
         std::size_t size(void) noexcept
         {
-            return count;
+            return static_cast<const _Self*>(this)->size();
         }
 
+        /**
+         * Counts the elements when there is no size counter.
+         */
         std::size_t size(void) const noexcept
         {
-            return count;
+            if constexpr (_Size)
+            {
+                return this->count;
+            }
+            else
+            {
+                std::size_t __n = 0;
+                for (const node_base* __it = start.link; __it; __it = __it->link)
+                {
+                    ++__n;
+                }
+                return __n;
+            }
         }
 
         /**
          * I don't own the sort algorithm, You can check it via this link
          * https://www.geeksforgeeks.org/iterative-merge-sort-for-linked-list/
+         *
+         * @a __steps is called once for every link followed: the walks
+         * to the end of each run, the hops to the next run and past the
+         * second one, and every step of a merge.
          */
-        void sort(void) noexcept
+        template <typename _Steps = no_steps>
+        void sort(_Steps __steps = _Steps()) noexcept
         {
             if (!start.link || !start.link->link)
             {
@@ -715,7 +1157,8 @@ protected:
             std::size_t counter = 0;
             int isFirstIter = 0;
 
-            for (std::size_t gap = 1; gap < count; gap = gap * 2) 
+            const std::size_t __size = size();
+            for (std::size_t gap = 1; gap < __size; gap = gap * 2) 
             {
                 start1 = *head;
                 for (; start1;) 
@@ -734,10 +1177,12 @@ protected:
                     for (; --counter && end1->link;)
                     {
                         end1 = end1->link;
+                        __steps();
                     }
         
                     /* Second part for merging */
                     start2 = end1->link;
+                    __steps();
                     if (!start2)
                     {
                         break;
@@ -748,10 +1193,12 @@ protected:
                     for (; --counter && end2->link;)
                     {
                         end2 = end2->link;
+                        __steps();
                     }
         
                     /* To store for next iteration. */
                     Temp = end2->link;
+                    __steps();
 
                     /* begin merge */
 
@@ -780,8 +1227,10 @@ protected:
                             bstart->link = astart->link;
                             astart->link = bstart;
                             bstart = temp;
+                            __steps();
                         }
                         astart = astart->link; 
+                        __steps();
                     }
 
                     if(astart == aend)
@@ -810,29 +1259,204 @@ protected:
                 }
                 prevend->link = start1;
             }
-            finish.link = end2;
+            set_last(end2);
+        }
+
+        /**
+         * Copies the elements of up to simd_kernels::block nodes, starting
+         * at @a __from, into @a __values and sets @a __n to their number.
+         * Returns the last node copied.
+         */
+        template <typename _Node>
+        static _Node* gather(_Node* __from, _Tp* __values, std::size_t& __n) noexcept
+        {
+            _Node* __last = __from;
+            for (__n = 0; __from && __n < simd_kernels::block; __from = __from->link)
+            {
+                __values[__n++] = static_cast<const node<_Tp>*>(__from)->storage;
+                __last = __from;
+            }
+            return __last;
+        }
+
+        std::size_t count_equal(const _Tp& __val) const noexcept
+        {
+            std::size_t __r = 0;
+            if constexpr (simd_kernels::compares<_Tp>)
+            {
+                _Tp __values[simd_kernels::block];
+                for (const node_base* __it = start.link; __it; )
+                {
+                    std::size_t __n;
+                    __it = gather(__it, __values, __n)->link;
+                    __r += std::size_t(__builtin_popcountll(simd_kernels::equal_mask(__values, __n, __val)));
+                }
+            }
+            else
+            {
+                for (const node_base* __it = start.link; __it; __it = __it->link)
+                {
+                    __r += __val == static_cast<const node<_Tp>*>(__it)->storage;
+                }
+            }
+            return __r;
+        }
+
+        const node_base* find_equal(const _Tp& __val) const noexcept
+        {
+            if constexpr (simd_kernels::compares<_Tp>)
+            {
+                _Tp __values[simd_kernels::block];
+                for (const node_base* __it = start.link; __it; )
+                {
+                    std::size_t __n;
+                    const node_base* __next = gather(__it, __values, __n)->link;
+                    if(std::uint64_t __m = simd_kernels::equal_mask(__values, __n, __val))
+                    {
+                        for (int __k = __builtin_ctzll(__m); __k; --__k)
+                        {
+                            __it = __it->link;
+                        }
+                        return __it;
+                    }
+                    __it = __next;
+                }
+            }
+            else
+            {
+                for (const node_base* __it = start.link; __it; __it = __it->link)
+                {
+                    if(__val == static_cast<const node<_Tp>*>(__it)->storage)
+                    {
+                        return __it;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        node_base* find_equal(const _Tp& __val) noexcept
+        {
+            return const_cast<node_base*>(static_cast<const _Self*>(this)->find_equal(__val));
+        }
+
+        /**
+         * Folds the elements of a non-empty %list with @a __fold, a block
+         * at a time through @a __block when _Tp has reduction kernels.
+         */
+        template <typename _Block, typename _Fold>
+        _Tp fold(_Block __block, _Fold __fold) const
+        {
+            if constexpr (simd_kernels::reduces<_Tp>)
+            {
+                _Tp __values[simd_kernels::block];
+                std::size_t __n;
+                const node_base* __it = gather(start.link, __values, __n)->link;
+                _Tp __r = __block(__values, __n);
+                while (__it)
+                {
+                    __it = gather(__it, __values, __n)->link;
+                    __r = __fold(__r, __block(__values, __n));
+                }
+                return __r;
+            }
+            else
+            {
+                _Tp __r = static_cast<const node<_Tp>*>(start.link)->storage;
+                for (const node_base* __it = start.link->link; __it; __it = __it->link)
+                {
+                    __r = __fold(__r, static_cast<const node<_Tp>*>(__it)->storage);
+                }
+                return __r;
+            }
+        }
+
+        _Tp sum(void) const
+        {
+            if(empty())
+            {
+                return _Tp();
+            }
+            return fold([](const _Tp* __p, std::size_t __n) { return simd_kernels::sum(__p, __n); },
+                        [](const _Tp& __a, const _Tp& __b) { return __a + __b; });
+        }
+
+        _Tp min(void) const
+        {
+            return fold([](const _Tp* __p, std::size_t __n) { return simd_kernels::min(__p, __n); },
+                        [](const _Tp& __a, const _Tp& __b) { return __b < __a ? __b : __a; });
+        }
+
+        _Tp max(void) const
+        {
+            return fold([](const _Tp* __p, std::size_t __n) { return simd_kernels::max(__p, __n); },
+                        [](const _Tp& __a, const _Tp& __b) { return __a < __b ? __b : __a; });
         }
 
         void remove(const _Tp& __val) noexcept
         {
-            if(!empty())
+            if constexpr (simd_kernels::compares<_Tp>)
             {
-                for (auto __it = begin(); __it && __it->link != nullptr; )
+                remove_equal(__val);
+            }
+            else
+            {
+                if(!empty())
                 {
-                    if(__val == static_cast<node<_Tp>*>(__it->link)->storage)
+                    for (auto __it = begin(); __it && __it->link != nullptr; )
                     {
-                        __it = erase_after(__it);
+                        if(__val == static_cast<node<_Tp>*>(__it->link)->storage)
+                        {
+                            __it = erase_after(__it);
+                        }
+                        else
+                        {
+                            __it = __it->link;
+                        }
                     }
-                    else
+                    if(__val == static_cast<node<_Tp>*>(start.link)->storage)
                     {
-                        __it = __it->link;
+                        pop_front();
                     }
                 }
-                if(__val == static_cast<node<_Tp>*>(start.link)->storage)
+            }
+        }
+
+        /**
+         * remove() for element types with an equal_mask() kernel.  A block
+         * without a match is passed over after one vector compare.
+         */
+        void remove_equal(const _Tp& __val) noexcept
+        {
+            _Tp __values[simd_kernels::block];
+            node_base* __prev = &start;
+            while (node_base* __it = __prev->link)
+            {
+                std::size_t __n;
+                node_base* __last = gather(__it, __values, __n);
+                std::uint64_t __m = simd_kernels::equal_mask(__values, __n, __val);
+                if(!__m)
+                {
+                    __prev = __last;
+                    continue;
+                }
+                for (std::size_t __k = 0; __k < __n; ++__k)
                 {
-                    pop_front();
+                    node_base* __next = __it->link;
+                    if(__m >> __k & 1)
+                    {
+                        __prev->link = __next;
+                        put_node(__it);
+                        removed(1);
+                    }
+                    else
+                    {
+                        __prev = __it;
+                    }
+                    __it = __next;
                 }
             }
+            set_last(__prev == &start ? nullptr : __prev);
         }
 
         void remove_if(bool (*__pred)(const _Tp& __val)) noexcept
@@ -877,6 +1501,225 @@ protected:
             }
         }
 
+        /**
+         * Removes every element equal to an earlier one in a single pass,
+         * looking each up in an open addressing table of the elements kept
+         * so far.  Small trivially copyable elements are held in the table
+         * itself, others are reached through their node.  The removed nodes
+         * are chained aside and released together at the end.
+         */
+        template <typename _Hash, typename _Equal>
+        void unique_all(_Hash& __hash, _Equal& __eq)
+        {
+            if(!start.link || !start.link->link)
+            {
+                return;
+            }
+
+            constexpr bool __by_value = std::is_trivially_copyable<_Tp>::value
+                                        && std::is_default_constructible<_Tp>::value
+                                        && sizeof(_Tp) <= sizeof(void*);
+            typedef std::conditional_t<__by_value, _Tp, const node<_Tp>*> _Key;
+
+            struct slot
+            {
+                std::size_t tag;
+                _Key key;
+            };
+
+            unsigned __bits = 4;
+            const std::size_t __size = size();
+            while ((std::size_t(1) << __bits) < 2 * __size)
+            {
+                ++__bits;
+            }
+            const std::size_t __mask = (std::size_t(1) << __bits) - 1;
+            std::vector<slot> __table(__mask + 1);
+
+            node_base __removed({nullptr});
+            node_base* __tail = &__removed;
+            node_base* __prev = &start;
+            try
+            {
+                for (node_base* __it = start.link; __it; __it = __prev->link)
+                {
+                    const _Tp& __val = static_cast<node<_Tp>*>(__it)->storage;
+                    const std::size_t __h = std::size_t(__hash(__val));
+                    /* Zero marks a free slot. */
+                    const std::size_t __tag = __h | 1;
+                    std::size_t __i = std::size_t((std::uint64_t(__h) * 0x9E3779B97F4A7C15ull) >> (64 - __bits));
+                    bool __seen = false;
+                    for (;; __i = (__i + 1) & __mask)
+                    {
+                        slot& __s = __table[__i];
+                        if(!__s.tag)
+                        {
+                            __s.tag = __tag;
+                            if constexpr (__by_value)
+                            {
+                                __s.key = __val;
+                            }
+                            else
+                            {
+                                __s.key = static_cast<const node<_Tp>*>(__it);
+                            }
+                            break;
+                        }
+                        if(__s.tag == __tag)
+                        {
+                            if constexpr (__by_value)
+                            {
+                                __seen = __eq(__s.key, __val);
+                            }
+                            else
+                            {
+                                __seen = __eq(__s.key->storage, __val);
+                            }
+                            if(__seen)
+                            {
+                                break;
+                            }
+                        }
+                    }
+                    if(__seen)
+                    {
+                        __prev->link = __it->link;
+                        __tail->link = __it;
+                        __tail = __it;
+                        removed(1);
+                    }
+                    else
+                    {
+                        __prev = __it;
+                    }
+                }
+            }
+            catch (...)
+            {
+                __tail->link = nullptr;
+                release_chain(__removed.link);
+                throw;
+            }
+            set_last(__prev);
+            __tail->link = nullptr;
+            release_chain(__removed.link);
+        }
+
+        void release_chain(node_base* __it) noexcept
+        {
+            while (__it)
+            {
+                node_base* __next = __it->link;
+                put_node(__it);
+                __it = __next;
+            }
+        }
+
+        /**
+         * Moves the elements satisfying @a __pred, in order, to the empty
+         * %list @a __out in one pass.  If @a __pred throws, the elements
+         * classified so far stay where they were put and both lists
+         * remain valid.
+         */
+        template <typename _Predicate>
+        void partition(_Predicate& __pred, _Self& __out)
+        {
+            node_base* __prev = &start;
+            node_base* __tail = &__out.start;
+            std::size_t __moved = 0;
+            auto __close = [&]
+            {
+                __tail->link = nullptr;
+                __out.set_last(__moved ? __tail : nullptr);
+                __out.set_count(__moved);
+                removed(__moved);
+                if(!__prev->link)
+                {
+                    set_last(__prev == &start ? nullptr : __prev);
+                }
+            };
+            try
+            {
+                for (node_base* __it = start.link; __it; __it = __prev->link)
+                {
+                    if(__pred(static_cast<node<_Tp>*>(__it)->storage))
+                    {
+                        __prev->link = __it->link;
+                        __tail->link = __it;
+                        __tail = __it;
+                        ++__moved;
+                    }
+                    else
+                    {
+                        __prev = __it;
+                    }
+                }
+            }
+            catch (...)
+            {
+                __close();
+                throw;
+            }
+            __close();
+        }
+
+        /**
+         * Moves the elements after @a __pos, which is before_begin() or a
+         * node of this %list followed by @a __n elements, to the empty
+         * %list @a __out.
+         */
+        void split_after(node_base* __pos, std::size_t __n, _Self& __out) noexcept
+        {
+            if(!__n)
+            {
+                return;
+            }
+            __out.start.link = __pos->link;
+            __out.set_last(_Tail ? rbegin() : nullptr);
+            __out.set_count(__n);
+            __pos->link = nullptr;
+            set_last(__pos == &start ? nullptr : __pos);
+            removed(__n);
+        }
+
+        /**
+         * Keeps the first @a __n elements and moves the rest to the empty
+         * %list @a __out.  Follows @a __n links.
+         */
+        void split_at(std::size_t __n, _Self& __out) noexcept
+        {
+            const std::size_t __size = size();
+            if(__n >= __size)
+            {
+                return;
+            }
+            node_base* __pos = &start;
+            for (std::size_t __k = 0; __k < __n; ++__k)
+            {
+                __pos = __pos->link;
+            }
+            split_after(__pos, __size - __n, __out);
+        }
+
+        /**
+         * Moves the elements after @a __pos to the empty %list @a __out.
+         * Follows the links up to @a __pos to count the elements kept.
+         */
+        void split_after(node_base* __pos, _Self& __out) noexcept
+        {
+            if(__pos == &start)
+            {
+                split_after(__pos, size(), __out);
+                return;
+            }
+            std::size_t __kept = 1;
+            for (const node_base* __it = start.link; __it != __pos; __it = __it->link)
+            {
+                ++__kept;
+            }
+            split_after(__pos, size() - __kept, __out);
+        }
+
         void reverse(void) noexcept
         {
             if(!start.link || !start.link->link)
@@ -895,7 +1738,7 @@ protected:
                 __current = __next;
             }
             start.link = __prev;
-            finish.link = __start;
+            set_last(__start);
         }
 
         void resize(std::size_t __n)
@@ -944,17 +1787,209 @@ protected:
                 {
                     __temp = __it;
                     __it = __it->link;
-                    delete __temp;
+                    put_node(__temp);
                 }
                 reset();
             }
         }
 
+        template <typename _RandomIt>
+        void append_parallel(_RandomIt __first, std::size_t __n, std::size_t __threads)
+        {
+            std::size_t __k = parallel_pieces(__n, __threads);
+            if(__k < 2)
+            {
+                node_base* __pos = empty() ? before_begin() : rbegin();
+                for (std::size_t __i = 0; __i < __n; ++__i)
+                {
+                    __pos = insert_after(__pos, __first[__i]);
+                }
+                return;
+            }
+            std::vector<node_base> __heads(__k, node_base({nullptr}));
+            std::vector<node_base*> __tails(__k, nullptr);
+            try
+            {
+                basic_mfpkg::task_pool::instance().run(__k, __threads, [&](std::size_t __s)
+                {
+                    node_base* __tail = &__heads[__s];
+                    for (std::size_t __i = __n * __s / __k; __i < __n * (__s + 1) / __k; ++__i)
+                    {
+                        __tail->link = new_node<_Tp>(__first[__i]);
+                        if(!__tail->link)
+                        {
+                            throw std::bad_alloc();
+                        }
+                        __tail = __tail->link;
+                    }
+                    __tails[__s] = __tail;
+                });
+            }
+            catch (const std::bad_alloc&)
+            {
+                free_chains(__heads);
+                clear();
+                exit(__PRETTY_FUNCTION__);
+            }
+            catch (...)
+            {
+                free_chains(__heads);
+                throw;
+            }
+            for (std::size_t __s = 1; __s < __k; ++__s)
+            {
+                __tails[__s - 1]->link = __heads[__s].link;
+            }
+            link_chain(empty() ? before_begin() : rbegin(), __heads[0].link, __tails[__k - 1], __n);
+        }
+
+        /**
+         * Appends @a __n nodes carved from a single node_block.  @a __read
+         * is called with the address of each element in order and fills
+         * it byte-wise, which is why _Tp must be trivially copyable.
+         */
+        template <typename _Read>
+        void append_block(std::size_t __n, _Read&& __read)
+        {
+            static_assert(std::is_trivially_copyable<_Tp>::value,
+                          "append_block requires a trivially copyable type");
+            if(!__n)
+            {
+                return;
+            }
+            node_block<_Tp>* __block = node_block<_Tp>::create(__n);
+            if(!__block)
+            {
+                clear();
+                exit(__PRETTY_FUNCTION__);
+            }
+            node<_Tp>* __nodes = __block->nodes;
+            try
+            {
+                for (std::size_t __i = 0; __i < __n; ++__i)
+                {
+                    __read(static_cast<void*>(std::addressof(__nodes[__i].storage)));
+                }
+            }
+            catch (...)
+            {
+                __block->drop(__n);
+                throw;
+            }
+            for (std::size_t __i = 0; __i + 1 < __n; ++__i)
+            {
+                __nodes[__i].link = __nodes + __i + 1;
+            }
+            __nodes[__n - 1].link = nullptr;
+            link_chain(empty() ? before_begin() : rbegin(), __nodes, __nodes + __n - 1, __n);
+        }
+
+        void clear_parallel(std::size_t __threads)
+        {
+            const std::size_t __size = size();
+            std::size_t __k = parallel_pieces(__size, __threads);
+            if(__k < 2)
+            {
+                clear();
+                return;
+            }
+            std::vector<node_base*> __firsts(__k, nullptr);
+            node_base* __it = begin();
+            for (std::size_t __s = 0; __s < __k; ++__s)
+            {
+                __firsts[__s] = __it;
+                for (std::size_t __i = __size * (__s + 1) / __k - __size * __s / __k; __i > 1; --__i)
+                {
+                    __it = __it->link;
+                }
+                node_base* __next = __it->link;
+                __it->link = nullptr;
+                __it = __next;
+            }
+            reset();
+            basic_mfpkg::task_pool::instance().run(__k, __threads, [&](std::size_t __s)
+            {
+                for (node_base* __it = __firsts[__s]; __it; )
+                {
+                    node_base* __temp = __it;
+                    __it = __it->link;
+                    put_node(__temp);
+                }
+            });
+        }
+
+        bool defragment(void)
+        {
+            const std::size_t __size = size();
+            if(__size < 2)
+            {
+                return true;
+            }
+            node_block<_Tp>* __block = node_block<_Tp>::create(__size);
+            if(!__block)
+            {
+                return false;
+            }
+            std::size_t __i = 0;
+            node_base* __prev = &start;
+            try
+            {
+                for (node_base* __it = start.link; __it; ++__i)
+                {
+                    node<_Tp>* __old = static_cast<node<_Tp>*>(__it);
+                    node<_Tp>* __new = __block->nodes + __i;
+                    __it = __it->link;
+                    if constexpr (std::is_trivially_copyable<_Tp>::value)
+                    {
+                        std::memcpy(static_cast<void*>(__new), static_cast<const void*>(__old),
+                                    sizeof(node<_Tp>));
+                    }
+                    else
+                    {
+                        ::new (__new) node<_Tp>{{__it}, std::move_if_noexcept(__old->storage)};
+                    }
+                    __prev->link = __new;
+                    __prev = __new;
+                    put_node(__old);
+                }
+            }
+            catch (...)
+            {
+                __block->drop(__size - __i);
+                throw;
+            }
+            set_last(__prev);
+            return true;
+        }
+
+        double fragmentation(void) const noexcept
+        {
+            const std::size_t __size = size();
+            if(__size < 2)
+            {
+                return 0.0;
+            }
+            long double __total = 0;
+            for (const node_base* __it = start.link; __it->link; __it = __it->link)
+            {
+                const char* __a = reinterpret_cast<const char*>(__it);
+                const char* __b = reinterpret_cast<const char*>(__it->link);
+                __total += __a < __b ? __b - __a : __a - __b;
+            }
+            return static_cast<double>(__total / (__size - 1));
+        }
+
         void swap(_Self& __list) noexcept
         {
             swap(__list.start, this->start);
-            swap(__list.finish, this->finish);
-            swap(__list.count);
+            if constexpr (_Tail)
+            {
+                swap(__list.finish, this->finish);
+            }
+            if constexpr (_Size)
+            {
+                std::swap(__list.count, this->count);
+            }
         }
         
     };
@@ -0,0 +1,938 @@
+/**
+ *  @brief A singly linked %list whose links are 32-bit arena indices.
+ *
+ *  @tparam _Tp  Type of element.
+ *
+ *  On 64-bit targets a mfpkg::forward_list node spends eight bytes on its
+ *  link, which for small elements is as much as the element itself plus
+ *  padding.  A %compact_forward_list keeps its nodes in a compact_arena
+ *  and links them with 32-bit indices, so a node of an int is eight bytes
+ *  instead of sixteen.
+ *
+ *  The arena grows in chunks that double up to 4096 slots and are never
+ *  moved, so a short %list stays small and element references stay valid
+ *  while the arena grows.  A default-constructed or moved-from %list
+ *  holds no arena until an element is inserted.  Several lists may share one arena, in which
+ *  case splicing between them is done in constant time exactly like
+ *  mfpkg::forward_list; splicing between lists in different arenas
+ *  moves the elements instead.
+ *
+ *  @file compact_forward_list.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef COMPACT_FORWARD_LIST_H
+#define COMPACT_FORWARD_LIST_H
+
+/**
+ *  Growable node storage for compact_forward_list.  Slots are addressed by
+ *  32-bit indices, index zero being the null link, and released slots are
+ *  kept on a free list threaded through their links.
+ *
+ *  The first 4096 slots are spread over chunks of 16, 16, 32, ... 2048
+ *  slots, and every later chunk holds 4096.
+ *
+ *  An arena must outlive every list that uses it.
+ */
+template <typename _Tp>
+class mfpkg::compact_arena
+{
+public:
+
+    typedef std::uint32_t index_type;
+
+private:
+
+    struct slot
+    {
+        index_type link;
+        alignas(_Tp) unsigned char storage[sizeof(_Tp)];
+    };
+
+    static constexpr unsigned first_shift = 4;
+    static constexpr unsigned chunk_shift = 12;
+    static constexpr index_type chunk_size = index_type(1) << chunk_shift;
+    static constexpr index_type chunk_mask = chunk_size - 1;
+    static constexpr std::size_t small_chunks = chunk_shift - first_shift + 1;
+
+    std::vector<slot*> chunks;
+    index_type fresh;
+    index_type free_head;
+    std::size_t live;
+
+    /**
+     * Returns the chunk holding slot @a __i.
+     */
+    static std::size_t chunk_of(index_type __i) noexcept
+    {
+        if(__i >= chunk_size)
+        {
+            return (__i >> chunk_shift) + small_chunks - 1;
+        }
+        return __i >> first_shift ? unsigned(31 - __builtin_clz(__i)) + 1 - first_shift : 0;
+    }
+
+    /**
+     * Returns the index of the first slot of chunk @a __c.
+     */
+    static std::size_t chunk_first(std::size_t __c) noexcept
+    {
+        if(__c >= small_chunks)
+        {
+            return (__c - small_chunks + 1) << chunk_shift;
+        }
+        return __c ? std::size_t(1) << (__c + first_shift - 1) : 0;
+    }
+
+    slot& at(index_type __i) noexcept
+    {
+        if(__i >= chunk_size)
+        {
+            return chunks[(__i >> chunk_shift) + small_chunks - 1][__i & chunk_mask];
+        }
+        std::size_t __c = chunk_of(__i);
+        return chunks[__c][__i - chunk_first(__c)];
+    }
+
+    const slot& at(index_type __i) const noexcept
+    {
+        return const_cast<compact_arena*>(this)->at(__i);
+    }
+
+public:
+
+    compact_arena() noexcept : fresh(1), free_head(0), live(0) {}
+
+    compact_arena(const compact_arena&) = delete;
+
+    compact_arena& operator=(const compact_arena&) = delete;
+
+    /**
+     * Releases the chunks.  Elements still held by lists are not destroyed.
+     */
+    ~compact_arena() noexcept
+    {
+        for (slot* __c : chunks)
+        {
+            delete[] __c;
+        }
+    }
+
+    index_type& link(index_type __i) noexcept
+    {
+        return at(__i).link;
+    }
+
+    index_type link(index_type __i) const noexcept
+    {
+        return at(__i).link;
+    }
+
+    _Tp& value(index_type __i) noexcept
+    {
+        return *std::launder(reinterpret_cast<_Tp*>(at(__i).storage));
+    }
+
+    const _Tp& value(index_type __i) const noexcept
+    {
+        return *std::launder(reinterpret_cast<const _Tp*>(at(__i).storage));
+    }
+
+    /**
+     * @brief Takes a slot off the free list or from the unused tail of the arena.
+     * @return  The slot index, whose link is null, or zero when out of memory.
+     */
+    index_type allocate(void) noexcept
+    {
+        index_type __i = free_head;
+        if(__i)
+        {
+            free_head = at(__i).link;
+        }
+        else
+        {
+            if(fresh == 0)
+            {
+                return 0;
+            }
+            if(chunk_of(fresh) == chunks.size())
+            {
+                std::size_t __n = chunk_first(chunks.size() + 1) - chunk_first(chunks.size());
+                slot* __c = new (std::nothrow) slot[__n];
+                if(!__c)
+                {
+                    return 0;
+                }
+                try
+                {
+                    chunks.push_back(__c);
+                }
+                catch (...)
+                {
+                    delete[] __c;
+                    return 0;
+                }
+            }
+            __i = fresh++;
+        }
+        at(__i).link = 0;
+        ++live;
+        return __i;
+    }
+
+    /**
+     * @brief Returns slot @a __i to the free list.  Its element must already be destroyed.
+     */
+    void deallocate(index_type __i) noexcept
+    {
+        at(__i).link = free_head;
+        free_head = __i;
+        --live;
+    }
+
+    /**
+     * @brief Allocates a slot and constructs its element from @a __val.
+     * @return  The slot index, or zero when out of memory.
+     */
+    template <typename _Arg>
+    index_type create(_Arg&& __val)
+    {
+        index_type __i = allocate();
+        if(__i)
+        {
+            try
+            {
+                ::new (static_cast<void*>(at(__i).storage)) _Tp(std::forward<_Arg>(__val));
+            }
+            catch (...)
+            {
+                deallocate(__i);
+                throw;
+            }
+        }
+        return __i;
+    }
+
+    /**
+     * @brief Destroys the element in slot @a __i and releases the slot.
+     */
+    void destroy(index_type __i) noexcept
+    {
+        value(__i).~_Tp();
+        deallocate(__i);
+    }
+
+    /**
+     * @brief Returns the number of slots in use, list heads included.
+     */
+    std::size_t size(void) const noexcept
+    {
+        return live;
+    }
+
+    /**
+     * @brief Returns the number of bytes reserved by the arena.
+     */
+    std::size_t memory(void) const noexcept
+    {
+        return chunk_first(chunks.size()) * sizeof(slot) + chunks.capacity() * sizeof(slot*);
+    }
+};
+
+template <typename _Tp>
+class mfpkg::compact_forward_list
+{
+private:
+
+    typedef compact_forward_list<_Tp> _Self;
+    typedef compact_arena<_Tp> arena_type;
+    typedef typename arena_type::index_type index_type;
+
+    arena_type* arena;
+    index_type start;
+    index_type finish;
+    index_type count;
+    bool owner;
+
+public:
+
+    typedef _Tp value_type;
+    typedef _Tp& reference;
+    typedef const _Tp& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    struct iterator
+    {
+        typedef iterator _Self;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef _Tp& reference;
+        typedef _Tp* pointer;
+
+        arena_type* _M_arena;
+        index_type _M_node;
+
+        iterator() noexcept : _M_arena(nullptr), _M_node(0) {}
+
+        iterator(arena_type* __a, index_type __n) noexcept : _M_arena(__a), _M_node(__n) {}
+
+        reference operator*() const noexcept
+        {
+            return _M_arena->value(_M_node);
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &_M_arena->value(_M_node);
+        }
+
+        _Self& operator++() noexcept
+        {
+            _M_node = _M_arena->link(_M_node);
+            return *this;
+        }
+
+        _Self operator++(int) noexcept
+        {
+            _Self __tmp(*this);
+            _M_node = _M_arena->link(_M_node);
+            return __tmp;
+        }
+
+        _Self& operator+=(std::size_t __n) noexcept
+        {
+            for (; __n && _M_node; --__n)
+            {
+                _M_node = _M_arena->link(_M_node);
+            }
+            return *this;
+        }
+
+        friend bool operator==(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node == __y._M_node;
+        }
+
+        friend bool operator!=(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node != __y._M_node;
+        }
+
+        _Self next(void) const noexcept
+        {
+            return _Self(_M_arena, _M_node ? _M_arena->link(_M_node) : 0);
+        }
+    };
+
+    struct const_iterator
+    {
+        typedef const_iterator _Self;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const _Tp& reference;
+        typedef const _Tp* pointer;
+
+        const arena_type* _M_arena;
+        index_type _M_node;
+
+        const_iterator() noexcept : _M_arena(nullptr), _M_node(0) {}
+
+        const_iterator(const arena_type* __a, index_type __n) noexcept : _M_arena(__a), _M_node(__n) {}
+
+        const_iterator(const iterator& __it) noexcept : _M_arena(__it._M_arena), _M_node(__it._M_node) {}
+
+        reference operator*() const noexcept
+        {
+            return _M_arena->value(_M_node);
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &_M_arena->value(_M_node);
+        }
+
+        _Self& operator++() noexcept
+        {
+            _M_node = _M_arena->link(_M_node);
+            return *this;
+        }
+
+        _Self operator++(int) noexcept
+        {
+            _Self __tmp(*this);
+            _M_node = _M_arena->link(_M_node);
+            return __tmp;
+        }
+
+        _Self& operator+=(std::size_t __n) noexcept
+        {
+            for (; __n && _M_node; --__n)
+            {
+                _M_node = _M_arena->link(_M_node);
+            }
+            return *this;
+        }
+
+        friend bool operator==(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node == __y._M_node;
+        }
+
+        friend bool operator!=(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node != __y._M_node;
+        }
+
+        _Self next(void) const noexcept
+        {
+            return _Self(_M_arena, _M_node ? _M_arena->link(_M_node) : 0);
+        }
+    };
+
+private:
+
+    index_type& link(index_type __i) noexcept
+    {
+        return arena->link(__i);
+    }
+
+    index_type link(index_type __i) const noexcept
+    {
+        return static_cast<const arena_type*>(arena)->link(__i);
+    }
+
+    void exit(const char* __msg) noexcept
+    {
+        std::cerr << __msg << " : Out of memory" << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+
+    void init(void)
+    {
+        start = arena->allocate();
+        if(!start)
+        {
+            exit(__PRETTY_FUNCTION__);
+        }
+        finish = start;
+        count = 0;
+    }
+
+    /**
+     * Gives a list that holds no arena yet an arena and a head slot.
+     */
+    void attach(void) noexcept
+    {
+        if(!start)
+        {
+            arena = new (std::nothrow) arena_type;
+            if(!arena)
+            {
+                exit(__PRETTY_FUNCTION__);
+            }
+            init();
+        }
+    }
+
+    template <typename _Arg>
+    index_type get_node(_Arg&& __val)
+    {
+        index_type __node = arena->create(std::forward<_Arg>(__val));
+        if(!__node)
+        {
+            clear();
+            exit(__PRETTY_FUNCTION__);
+        }
+        return __node;
+    }
+
+    template <typename _Arg>
+    index_type link_after(index_type __pos, _Arg&& __val)
+    {
+        if(!__pos)
+        {
+            attach();
+            __pos = start;
+        }
+        index_type __node = get_node(std::forward<_Arg>(__val));
+        link(__node) = link(__pos);
+        link(__pos) = __node;
+        if(__pos == finish)
+        {
+            finish = __node;
+        }
+        ++count;
+        return __node;
+    }
+
+    index_type last_before(index_type __node) const noexcept
+    {
+        index_type __it = start;
+        for (; link(__it) != __node; __it = link(__it));
+        return __it;
+    }
+
+    void release(void) noexcept
+    {
+        if(start)
+        {
+            clear();
+            arena->deallocate(start);
+        }
+        if(owner)
+        {
+            delete arena;
+        }
+    }
+
+public:
+
+    /**
+     * @brief Creates an empty list.  Its arena is allocated on first insertion.
+     */
+    compact_forward_list() noexcept : arena(nullptr), start(0), finish(0), count(0), owner(true) {}
+
+    /**
+     * @brief Creates an empty list whose nodes live in @a __arena.
+     *
+     * Lists sharing an arena can splice nodes between each other in
+     * constant time.  @a __arena must outlive the list.
+     */
+    explicit compact_forward_list(arena_type& __arena) : arena(&__arena), owner(false)
+    {
+        init();
+    }
+
+    compact_forward_list(std::initializer_list<_Tp> __list) : compact_forward_list()
+    {
+        for (auto& __x : __list)
+        {
+            link_after(finish, __x);
+        }
+    }
+
+    /**
+     * Copies @a __list.  The copy shares the arena of @a __list when that
+     * arena was supplied by the user, and gets an arena of its own otherwise.
+     */
+    compact_forward_list(const _Self& __list)
+    : arena(__list.owner ? nullptr : __list.arena), start(0), finish(0), count(0), owner(__list.owner)
+    {
+        if(!owner)
+        {
+            init();
+        }
+        for (auto& __x : __list)
+        {
+            link_after(finish, __x);
+        }
+    }
+
+    /**
+     * Takes the nodes of @a __list.  A @a __list with an arena of its own
+     * is left without one until it is used again; one on a shared arena
+     * gets a fresh head slot there.
+     */
+    compact_forward_list(_Self&& __list) noexcept
+    : arena(__list.arena), start(__list.start), finish(__list.finish),
+      count(__list.count), owner(__list.owner)
+    {
+        if(owner)
+        {
+            __list.arena = nullptr;
+            __list.start = __list.finish = __list.count = 0;
+        }
+        else
+        {
+            __list.init();
+        }
+    }
+
+    ~compact_forward_list() noexcept
+    {
+        release();
+    }
+
+    _Self& operator=(std::initializer_list<_Tp> __list)
+    {
+        assign(__list);
+        return *this;
+    }
+
+    _Self& operator=(const _Self& __list)
+    {
+        if(this != &__list)
+        {
+            clear();
+            for (auto& __x : __list)
+            {
+                link_after(finish, __x);
+            }
+        }
+        return *this;
+    }
+
+    _Self& operator=(_Self&& __list) noexcept
+    {
+        swap(__list);
+        return *this;
+    }
+
+    /**
+     * @brief  Replaces the contents with copies of the elements of @a __list.
+     */
+    void assign(std::initializer_list<_Tp> __list)
+    {
+        clear();
+        for (auto& __x : __list)
+        {
+            link_after(finish, __x);
+        }
+    }
+
+    /**
+     * @brief  Returns the arena holding the nodes of this list.
+     */
+    arena_type& get_arena(void) noexcept
+    {
+        attach();
+        return *arena;
+    }
+
+    iterator before_begin(void) noexcept
+    {
+        attach();
+        return iterator(arena, start);
+    }
+
+    const_iterator before_begin(void) const noexcept
+    {
+        return const_iterator(arena, start);
+    }
+
+    iterator begin(void) noexcept
+    {
+        return iterator(arena, start ? link(start) : 0);
+    }
+
+    const_iterator begin(void) const noexcept
+    {
+        return const_iterator(arena, start ? link(start) : 0);
+    }
+
+    /**
+     * Returns an iterator to the last element, or before_begin() when empty.
+     */
+    iterator rbegin(void) noexcept
+    {
+        attach();
+        return iterator(arena, finish);
+    }
+
+    const_iterator rbegin(void) const noexcept
+    {
+        return const_iterator(arena, finish);
+    }
+
+    iterator end(void) noexcept
+    {
+        return iterator(arena, 0);
+    }
+
+    const_iterator end(void) const noexcept
+    {
+        return const_iterator(arena, 0);
+    }
+
+    reference front(void) noexcept
+    {
+        return *begin();
+    }
+
+    const_reference front(void) const noexcept
+    {
+        return *begin();
+    }
+
+    reference back(void) noexcept
+    {
+        return *rbegin();
+    }
+
+    const_reference back(void) const noexcept
+    {
+        return *rbegin();
+    }
+
+    void push_back(const _Tp& __val)
+    {
+        link_after(finish, __val);
+    }
+
+    void push_back(_Tp&& __val)
+    {
+        link_after(finish, std::move(__val));
+    }
+
+    void push_front(const _Tp& __val)
+    {
+        link_after(start, __val);
+    }
+
+    void push_front(_Tp&& __val)
+    {
+        link_after(start, std::move(__val));
+    }
+
+    void pop_front(void) noexcept
+    {
+        erase_after(iterator(arena, start));
+    }
+
+    /**
+     * @brief  Removes last element.  Linear in size().
+     */
+    void pop_back(void) noexcept
+    {
+        if(!empty())
+        {
+            erase_after(iterator(arena, last_before(finish)));
+        }
+    }
+
+    iterator insert_after(const iterator& __position, const _Tp& __val)
+    {
+        return iterator(arena, link_after(__position._M_node, __val));
+    }
+
+    iterator insert_after(const iterator& __position, _Tp&& __val)
+    {
+        return iterator(arena, link_after(__position._M_node, std::move(__val)));
+    }
+
+    iterator insert_after(const iterator& __position, std::initializer_list<_Tp> __list)
+    {
+        index_type __pos = __position._M_node;
+        for (auto& __x : __list)
+        {
+            __pos = link_after(__pos, __x);
+        }
+        return iterator(arena, __pos);
+    }
+
+    /**
+     * @brief Removes the element following @a __position.
+     * @return  An iterator to the element after the erased one, or end().
+     */
+    iterator erase_after(const iterator& __position) noexcept
+    {
+        index_type __pos = __position._M_node;
+        index_type __node = __pos ? link(__pos) : 0;
+        if(!__node)
+        {
+            return end();
+        }
+        link(__pos) = link(__node);
+        if(__node == finish)
+        {
+            finish = __pos;
+        }
+        arena->destroy(__node);
+        --count;
+        return iterator(arena, link(__pos));
+    }
+
+    /**
+     * @brief Removes the elements in the range (__before, __last).
+     */
+    iterator erase_after(const iterator& __before, const iterator& __last) noexcept
+    {
+        while (__before._M_node && link(__before._M_node) != __last._M_node)
+        {
+            erase_after(__before);
+        }
+        return __last;
+    }
+
+    /**
+     * @brief Moves the elements in (__before, __last) of @a __list after @a __position.
+     *
+     * Constant time plus the length of the range when both lists share an
+     * arena.  Otherwise the elements are moved into this list's arena.
+     */
+    void splice_after(const iterator& __position, _Self& __list,
+                      const iterator& __before, const iterator& __last)
+    {
+        index_type __b = __before._M_node;
+        index_type __l = __last._M_node;
+        if(!__b || __list.link(__b) == __l || (this == &__list && __position._M_node == __b))
+        {
+            return;
+        }
+        if(__list.arena != arena)
+        {
+            index_type __pos = __position._M_node;
+            for (index_type __it = __list.link(__b); __it != __l; __it = __list.link(__b))
+            {
+                __pos = link_after(__pos, std::move(__list.arena->value(__it)));
+                __list.erase_after(__before);
+            }
+            return;
+        }
+        index_type __first = link(__b);
+        index_type __tail = __first;
+        index_type __n = 1;
+        for (; link(__tail) != __l; __tail = link(__tail), ++__n);
+        link(__b) = __l;
+        if(__tail == __list.finish)
+        {
+            __list.finish = __b;
+        }
+        __list.count -= __n;
+        index_type __pos = __position._M_node;
+        link(__tail) = link(__pos);
+        link(__pos) = __first;
+        if(__pos == finish)
+        {
+            finish = __tail;
+        }
+        count += __n;
+    }
+
+    void splice_after(const iterator& __position, _Self& __list)
+    {
+        splice_after(__position, __list, iterator(__list.arena, __list.start), __list.end());
+    }
+
+    void splice_after(const iterator& __position, _Self& __list, const iterator& __i)
+    {
+        splice_after(__position, __list, __i, __i.next().next());
+    }
+
+    bool empty(void) const noexcept
+    {
+        return count == 0;
+    }
+
+    std::size_t size(void) const noexcept
+    {
+        return count;
+    }
+
+    /**
+     * @brief Sorts the list.  Equivalent elements remain in list order.
+     */
+    void sort(void)
+    {
+        if(empty())
+        {
+            return;
+        }
+        finish = basic_mfpkg::index_chain::sort(*arena, start);
+    }
+
+    void remove(const _Tp& __val) noexcept
+    {
+        for (index_type __it = start; __it && link(__it); )
+        {
+            if(arena->value(link(__it)) == __val)
+            {
+                erase_after(iterator(arena, __it));
+            }
+            else
+            {
+                __it = link(__it);
+            }
+        }
+    }
+
+    void remove_if(bool (*__pred)(const _Tp& __val)) noexcept
+    {
+        for (index_type __it = start; __it && link(__it); )
+        {
+            if(__pred(arena->value(link(__it))))
+            {
+                erase_after(iterator(arena, __it));
+            }
+            else
+            {
+                __it = link(__it);
+            }
+        }
+    }
+
+    void unique(void) noexcept
+    {
+        for (index_type __it = begin()._M_node; __it && link(__it); )
+        {
+            if(arena->value(__it) == arena->value(link(__it)))
+            {
+                erase_after(iterator(arena, __it));
+            }
+            else
+            {
+                __it = link(__it);
+            }
+        }
+    }
+
+    void reverse(void) noexcept
+    {
+        if(empty())
+        {
+            return;
+        }
+        finish = basic_mfpkg::index_chain::reverse(*arena, start);
+    }
+
+    void resize(std::size_t __n)
+    {
+        resize(__n, _Tp());
+    }
+
+    void resize(std::size_t __n, const _Tp& __val)
+    {
+        if(__n < count)
+        {
+            index_type __it = start;
+            for (std::size_t __i = 0; __i < __n; ++__i, __it = link(__it));
+            erase_after(iterator(arena, __it), end());
+        }
+        while (count < __n)
+        {
+            link_after(finish, __val);
+        }
+    }
+
+    void clear(void) noexcept
+    {
+        if(!start)
+        {
+            return;
+        }
+        for (index_type __it = link(start); __it; )
+        {
+            index_type __next = link(__it);
+            arena->destroy(__it);
+            __it = __next;
+        }
+        link(start) = 0;
+        finish = start;
+        count = 0;
+    }
+
+    void swap(_Self& __list) noexcept
+    {
+        std::swap(arena, __list.arena);
+        std::swap(start, __list.start);
+        std::swap(finish, __list.finish);
+        std::swap(count, __list.count);
+        std::swap(owner, __list.owner);
+    }
+};
+
+#endif
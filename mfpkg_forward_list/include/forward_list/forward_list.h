@@ -3,6 +3,9 @@
  *  and fixed time insertion/deletion at any point in the sequence.
  *
  *  @tparam _Tp  Type of element.
+ *  @tparam _Policy  Instrumentation and layout policy,
+ *                   mfpkg::no_instrumentation, mfpkg::instrumented
+ *                   or mfpkg::layout.
  *
  *  This is a @e singly @e linked %list.  Traversal up the
  *  %list requires linear time, but adding and removing elements (or
@@ -24,57 +27,191 @@
 #ifndef FORWARD_LIST_H
 #define FORWARD_LIST_H
 
-template <typename _Tp>
-class mfpkg::forward_list : public basic_mfpkg::basic_forward_list
+template <typename _Tp, typename _Policy>
+class mfpkg::forward_list : public basic_mfpkg::basic_forward_list,
+                            private _Policy::stats_type
 {
 private:
 
-    typedef forward_list<_Tp> _Self;
+    typedef forward_list<_Tp, _Policy> _Self;
     typedef iterator<_Tp> Iterator;
     typedef const_iterator<_Tp> const_Iterator;
-    typedef _Tp& reference;
-    typedef const _Tp& const_reference;
-    typedef basic_forward_list::forward_list<_Tp> basic_object;
+    typedef basic_forward_list::forward_list<_Tp, _Policy::has_tail, _Policy::has_size> basic_object;
+    typedef typename _Policy::stats_type stats_base;
+
+    static_assert(!_Policy::enabled || _Policy::has_size,
+                  "instrumentation needs a layout with a size counter");
 
     basic_object object;
 
+    friend struct basic_mfpkg::list_io;
+    template <typename> friend class mfpkg::timing_wheel;
+
+    /**
+     * Accounts one operation on a %list to its statistics when the
+     * probe goes out of scope.  Operations that only relink nodes
+     * allocate and free nothing.
+     */
+    class probe
+    {
+    private:
+
+        _Self& list;
+        mfpkg::list_op op;
+        std::size_t before;
+        std::size_t walked;
+        bool relinks;
+        std::chrono::steady_clock::time_point started;
+
+    public:
+
+        probe(_Self& __list, mfpkg::list_op __op, std::size_t __walked = 0,
+              bool __relinks = false) noexcept
+        : list(__list), op(__op), before(__list.size()), walked(__walked), relinks(__relinks)
+        {
+            if constexpr (_Policy::timed)
+            {
+                started = std::chrono::steady_clock::now();
+            }
+        }
+
+        probe(const probe&) = delete;
+
+        ~probe() noexcept
+        {
+            stats_base& __s = list;
+            if constexpr (_Policy::timed)
+            {
+                auto __ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - started).count();
+                __s.latency[std::size_t(op)].record(std::uint64_t(__ns));
+            }
+            if(relinks)
+            {
+                __s.relinked(op, list.size());
+            }
+            else
+            {
+                __s.record(op, before, list.size(), walked);
+            }
+        }
+
+        void step(void) noexcept
+        {
+            ++walked;
+        }
+    };
+
+    /**
+     * Runs @a __f as one @a __op that follows @a __walked links.  Without
+     * instrumentation this is just __f().
+     */
+    template <typename _Function>
+    decltype(auto) tracked(mfpkg::list_op __op, std::size_t __walked, _Function&& __f)
+    {
+        if constexpr (_Policy::enabled)
+        {
+            probe __p(*this, __op, __walked);
+            return __f();
+        }
+        else
+        {
+            return __f();
+        }
+    }
+
+    /**
+     * The links followed by an operation over the whole %list, as
+     * accounted by tracked().  Never counts the elements of a %list
+     * without instrumentation, which may lack a size counter.
+     */
+    std::size_t steps(void) const noexcept
+    {
+        if constexpr (_Policy::enabled)
+        {
+            return size();
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    template <typename _Function>
+    decltype(auto) relinking(mfpkg::list_op __op, _Function&& __f)
+    {
+        if constexpr (_Policy::enabled)
+        {
+            probe __p(*this, __op, 0, true);
+            return __f();
+        }
+        else
+        {
+            return __f();
+        }
+    }
+
 public:
 
+    typedef _Tp value_type;
+    typedef node_handle<_Tp> node_type;
+    typedef _Tp& reference;
+    typedef const _Tp& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
     forward_list() = default;
 
     forward_list(std::initializer_list<_Tp> __list)
     {
-        for (auto& __x : __list)
+        tracked(mfpkg::list_op::assign, 0, [&]
         {
-            object.insert_after(object.rbegin(), __x);
-        }
+            auto __pos = object.before_begin();
+            for (auto& __x : __list)
+            {
+                __pos = object.insert_after(__pos, __x);
+            }
+        });
     }
 
     forward_list(const _Self& __list)
     {
-        for (auto& __x : __list)
+        tracked(mfpkg::list_op::assign, 0, [&]
         {
-            object.insert_after(object.rbegin(), __x);
-        }
+            auto __pos = object.before_begin();
+            for (auto& __x : __list)
+            {
+                __pos = object.insert_after(__pos, __x);
+            }
+        });
+    }
+
+    /**
+     * Takes the nodes of @a __list in constant time, leaving it empty.
+     * Nothing is copied, so containers of lists relocate them cheaply.
+     */
+    forward_list(_Self&& __list) noexcept
+    {
+        relinking(mfpkg::list_op::splice_after, [&] { object.swap(__list.object); });
     }
 
     ~forward_list() noexcept { }
 
     _Self& operator=(std::initializer_list<_Tp> __list)
     {
-        object.assign(__list);
+        assign(__list);
         return *this;
     }
 
     _Self& operator=(const _Self& __list)
     {
-        object.assign(__list.object);
+        tracked(mfpkg::list_op::assign, 0, [&] { object.assign(__list.object); });
         return *this;
     }
 
     _Self& operator=(_Self&& __list)
     {
-        object.assign(std::move(__list.object));
+        relinking(mfpkg::list_op::splice_after, [&] { object.assign(std::move(__list.object)); });
         return *this;
     }
 
@@ -88,7 +225,7 @@ public:
      */
     void assign(std::initializer_list<_Tp> __list)
     {
-        object.assign(__list);
+        tracked(mfpkg::list_op::assign, 0, [&] { object.assign(__list); });
     }
 
     /**
@@ -209,7 +346,8 @@ public:
      */
     void push_back(const _Tp& __val)
     {
-        object.insert_after(object.rbegin(), __val);
+        static_assert(_Policy::has_tail, "push_back needs a layout with a tail link");
+        tracked(mfpkg::list_op::push_back, 0, [&] { object.insert_after(object.rbegin(), __val); });
     }
 
     /**
@@ -217,7 +355,8 @@ public:
      */
     void push_back(_Tp&& __val)
     {
-        object.insert_after(object.rbegin(), __val);
+        static_assert(_Policy::has_tail, "push_back needs a layout with a tail link");
+        tracked(mfpkg::list_op::push_back, 0, [&] { object.insert_after(object.rbegin(), std::move(__val)); });
     }
 
     /**
@@ -232,7 +371,7 @@ public:
      */
     void push_front(const _Tp& __val)
     {
-        object.insert_after(object.before_begin(), __val);
+        tracked(mfpkg::list_op::push_front, 0, [&] { object.insert_after(object.before_begin(), __val); });
     }
 
     /**
@@ -240,7 +379,7 @@ public:
      */
     void push_front(_Tp&& __val)
     {
-        object.insert_after(object.before_begin(), __val);
+        tracked(mfpkg::list_op::push_front, 0, [&] { object.insert_after(object.before_begin(), std::move(__val)); });
     }
 
     /**
@@ -257,7 +396,7 @@ public:
      */ 
     void pop_front(void) noexcept
     {
-        object.pop_front();
+        tracked(mfpkg::list_op::pop_front, 0, [&] { object.pop_front(); });
     }
 
     /**
@@ -275,7 +414,12 @@ public:
      */ 
     void pop_back(void) noexcept
     {
-        erase_after(before_begin()+=size()-1);
+        tracked(mfpkg::list_op::pop_back, steps() ? steps() - 1 : 0, [&]
+        {
+            node_base* __prev = object.before_begin();
+            for (; __prev->link && __prev->link->link; __prev = __prev->link);
+            object.erase_after(__prev);
+        });
     }
 
     /**
@@ -290,7 +434,10 @@ public:
      */
     Iterator insert_after(const Iterator& __position, const _Tp& __val)
     {
-        return object.insert_after(__position._M_node, __val);
+        return tracked(mfpkg::list_op::insert_after, 0, [&]
+        {
+            return object.insert_after(__position._M_node, __val);
+        });
     }
 
     /**
@@ -298,7 +445,10 @@ public:
      */
     Iterator insert_after(const Iterator& __position, _Tp&& __val)
     {
-        return object.insert_after(__position._M_node, __val);
+        return tracked(mfpkg::list_op::insert_after, 0, [&]
+        {
+            return object.insert_after(__position._M_node, std::move(__val));
+        });
     }
 
     /**
@@ -318,12 +468,40 @@ public:
      */
     Iterator insert_after(const Iterator& __position, std::initializer_list<_Tp> __list)
     {
-        auto __pos = __position;
-        for (auto& __x : __list)
+        return tracked(mfpkg::list_op::insert_after, 0, [&]
         {
-            __pos = insert_after(__pos, __x);
-        }
-        return __pos;
+            auto __pos = __position._M_node;
+            for (auto& __x : __list)
+            {
+                __pos = object.insert_after(__pos, __x);
+            }
+            return __pos;
+        });
+    }
+
+    /**
+     *  @brief  Inserts a range into the %forward_list after the specified iterator.
+     *  @param  __position  An iterator into the %forward_list.
+     *  @param  __first     An input iterator.
+     *  @param  __last      An input iterator.
+     *  @return   An iterator pointing to the last inserted element
+     *            or @a __position if the range is empty.
+     *
+     *  The copies of the range [__first,__last) are first linked into a
+     *  detached chain, which is then spliced in after @a __position with a
+     *  single relink, so the %forward_list bookkeeping is updated once.
+     *
+     *  This operation is linear in the number of elements inserted and
+     *  does not invalidate iterators and references.
+     */
+    template <typename _InputIt,
+              typename = typename std::iterator_traits<_InputIt>::iterator_category>
+    Iterator insert_after(const Iterator& __position, _InputIt __first, _InputIt __last)
+    {
+        return tracked(mfpkg::list_op::insert_after, 0, [&]
+        {
+            return object.insert_after(__position._M_node, __first, __last);
+        });
     }
 
     /**
@@ -341,7 +519,48 @@ public:
      */
     Iterator erase_after(const Iterator& __position) noexcept
     {
-        return object.erase_after(__position._M_node);
+        return tracked(mfpkg::list_op::erase_after, 0, [&]
+        {
+            return object.erase_after(__position._M_node);
+        });
+    }
+
+    /**
+     * @brief Unlinks the element following position and hands over its node.
+     * @param __position Iterator pointing before the element to extract.
+     * @return  A node handle owning the element, empty if @a __position
+     *          has no successor.
+     *
+     * Nothing is destroyed or deallocated.  References to the element stay
+     * valid and now refer into the handle.
+     */
+    node_type extract_after(const Iterator& __position) noexcept
+    {
+        return relinking(mfpkg::list_op::erase_after, [&]
+        {
+            return node_type(object.unlink_after(__position._M_node));
+        });
+    }
+
+    /**
+     * @brief Links the node owned by a handle after position.
+     * @param __position An iterator into the %forward_list.
+     * @param __nh A node handle, taken from any %forward_list of _Tp.
+     * @return  An iterator to the inserted element, or @a __position if
+     *          @a __nh is empty.
+     *
+     * The handle is left empty.  Nothing is allocated or copied.
+     */
+    Iterator insert_after(const Iterator& __position, node_type&& __nh) noexcept
+    {
+        if(__nh.empty())
+        {
+            return __position;
+        }
+        return relinking(mfpkg::list_op::insert_after, [&]
+        {
+            return object.link_after(__position._M_node, __nh.release());
+        });
     }
 
     /**
@@ -358,7 +577,10 @@ public:
      */
     Iterator erase_after(const Iterator& __before, const Iterator& __last) noexcept
     {
-        return object.erase_after(__before._M_node, __last._M_node);
+        return tracked(mfpkg::list_op::erase_after, 0, [&]
+        {
+            return object.erase_after(__before._M_node, __last._M_node);
+        });
     }
 
     /**
@@ -372,7 +594,10 @@ public:
      */
     void splice_after(const Iterator& __position, _Self&& __list) noexcept
     {
-        object.splice_after(__position._M_node, __list.object);
+        relinking(mfpkg::list_op::splice_after, [&]
+        {
+            object.splice_after(__position._M_node, __list.object);
+        });
     }
 
     void splice_after(const Iterator& __position, _Self& __list) noexcept
@@ -392,7 +617,10 @@ public:
      */
     void splice_after(const Iterator& __position, _Self&& __list, const Iterator& __i) noexcept
     {
-        object.splice_after(__position._M_node, __list.object, __i._M_node);
+        relinking(mfpkg::list_op::splice_after, [&]
+        {
+            object.splice_after(__position._M_node, __list.object, __i._M_node);
+        });
     }
 
     void splice_after(const Iterator& __position, _Self& __list, const Iterator& __i) noexcept
@@ -414,7 +642,10 @@ public:
     void splice_after(const Iterator& __position, _Self&& __list, const Iterator& __before,
                                                                  const Iterator& __last) noexcept
     {
-        object.splice_after(__position._M_node, __list.object, __before._M_node, __last._M_node);
+        relinking(mfpkg::list_op::splice_after, [&]
+        {
+            object.splice_after(__position._M_node, __list.object, __before._M_node, __last._M_node);
+        });
     }
 
     void splice_after(const Iterator& __position, _Self& __list, const Iterator& __before,
@@ -423,6 +654,53 @@ public:
         splice_after(__position._M_node, std::move(__list), __before._M_node, __last._M_node);
     }
 
+    /**
+     *  @brief  Moves the elements satisfying a predicate to a new %list.
+     *  @param  __pred  Unary predicate function.
+     *  @return  A %forward_list holding the matching elements.
+     *
+     *  Both lists keep their elements in the original relative order.
+     *  The nodes are relinked in a single pass, without allocating or
+     *  copying elements.  Iterators stay valid and refer to the same
+     *  elements, now possibly in the returned %list.
+     */
+    template <typename _Predicate>
+    _Self partition(_Predicate __pred)
+    {
+        _Self __matches;
+        relinking(mfpkg::list_op::splice_after, [&] { object.partition(__pred, __matches.object); });
+        return __matches;
+    }
+
+    /**
+     *  @brief  Splits the %list after its first @a __n elements.
+     *  @return  A %forward_list holding the elements from position
+     *           @a __n on, empty if @a __n >= size().
+     *
+     *  Linear in @a __n.  Nothing is allocated or copied.
+     */
+    _Self split_at(std::size_t __n) noexcept
+    {
+        _Self __rest;
+        relinking(mfpkg::list_op::splice_after, [&] { object.split_at(__n, __rest.object); });
+        return __rest;
+    }
+
+    /**
+     *  @brief  Splits the %list after an element.
+     *  @param  __position  An element of this %list, or before_begin().
+     *  @return  A %forward_list holding the elements after @a __position.
+     *
+     *  Linear in the number of elements up to @a __position, which are
+     *  walked to keep size() exact.  Nothing is allocated or copied.
+     */
+    _Self split_after(const Iterator& __position) noexcept
+    {
+        _Self __rest;
+        relinking(mfpkg::list_op::splice_after, [&] { object.split_after(__position._M_node, __rest.object); });
+        return __rest;
+    }
+
     /**
      * @brief  Returns true if the %forward_list is empty.
      */ 
@@ -455,6 +733,66 @@ public:
         return object.size();
     }
 
+    /**
+     * @brief  Finds the first element equal to value.
+     * @param  __val  The value to look for.
+     * @return  An iterator to the element, or end() if there is none.
+     *
+     * For arithmetic element types the elements are copied out a block
+     * of nodes at a time and compared with vector instructions.
+     */
+    Iterator find(const _Tp& __val) noexcept
+    {
+        return object.find_equal(__val);
+    }
+
+    /**
+     * @brief  Finds the first element equal to value.
+     * @param  __val  The value to look for.
+     * @return  A read-only iterator to the element, or end() if there is none.
+     */
+    const_Iterator find(const _Tp& __val) const noexcept
+    {
+        return object.find_equal(__val);
+    }
+
+    /**
+     * @brief  Returns the number of elements equal to value.
+     * @param  __val  The value to count.
+     */
+    std::size_t count(const _Tp& __val) const noexcept
+    {
+        return object.count_equal(__val);
+    }
+
+    /**
+     * @brief  Returns the sum of the elements, or a value-initialized
+     * element if the %forward_list is empty.
+     *
+     * For float and double the terms may be added in any order, as
+     * with std::reduce.
+     */
+    _Tp sum(void) const
+    {
+        return object.sum();
+    }
+
+    /**
+     * @brief  Returns the least element of a non-empty %forward_list.
+     */
+    _Tp min(void) const
+    {
+        return object.min();
+    }
+
+    /**
+     * @brief  Returns the greatest element of a non-empty %forward_list.
+     */
+    _Tp max(void) const
+    {
+        return object.max();
+    }
+
     /**
      * @brief Sorts the %forward_list.
      * 
@@ -463,7 +801,15 @@ public:
     */
     void sort(void) noexcept
     {
-        object.sort();
+        if constexpr (_Policy::enabled)
+        {
+            probe __p(*this, mfpkg::list_op::sort);
+            object.sort([&__p] { __p.step(); });
+        }
+        else
+        {
+            object.sort();
+        }
     }
 
     /**
@@ -479,7 +825,7 @@ public:
      */
     void remove(const _Tp& __val) noexcept
     {
-        object.remove(__val);
+        tracked(mfpkg::list_op::remove, steps(), [&] { object.remove(__val); });
     }
 
     /**
@@ -495,7 +841,7 @@ public:
      */
     void remove_if(bool (*__pred)(const _Tp& __val)) noexcept
     {
-        object.remove_if(__pred);
+        tracked(mfpkg::list_op::remove, steps(), [&] { object.remove_if(__pred); });
     }
 
     /**
@@ -511,7 +857,27 @@ public:
     */
     void unique(void) noexcept
     {
-        object.unique();
+        tracked(mfpkg::list_op::unique, steps(), [&] { object.unique(); });
+    }
+
+    /**
+     * @brief Removes all duplicate elements, adjacent or not.
+     * @param __hash  Hash function for the elements.
+     * @param __eq  Equality predicate consistent with @a __hash.
+     *
+     * Keeps the first occurrence of each value and removes every later
+     * one, in a single pass and in linear expected time.  Remaining
+     * elements stay in list order.  A table of about two slots per
+     * element is allocated for the duration of the call.
+     *
+     * Note that this function only erases the elements, and that if the
+     * elements themselves are pointers, the pointed-to memory is not
+     * touched in any way.
+     */
+    template <typename _Hash = std::hash<_Tp>, typename _Equal = std::equal_to<_Tp>>
+    void unique_all(_Hash __hash = _Hash(), _Equal __eq = _Equal())
+    {
+        tracked(mfpkg::list_op::unique, steps(), [&] { object.unique_all(__hash, __eq); });
     }
 
     /**
@@ -522,7 +888,7 @@ public:
      */
     void reverse(void) noexcept
     {
-        object.reverse();
+        tracked(mfpkg::list_op::reverse, steps(), [&] { object.reverse(); });
     }
 
     /**
@@ -536,7 +902,7 @@ public:
      */
     void resize(std::size_t __n)
     {
-        object.resize(__n);
+        tracked(mfpkg::list_op::resize, __n < steps() ? __n : 0, [&] { object.resize(__n); });
     }
 
     /**
@@ -551,7 +917,7 @@ public:
      */
     void resize(std::size_t __n, const _Tp& __val)
     {
-        object.resize(__n, __val);
+        tracked(mfpkg::list_op::resize, __n < steps() ? __n : 0, [&] { object.resize(__n, __val); });
     }
 
     /**
@@ -564,7 +930,90 @@ public:
      */
     void clear(void) noexcept
     {
-        object.clear();
+        tracked(mfpkg::list_op::clear, 0, [&] { object.clear(); });
+    }
+
+    /**
+     * @brief Erases all elements using several threads.
+     * @param __threads Number of threads, zero for one per hardware core.
+     *
+     * The chain is cut into one piece per thread with a single walk and the
+     * pieces are destroyed concurrently.  Short lists are cleared serially.
+     */
+    void clear_parallel(std::size_t __threads = 0)
+    {
+        tracked(mfpkg::list_op::clear, 0, [&] { object.clear_parallel(__threads); });
+    }
+
+    /**
+     * @brief Builds a %forward_list from a random access range using several threads.
+     * @param __range   Source range, such as a std::vector or an array.
+     * @param __threads Number of threads, zero for one per hardware core.
+     * @return  A %forward_list holding copies of the elements of @a __range
+     *          in the same order.
+     *
+     * Each thread allocates and constructs the sub-chain for its own slice
+     * of @a __range, then the sub-chains are joined in O(threads).
+     */
+    template <typename _Range>
+    static _Self from_range_parallel(const _Range& __range, std::size_t __threads = 0)
+    {
+        typedef decltype(std::begin(__range)) _RangeIt;
+        static_assert(std::is_base_of<std::random_access_iterator_tag,
+                      typename std::iterator_traits<_RangeIt>::iterator_category>::value,
+                      "from_range_parallel requires a random access range");
+        _Self __list;
+        __list.tracked(mfpkg::list_op::assign, 0, [&]
+        {
+            __list.object.append_parallel(std::begin(__range), std::size(__range), __threads);
+        });
+        return __list;
+    }
+
+    /**
+     * @brief Relocates the nodes into one contiguous block in list order.
+     * @return false if the block could not be allocated, in which case
+     *         the %forward_list is left untouched.
+     *
+     * After many splices, sorts and removals consecutive elements end up
+     * scattered across the heap and every step of a traversal is a cache
+     * miss.  This function moves the elements into freshly allocated
+     * contiguous memory in list order (with memcpy for trivially copyable
+     * types) and relinks the chain.  Iterators and references to the
+     * elements are invalidated.  Linear in size().
+     *
+     * The block is returned to the heap only when its last node is
+     * erased; the slots of erased nodes are not reused in between.  A
+     * defragmented %forward_list that later shrinks a lot keeps its peak
+     * footprint until it is defragmented again or cleared.
+     */
+    bool defragment(void)
+    {
+        return tracked(mfpkg::list_op::defragment, steps(), [&]
+        {
+            bool __moved = object.defragment();
+            if constexpr (_Policy::enabled)
+            {
+                if(__moved && size() > 1)
+                {
+                    stats_base& __s = *this;
+                    __s.allocations += size();
+                    __s.frees += size();
+                }
+            }
+            return __moved;
+        });
+    }
+
+    /**
+     * @brief Returns the average distance in bytes between neighbouring nodes.
+     *
+     * A freshly defragmented %forward_list reports the size of one node;
+     * larger values mean the traversal jumps around the heap more.
+     */
+    double fragmentation(void) const noexcept
+    {
+        return object.fragmentation();
     }
 
     /**
@@ -574,9 +1023,37 @@ public:
      * This exchanges the elements between two lists in constant
      * time.
      */ 
-    void swap(forward_list<_Tp>& __list) noexcept
+    void swap(_Self& __list) noexcept
+    {
+        __list.relinking(mfpkg::list_op::swap, [&]
+        {
+            relinking(mfpkg::list_op::swap, [&] { object.swap(__list.object); });
+        });
+    }
+
+    /**
+     * @brief Returns the statistics gathered by the instrumentation policy.
+     *
+     * Available when @a _Policy is mfpkg::instrumented; the result is a
+     * mfpkg::list_stats, or a mfpkg::timed_list_stats with per operation
+     * latency histograms.
+     */
+    const stats_base& stats(void) const noexcept
+    {
+        static_assert(_Policy::enabled, "stats() requires an instrumented forward_list");
+        return *this;
+    }
+
+    /**
+     * @brief Writes stats() as text to the file at @a __path, replacing it.
+     * @return false if the file could not be written.
+     */
+    bool dump_stats(const char* __path) const
     {
-        object.swap(__list.object);
+        static_assert(_Policy::enabled, "dump_stats() requires an instrumented forward_list");
+        std::ofstream __out(__path, std::ios::trunc);
+        stats().dump(__out);
+        return bool(__out.flush());
     }
 
 };
@@ -0,0 +1,103 @@
+/**
+ * @file index_chain.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef INDEX_CHAIN_H
+#define INDEX_CHAIN_H
+
+/**
+ *  Algorithms shared by the lists that link their nodes with integer
+ *  indices instead of pointers.  A store exposes @c link(i), returning a
+ *  reference to the link of slot @a i, and @c value(i), returning its
+ *  element.  Index zero is the null link, and every chain hangs off a
+ *  head slot that holds no element.
+ */
+struct basic_mfpkg::index_chain
+{
+    /**
+     * Merges the sorted chains @a __a and @a __b, taking from @a __a on ties.
+     */
+    template <typename _Store, typename _Index>
+    static _Index merge(_Store& __s, _Index __a, _Index __b)
+    {
+        _Index __head = 0;
+        _Index* __tail = &__head;
+        while (__a && __b)
+        {
+            if(__s.value(__a) > __s.value(__b))
+            {
+                *__tail = __b;
+                __tail = &__s.link(__b);
+                __b = *__tail;
+            }
+            else
+            {
+                *__tail = __a;
+                __tail = &__s.link(__a);
+                __a = *__tail;
+            }
+        }
+        *__tail = __a ? __a : __b;
+        return __head;
+    }
+
+    /**
+     * Stable bottom-up merge sort of the chain after @a __head.
+     * Returns the new last slot.
+     */
+    template <typename _Store, typename _Index>
+    static _Index sort(_Store& __s, _Index __head)
+    {
+        _Index __bins[8 * sizeof(_Index) + 1] = {};
+        std::size_t __used = 0;
+        for (_Index __cur = __s.link(__head); __cur; )
+        {
+            _Index __carry = __cur;
+            __cur = __s.link(__cur);
+            __s.link(__carry) = 0;
+            std::size_t __k = 0;
+            for (; __bins[__k]; ++__k)
+            {
+                __carry = merge(__s, __bins[__k], __carry);
+                __bins[__k] = 0;
+            }
+            __bins[__k] = __carry;
+            __used = std::max(__used, __k + 1);
+        }
+        _Index __result = 0;
+        for (std::size_t __k = 0; __k < __used; ++__k)
+        {
+            if(__bins[__k])
+            {
+                __result = merge(__s, __bins[__k], __result);
+            }
+        }
+        __s.link(__head) = __result;
+        _Index __last = __head;
+        for (; __s.link(__last); __last = __s.link(__last));
+        return __last;
+    }
+
+    /**
+     * Reverses the chain after @a __head.  Returns the new last slot.
+     */
+    template <typename _Store, typename _Index>
+    static _Index reverse(_Store& __s, _Index __head)
+    {
+        _Index __first = __s.link(__head);
+        _Index __prev = 0;
+        for (_Index __cur = __first; __cur; )
+        {
+            _Index __next = __s.link(__cur);
+            __s.link(__cur) = __prev;
+            __prev = __cur;
+            __cur = __next;
+        }
+        __s.link(__head) = __prev;
+        return __first ? __first : __head;
+    }
+};
+
+#endif
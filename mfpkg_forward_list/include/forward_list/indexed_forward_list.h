@@ -0,0 +1,624 @@
+/**
+ *  @brief A singly linked %list with a hash index over its elements.
+ *
+ *  @tparam _Tp    Type of element.
+ *  @tparam _Hash  Hash function object for _Tp.
+ *  @tparam _Eq    Equality predicate for _Tp.
+ *
+ *  An %indexed_forward_list behaves like mfpkg::forward_list, but keeps
+ *  two hash tables next to the chain: one from each element's value to
+ *  its node, and one from each node to the node before it.  With them
+ *  contains(), find(), find_before(), count(), erase() and remove() by
+ *  value take expected constant time instead of a walk over the chain,
+ *  and erasing the element at an iterator no longer needs its
+ *  predecessor.  Equal elements are allowed; operations touching every
+ *  copy of a value take time linear in the number of copies.
+ *
+ *  Every structural operation keeps the index current.  sort() and
+ *  reverse() relink the chain as usual and then rebuild the predecessor
+ *  table in linear time.  Splicing within one list stays constant time
+ *  for single elements; splicing from another list moves the index
+ *  entries of the spliced elements.
+ *
+ *  Only const iterators are provided, since changing an element in place
+ *  would leave it filed under its old value.  To change one, extract its
+ *  node, modify the element through the handle and insert it again; it
+ *  is filed under its new value without reallocating.  Node handles are
+ *  shared with mfpkg::forward_list of the same element type.
+ *
+ *  @file indexed_forward_list.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef INDEXED_FORWARD_LIST_H
+#define INDEXED_FORWARD_LIST_H
+
+template <typename _Tp, typename _Hash, typename _Eq>
+class mfpkg::indexed_forward_list : public basic_mfpkg::basic_forward_list
+{
+private:
+
+    typedef indexed_forward_list<_Tp, _Hash, _Eq> _Self;
+    typedef basic_forward_list::forward_list<_Tp> basic_object;
+
+    struct value_hash
+    {
+        _Hash hash;
+
+        std::size_t operator()(const _Tp* __p) const
+        {
+            return hash(*__p);
+        }
+    };
+
+    struct value_equal
+    {
+        _Eq eq;
+
+        bool operator()(const _Tp* __a, const _Tp* __b) const
+        {
+            return eq(*__a, *__b);
+        }
+    };
+
+    basic_object object;
+    std::unordered_multimap<const _Tp*, node_base*, value_hash, value_equal> values;
+    std::unordered_map<const node_base*, node_base*> before;
+
+    static const _Tp* key(const node_base* __n) noexcept
+    {
+        return &static_cast<const node<_Tp>*>(__n)->storage;
+    }
+
+    static node_base* mutable_node(const node_base* __n) noexcept
+    {
+        return const_cast<node_base*>(__n);
+    }
+
+    /**
+     * Files the node @a __n, just linked after @a __pos.
+     */
+    void index(node_base* __n, node_base* __pos)
+    {
+        values.emplace(key(__n), __n);
+        try
+        {
+            before[__n] = __pos;
+            if(__n->link)
+            {
+                before[__n->link] = __n;
+            }
+        }
+        catch (...)
+        {
+            unindex(__n);
+            throw;
+        }
+    }
+
+    void unindex(const node_base* __n) noexcept
+    {
+        auto __range = values.equal_range(key(__n));
+        for (auto __it = __range.first; __it != __range.second; ++__it)
+        {
+            if(__it->second == __n)
+            {
+                values.erase(__it);
+                break;
+            }
+        }
+        before.erase(__n);
+    }
+
+    node_base* link_after(node_base* __pos, const _Tp& __val)
+    {
+        node_base* __n = object.insert_after(__pos, __val);
+        try
+        {
+            index(__n, __pos);
+        }
+        catch (...)
+        {
+            object.erase_after(__pos);
+            throw;
+        }
+        return __n;
+    }
+
+    node_base* unlink_after(node_base* __pos) noexcept
+    {
+        node_base* __n = __pos->link;
+        node_base* __next = __n->link;
+        unindex(__n);
+        if(__next)
+        {
+            before[__next] = __pos;
+        }
+        object.erase_after(__pos);
+        return __next;
+    }
+
+    /**
+     * Recomputes the predecessor of every node.  The nodes themselves,
+     * and so the value table, are unchanged.
+     */
+    void rebuild_before(void) noexcept
+    {
+        node_base* __prev = object.before_begin();
+        for (node_base* __it = __prev->link; __it; __prev = __it, __it = __it->link)
+        {
+            before.find(__it)->second = __prev;
+        }
+    }
+
+public:
+
+    typedef _Tp value_type;
+    typedef const _Tp& reference;
+    typedef const _Tp& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef basic_forward_list::const_iterator<_Tp> iterator;
+    typedef basic_forward_list::const_iterator<_Tp> const_iterator;
+    typedef basic_forward_list::node_handle<_Tp> node_type;
+
+    indexed_forward_list() = default;
+
+    indexed_forward_list(std::initializer_list<_Tp> __list)
+    {
+        reserve(__list.size());
+        for (auto& __x : __list)
+        {
+            push_back(__x);
+        }
+    }
+
+    indexed_forward_list(const _Self& __list)
+    {
+        reserve(__list.size());
+        for (auto& __x : __list)
+        {
+            push_back(__x);
+        }
+    }
+
+    indexed_forward_list(_Self&& __list) noexcept
+    {
+        swap(__list);
+    }
+
+    ~indexed_forward_list() noexcept { }
+
+    _Self& operator=(const _Self& __list)
+    {
+        if(this != &__list)
+        {
+            _Self __copy(__list);
+            swap(__copy);
+        }
+        return *this;
+    }
+
+    _Self& operator=(_Self&& __list) noexcept
+    {
+        swap(__list);
+        return *this;
+    }
+
+    /**
+     * @brief Prepares the index for @a __n elements without rehashing.
+     */
+    void reserve(size_type __n)
+    {
+        values.reserve(__n);
+        before.reserve(__n);
+    }
+
+    const_iterator before_begin(void) const noexcept
+    {
+        return object.before_begin();
+    }
+
+    const_iterator begin(void) const noexcept
+    {
+        return object.begin();
+    }
+
+    const_iterator cbegin(void) const noexcept
+    {
+        return object.begin();
+    }
+
+    const_iterator end(void) const noexcept
+    {
+        return object.end();
+    }
+
+    const_iterator cend(void) const noexcept
+    {
+        return object.end();
+    }
+
+    const_reference front(void) const noexcept
+    {
+        return *begin();
+    }
+
+    const_reference back(void) const noexcept
+    {
+        return *const_iterator(object.rbegin());
+    }
+
+    bool empty(void) const noexcept
+    {
+        return object.empty();
+    }
+
+    size_type size(void) const noexcept
+    {
+        return object.size();
+    }
+
+    void push_front(const _Tp& __val)
+    {
+        link_after(object.before_begin(), __val);
+    }
+
+    void push_back(const _Tp& __val)
+    {
+        link_after(object.empty() ? object.before_begin() : object.rbegin(), __val);
+    }
+
+    void pop_front(void) noexcept
+    {
+        if(!empty())
+        {
+            unlink_after(object.before_begin());
+        }
+    }
+
+    const_iterator insert_after(const_iterator __position, const _Tp& __val)
+    {
+        return link_after(mutable_node(__position._M_node), __val);
+    }
+
+    /**
+     * @brief Links the node owned by @a __nh after @a __position and
+     * files it in the index.
+     * @return  An iterator to the inserted element, or @a __position if
+     *          @a __nh is empty.
+     *
+     * Nothing is allocated for the element.  If filing it throws, the
+     * node is unlinked again and left in @a __nh.
+     */
+    const_iterator insert_after(const_iterator __position, node_type&& __nh)
+    {
+        if(__nh.empty())
+        {
+            return __position;
+        }
+        node_base* __pos = mutable_node(__position._M_node);
+        node_base* __n = object.link_after(__pos, __nh.release());
+        try
+        {
+            index(__n, __pos);
+        }
+        catch (...)
+        {
+            if(__n->link)
+            {
+                before.find(__n->link)->second = __pos;
+            }
+            __nh._M_node = object.unlink_after(__pos);
+            throw;
+        }
+        return __n;
+    }
+
+    /**
+     * @brief Unlinks the element following @a __position, removes it from
+     * the index and hands over its node.
+     * @return  A node handle owning the element, empty if @a __position
+     *          has no successor.
+     */
+    node_type extract_after(const_iterator __position) noexcept
+    {
+        node_base* __pos = mutable_node(__position._M_node);
+        if(!__pos || !__pos->link)
+        {
+            return node_type();
+        }
+        node_base* __n = __pos->link;
+        unindex(__n);
+        if(__n->link)
+        {
+            before.find(__n->link)->second = __pos;
+        }
+        return node_type(object.unlink_after(__pos));
+    }
+
+    /**
+     * @brief Removes the element following @a __position.
+     * @return  An iterator to the element after the erased one, or end().
+     */
+    const_iterator erase_after(const_iterator __position) noexcept
+    {
+        node_base* __pos = mutable_node(__position._M_node);
+        if(!__pos || !__pos->link)
+        {
+            return end();
+        }
+        return unlink_after(__pos);
+    }
+
+    /**
+     * @brief Removes the elements in the range (__before, __last).
+     */
+    const_iterator erase_after(const_iterator __before, const_iterator __last) noexcept
+    {
+        node_base* __pos = mutable_node(__before._M_node);
+        while (__pos->link != __last._M_node)
+        {
+            unlink_after(__pos);
+        }
+        return __last;
+    }
+
+    /**
+     * @brief Removes the element at @a __position in expected constant time.
+     * @return  An iterator to the element after the erased one.
+     */
+    const_iterator erase(const_iterator __position) noexcept
+    {
+        return unlink_after(before.find(__position._M_node)->second);
+    }
+
+    /**
+     * @brief Removes one element equal to @a __val.
+     * @return false if there is none.
+     */
+    bool erase(const _Tp& __val) noexcept
+    {
+        auto __it = values.find(&__val);
+        if(__it == values.end())
+        {
+            return false;
+        }
+        unlink_after(before.find(__it->second)->second);
+        return true;
+    }
+
+    /**
+     * @brief Removes every element equal to @a __val.
+     * @return  The number of elements removed.
+     */
+    size_type remove(const _Tp& __val) noexcept
+    {
+        // @a __val may be one of the elements; it is removed last.
+        auto __range = values.equal_range(&__val);
+        node_base* __self = nullptr;
+        size_type __n = 0;
+        for (auto __it = __range.first; __it != __range.second; )
+        {
+            node_base* __node = (__it++)->second;
+            if(key(__node) == &__val)
+            {
+                __self = __node;
+            }
+            else
+            {
+                unlink_after(before.find(__node)->second);
+                ++__n;
+            }
+        }
+        if(__self)
+        {
+            unlink_after(before.find(__self)->second);
+            ++__n;
+        }
+        return __n;
+    }
+
+    /**
+     * @brief Removes every element satisfying @a __pred.  Linear in size().
+     */
+    template <typename _Predicate>
+    size_type remove_if(_Predicate __pred)
+    {
+        size_type __n = 0;
+        for (node_base* __pos = object.before_begin(); __pos->link; )
+        {
+            if(__pred(*key(__pos->link)))
+            {
+                unlink_after(__pos);
+                ++__n;
+            }
+            else
+            {
+                __pos = __pos->link;
+            }
+        }
+        return __n;
+    }
+
+    bool contains(const _Tp& __val) const
+    {
+        return values.find(&__val) != values.end();
+    }
+
+    size_type count(const _Tp& __val) const
+    {
+        return values.count(&__val);
+    }
+
+    /**
+     * @brief Returns an iterator to an element equal to @a __val, or end().
+     */
+    const_iterator find(const _Tp& __val) const
+    {
+        auto __it = values.find(&__val);
+        return __it == values.end() ? end() : const_iterator(__it->second);
+    }
+
+    /**
+     * @brief Returns an iterator to the element before one equal to
+     * @a __val, suitable for erase_after() and splice_after(), or end().
+     */
+    const_iterator find_before(const _Tp& __val) const
+    {
+        auto __it = values.find(&__val);
+        return __it == values.end() ? end() : const_iterator(before.find(__it->second)->second);
+    }
+
+    void clear(void) noexcept
+    {
+        object.clear();
+        values.clear();
+        before.clear();
+    }
+
+    /**
+     * @brief Moves the elements in (__before, __last) of @a __list after @a __position.
+     *
+     * Linear in the length of the range, which is walked to move its
+     * index entries when @a __list is another list.
+     */
+    void splice_after(const_iterator __position, _Self& __list,
+                      const_iterator __before, const_iterator __last)
+    {
+        node_base* __pos = mutable_node(__position._M_node);
+        node_base* __b = mutable_node(__before._M_node);
+        node_base* __l = mutable_node(__last._M_node);
+        if(!__b || __b->link == __l || (this == &__list && __pos == __b))
+        {
+            return;
+        }
+        node_base* __first = __b->link;
+        node_base* __tail = __first;
+        for (; __tail->link != __l; __tail = __tail->link);
+        if(this != &__list)
+        {
+            // Filing may throw; both lists stay intact until every node
+            // is filed here, and unfiling from @a __list cannot throw.
+            reserve(size() + __list.size());
+            node_base* __it = __first;
+            try
+            {
+                for (; ; __it = __it->link)
+                {
+                    values.emplace(key(__it), __it);
+                    before.emplace(__it, __it);
+                    if(__it == __tail)
+                    {
+                        break;
+                    }
+                }
+            }
+            catch (...)
+            {
+                for (node_base* __n = __first; ; __n = __n->link)
+                {
+                    unindex(__n);
+                    if(__n == __it)
+                    {
+                        break;
+                    }
+                }
+                throw;
+            }
+            for (__it = __first; ; __it = __it->link)
+            {
+                __list.unindex(__it);
+                if(__it == __tail)
+                {
+                    break;
+                }
+            }
+        }
+        for (node_base* __it = __first; __it != __tail; __it = __it->link)
+        {
+            before.find(__it->link)->second = __it;
+        }
+        node_base* __next = __pos->link;
+        object.splice_after(__pos, __list.object, __b, __l);
+        before.find(__first)->second = __pos;
+        if(__next)
+        {
+            before.find(__next)->second = __tail;
+        }
+        if(__l)
+        {
+            __list.before.find(__l)->second = __b;
+        }
+    }
+
+    void splice_after(const_iterator __position, _Self& __list)
+    {
+        splice_after(__position, __list, __list.before_begin(), __list.end());
+    }
+
+    /**
+     * @brief Moves the element after @a __i in @a __list after @a __position.
+     */
+    void splice_after(const_iterator __position, _Self& __list, const_iterator __i)
+    {
+        if(__i._M_node && __i._M_node->link)
+        {
+            splice_after(__position, __list, __i, const_iterator(__i._M_node->link->link));
+        }
+    }
+
+    /**
+     * @brief Sorts the list, then rebuilds the predecessor table.
+     */
+    void sort(void) noexcept
+    {
+        object.sort();
+        rebuild_before();
+    }
+
+    /**
+     * @brief Reverses the list, then rebuilds the predecessor table.
+     */
+    void reverse(void) noexcept
+    {
+        object.reverse();
+        rebuild_before();
+    }
+
+    /**
+     * @brief Removes consecutive duplicate elements.
+     */
+    void unique(void) noexcept
+    {
+        _Eq __eq;
+        for (node_base* __it = object.begin(); __it && __it->link; )
+        {
+            if(__eq(*key(__it), *key(__it->link)))
+            {
+                unlink_after(__it);
+            }
+            else
+            {
+                __it = __it->link;
+            }
+        }
+    }
+
+    void swap(_Self& __list) noexcept
+    {
+        object.swap(__list.object);
+        values.swap(__list.values);
+        before.swap(__list.before);
+        for (_Self* __l : {this, &__list})
+        {
+            if(node_base* __first = __l->object.begin())
+            {
+                __l->before.find(__first)->second = __l->object.before_begin();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,672 @@
+/**
+ *  @brief A fixed-capacity singly linked %list that never touches the heap.
+ *
+ *  @tparam _Tp  Type of element.
+ *  @tparam _Np  Maximum number of elements.
+ *
+ *  All nodes live in an array inside the object itself and are linked
+ *  with the smallest unsigned type able to index @a _Np slots.  Released
+ *  slots are kept on a free list, so every insertion and removal takes
+ *  constant time.  When the %list is full, insertions report failure
+ *  instead of allocating: push_back() and push_front() return false and
+ *  insert_after() returns end().
+ *
+ *  Splicing within one %list only relinks nodes.  Splicing from another
+ *  %inplace_forward_list moves the elements into this one's array, since
+ *  the nodes belong to the other object.
+ *
+ *  @file inplace_forward_list.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef INPLACE_FORWARD_LIST_H
+#define INPLACE_FORWARD_LIST_H
+
+template <typename _Tp, std::size_t _Np>
+class mfpkg::inplace_forward_list
+{
+    static_assert(_Np > 0 && _Np < 0xfffffffeu, "inplace_forward_list capacity out of range");
+
+public:
+
+    typedef typename std::conditional<(_Np < 0xff), std::uint8_t,
+            typename std::conditional<(_Np < 0xffff), std::uint16_t,
+                                      std::uint32_t>::type>::type index_type;
+
+private:
+
+    typedef inplace_forward_list<_Tp, _Np> _Self;
+
+    friend struct basic_mfpkg::index_chain;
+
+    /* Index zero is the null link and _Np + 1 the list head. */
+    static constexpr index_type head = _Np + 1;
+
+    index_type links[_Np + 2];
+    alignas(_Tp) unsigned char storage[_Np][sizeof(_Tp)];
+    index_type finish;
+    index_type count;
+    index_type free_head;
+    index_type fresh;
+
+    index_type& link(index_type __i) noexcept
+    {
+        return links[__i];
+    }
+
+    index_type link(index_type __i) const noexcept
+    {
+        return links[__i];
+    }
+
+    _Tp& value(index_type __i) noexcept
+    {
+        return *std::launder(reinterpret_cast<_Tp*>(storage[__i - 1]));
+    }
+
+    const _Tp& value(index_type __i) const noexcept
+    {
+        return *std::launder(reinterpret_cast<const _Tp*>(storage[__i - 1]));
+    }
+
+    index_type allocate(void) noexcept
+    {
+        index_type __i = free_head;
+        if(__i)
+        {
+            free_head = links[__i];
+        }
+        else if(fresh <= _Np)
+        {
+            __i = fresh++;
+        }
+        return __i;
+    }
+
+    void deallocate(index_type __i) noexcept
+    {
+        links[__i] = free_head;
+        free_head = __i;
+    }
+
+    template <typename _Arg>
+    index_type link_after(index_type __pos, _Arg&& __val)
+    {
+        index_type __node = allocate();
+        if(!__node)
+        {
+            return 0;
+        }
+        try
+        {
+            ::new (static_cast<void*>(storage[__node - 1])) _Tp(std::forward<_Arg>(__val));
+        }
+        catch (...)
+        {
+            deallocate(__node);
+            throw;
+        }
+        links[__node] = links[__pos];
+        links[__pos] = __node;
+        if(__pos == finish)
+        {
+            finish = __node;
+        }
+        ++count;
+        return __node;
+    }
+
+    void unlink_after(index_type __pos) noexcept
+    {
+        index_type __node = links[__pos];
+        links[__pos] = links[__node];
+        if(__node == finish)
+        {
+            finish = __pos;
+        }
+        value(__node).~_Tp();
+        deallocate(__node);
+        --count;
+    }
+
+    void reset(void) noexcept
+    {
+        links[head] = 0;
+        finish = head;
+        count = 0;
+        free_head = 0;
+        fresh = 1;
+    }
+
+public:
+
+    typedef _Tp value_type;
+    typedef _Tp& reference;
+    typedef const _Tp& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    struct iterator
+    {
+        typedef iterator _Self;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef _Tp& reference;
+        typedef _Tp* pointer;
+
+        inplace_forward_list* _M_list;
+        index_type _M_node;
+
+        iterator() noexcept : _M_list(nullptr), _M_node(0) {}
+
+        iterator(inplace_forward_list* __l, index_type __n) noexcept : _M_list(__l), _M_node(__n) {}
+
+        reference operator*() const noexcept
+        {
+            return _M_list->value(_M_node);
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &_M_list->value(_M_node);
+        }
+
+        _Self& operator++() noexcept
+        {
+            _M_node = _M_list->links[_M_node];
+            return *this;
+        }
+
+        _Self operator++(int) noexcept
+        {
+            _Self __tmp(*this);
+            _M_node = _M_list->links[_M_node];
+            return __tmp;
+        }
+
+        friend bool operator==(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node == __y._M_node;
+        }
+
+        friend bool operator!=(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node != __y._M_node;
+        }
+    };
+
+    struct const_iterator
+    {
+        typedef const_iterator _Self;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const _Tp& reference;
+        typedef const _Tp* pointer;
+
+        const inplace_forward_list* _M_list;
+        index_type _M_node;
+
+        const_iterator() noexcept : _M_list(nullptr), _M_node(0) {}
+
+        const_iterator(const inplace_forward_list* __l, index_type __n) noexcept
+        : _M_list(__l), _M_node(__n) {}
+
+        const_iterator(const iterator& __it) noexcept : _M_list(__it._M_list), _M_node(__it._M_node) {}
+
+        reference operator*() const noexcept
+        {
+            return _M_list->value(_M_node);
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &_M_list->value(_M_node);
+        }
+
+        _Self& operator++() noexcept
+        {
+            _M_node = _M_list->links[_M_node];
+            return *this;
+        }
+
+        _Self operator++(int) noexcept
+        {
+            _Self __tmp(*this);
+            _M_node = _M_list->links[_M_node];
+            return __tmp;
+        }
+
+        friend bool operator==(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node == __y._M_node;
+        }
+
+        friend bool operator!=(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node != __y._M_node;
+        }
+    };
+
+    inplace_forward_list() noexcept
+    {
+        reset();
+    }
+
+    /**
+     * @brief Builds a %list from the leading elements of @a __list.
+     *
+     * At most @a _Np elements are taken; any beyond the capacity are
+     * dropped, in keeping with the other insertions that fail rather than
+     * allocate.  Compare size() with @a __list.size() to detect it.
+     */
+    inplace_forward_list(std::initializer_list<_Tp> __list) : inplace_forward_list()
+    {
+        for (auto& __x : __list)
+        {
+            if(!link_after(finish, __x))
+            {
+                break;
+            }
+        }
+    }
+
+    inplace_forward_list(const _Self& __list) : inplace_forward_list()
+    {
+        for (auto& __x : __list)
+        {
+            link_after(finish, __x);
+        }
+    }
+
+    inplace_forward_list(_Self&& __list) : inplace_forward_list()
+    {
+        for (auto& __x : __list)
+        {
+            link_after(finish, std::move(__x));
+        }
+        __list.clear();
+    }
+
+    ~inplace_forward_list() noexcept
+    {
+        clear();
+    }
+
+    _Self& operator=(const _Self& __list)
+    {
+        if(this != &__list)
+        {
+            clear();
+            for (auto& __x : __list)
+            {
+                link_after(finish, __x);
+            }
+        }
+        return *this;
+    }
+
+    _Self& operator=(_Self&& __list)
+    {
+        if(this != &__list)
+        {
+            clear();
+            for (auto& __x : __list)
+            {
+                link_after(finish, std::move(__x));
+            }
+            __list.clear();
+        }
+        return *this;
+    }
+
+    iterator before_begin(void) noexcept
+    {
+        return iterator(this, head);
+    }
+
+    const_iterator before_begin(void) const noexcept
+    {
+        return const_iterator(this, head);
+    }
+
+    iterator begin(void) noexcept
+    {
+        return iterator(this, links[head]);
+    }
+
+    const_iterator begin(void) const noexcept
+    {
+        return const_iterator(this, links[head]);
+    }
+
+    /**
+     * Returns an iterator to the last element, or before_begin() when empty.
+     */
+    iterator rbegin(void) noexcept
+    {
+        return iterator(this, finish);
+    }
+
+    const_iterator rbegin(void) const noexcept
+    {
+        return const_iterator(this, finish);
+    }
+
+    iterator end(void) noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    const_iterator end(void) const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    reference front(void) noexcept
+    {
+        return value(links[head]);
+    }
+
+    const_reference front(void) const noexcept
+    {
+        return value(links[head]);
+    }
+
+    reference back(void) noexcept
+    {
+        return value(finish);
+    }
+
+    const_reference back(void) const noexcept
+    {
+        return value(finish);
+    }
+
+    /**
+     * @brief  Appends a copy of @a __val.
+     * @return false if the %list is full.
+     */
+    bool push_back(const _Tp& __val)
+    {
+        return link_after(finish, __val) != 0;
+    }
+
+    bool push_back(_Tp&& __val)
+    {
+        return link_after(finish, std::move(__val)) != 0;
+    }
+
+    /**
+     * @brief  Prepends a copy of @a __val.
+     * @return false if the %list is full.
+     */
+    bool push_front(const _Tp& __val)
+    {
+        return link_after(head, __val) != 0;
+    }
+
+    bool push_front(_Tp&& __val)
+    {
+        return link_after(head, std::move(__val)) != 0;
+    }
+
+    void pop_front(void) noexcept
+    {
+        if(links[head])
+        {
+            unlink_after(head);
+        }
+    }
+
+    /**
+     * @brief  Removes last element.  Linear in size().
+     */
+    void pop_back(void) noexcept
+    {
+        if(links[head])
+        {
+            index_type __it = head;
+            for (; links[__it] != finish; __it = links[__it]);
+            unlink_after(__it);
+        }
+    }
+
+    /**
+     * @brief Inserts a copy of @a __val after @a __position.
+     * @return  An iterator to the new element, or end() if the %list is full.
+     */
+    iterator insert_after(const iterator& __position, const _Tp& __val)
+    {
+        index_type __n = link_after(__position._M_node, __val);
+        return __n ? iterator(this, __n) : end();
+    }
+
+    iterator insert_after(const iterator& __position, _Tp&& __val)
+    {
+        index_type __n = link_after(__position._M_node, std::move(__val));
+        return __n ? iterator(this, __n) : end();
+    }
+
+    /**
+     * @brief Removes the element following @a __position.
+     * @return  An iterator to the element after the erased one, or end().
+     */
+    iterator erase_after(const iterator& __position) noexcept
+    {
+        index_type __pos = __position._M_node;
+        if(!__pos || !links[__pos])
+        {
+            return end();
+        }
+        unlink_after(__pos);
+        return links[__pos] ? iterator(this, links[__pos]) : end();
+    }
+
+    /**
+     * @brief Removes the elements in the range (__before, __last).
+     */
+    iterator erase_after(const iterator& __before, const iterator& __last) noexcept
+    {
+        while (__before._M_node && links[__before._M_node] != __last._M_node)
+        {
+            unlink_after(__before._M_node);
+        }
+        return __last;
+    }
+
+    /**
+     * @brief Moves the elements in (__before, __last) of @a __list after @a __position.
+     * @return false if this %list ran out of room, in which case the elements
+     *         that did not fit stay in @a __list.
+     *
+     * Within one %list the range is relinked in constant time plus its
+     * length.  From another %list the elements are moved one by one.
+     */
+    bool splice_after(const iterator& __position, _Self& __list,
+                      const iterator& __before, const iterator& __last)
+    {
+        index_type __b = __before._M_node;
+        index_type __l = __last._M_node;
+        if(__list.links[__b] == __l)
+        {
+            return true;
+        }
+        if(&__list != this)
+        {
+            index_type __pos = __position._M_node;
+            for (index_type __it = __list.links[__b]; __it != __l; __it = __list.links[__b])
+            {
+                __pos = link_after(__pos, std::move(__list.value(__it)));
+                if(!__pos)
+                {
+                    return false;
+                }
+                __list.unlink_after(__b);
+            }
+            return true;
+        }
+        index_type __pos = __position._M_node;
+        if(__pos == __b)
+        {
+            return true;
+        }
+        index_type __first = links[__b];
+        index_type __tail = __first;
+        for (; links[__tail] != __l; __tail = links[__tail]);
+        links[__b] = __l;
+        if(__tail == finish)
+        {
+            finish = __b;
+        }
+        links[__tail] = links[__pos];
+        links[__pos] = __first;
+        if(__pos == finish)
+        {
+            finish = __tail;
+        }
+        return true;
+    }
+
+    bool splice_after(const iterator& __position, _Self& __list)
+    {
+        return splice_after(__position, __list, __list.before_begin(), __list.end());
+    }
+
+    bool splice_after(const iterator& __position, _Self& __list, const iterator& __i)
+    {
+        index_type __next = __list.links[__i._M_node];
+        return splice_after(__position, __list, __i,
+                            __next ? iterator(&__list, __list.links[__next]) : __list.end());
+    }
+
+    bool empty(void) const noexcept
+    {
+        return links[head] == 0;
+    }
+
+    bool full(void) const noexcept
+    {
+        return count == _Np;
+    }
+
+    std::size_t size(void) const noexcept
+    {
+        return count;
+    }
+
+    static constexpr std::size_t capacity(void) noexcept
+    {
+        return _Np;
+    }
+
+    /**
+     * @brief Sorts the %list.  Equivalent elements remain in list order.
+     */
+    void sort(void)
+    {
+        finish = basic_mfpkg::index_chain::sort(*this, head);
+    }
+
+    void reverse(void) noexcept
+    {
+        finish = basic_mfpkg::index_chain::reverse(*this, head);
+    }
+
+    void remove(const _Tp& __val) noexcept
+    {
+        for (index_type __it = head; links[__it]; )
+        {
+            if(value(links[__it]) == __val)
+            {
+                unlink_after(__it);
+            }
+            else
+            {
+                __it = links[__it];
+            }
+        }
+    }
+
+    void remove_if(bool (*__pred)(const _Tp& __val)) noexcept
+    {
+        for (index_type __it = head; links[__it]; )
+        {
+            if(__pred(value(links[__it])))
+            {
+                unlink_after(__it);
+            }
+            else
+            {
+                __it = links[__it];
+            }
+        }
+    }
+
+    void unique(void) noexcept
+    {
+        for (index_type __it = links[head]; __it && links[__it]; )
+        {
+            if(value(__it) == value(links[__it]))
+            {
+                unlink_after(__it);
+            }
+            else
+            {
+                __it = links[__it];
+            }
+        }
+    }
+
+    /**
+     * @brief Resizes the %list, filling new slots with @a __val.
+     * @return false if @a __n exceeds the capacity; the %list is then
+     *         extended as far as it goes.
+     *
+     * Shrinking walks to the @a __n th element once and drops the rest.
+     */
+    bool resize(std::size_t __n, const _Tp& __val = _Tp())
+    {
+        if(count > __n)
+        {
+            index_type __it = head;
+            for (std::size_t __i = 0; __i < __n; ++__i, __it = links[__it]);
+            while (links[__it])
+            {
+                unlink_after(__it);
+            }
+            return true;
+        }
+        while (count < __n)
+        {
+            if(!link_after(finish, __val))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void clear(void) noexcept
+    {
+        for (index_type __it = links[head]; __it; __it = links[__it])
+        {
+            value(__it).~_Tp();
+        }
+        reset();
+    }
+
+    /**
+     * @brief Exchanges the elements of two lists.  Linear in their sizes.
+     */
+    void swap(_Self& __list)
+    {
+        _Self __tmp(std::move(__list));
+        __list = std::move(*this);
+        *this = std::move(__tmp);
+    }
+};
+
+#endif
@@ -0,0 +1,313 @@
+/**
+ * @file instrumentation.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+/**
+ *  Operations of a mfpkg::forward_list that instrumentation tells apart.
+ *  remove_if() is accounted as remove, and the splice_after() overloads,
+ *  move construction and move assignment as splice_after.
+ */
+enum class mfpkg::list_op : unsigned
+{
+    push_front,
+    push_back,
+    pop_front,
+    pop_back,
+    insert_after,
+    erase_after,
+    splice_after,
+    remove,
+    unique,
+    sort,
+    reverse,
+    resize,
+    assign,
+    clear,
+    swap,
+    defragment
+};
+
+/**
+ *  @brief A log-linear histogram of latencies in nanoseconds.
+ *
+ *  Values below 16 are kept exactly; above that every power of two is
+ *  split into 8 buckets, so a reported value is within 12.5% of the
+ *  recorded one, in the manner of an HDR histogram.  Values of 2^40 ns
+ *  (about 18 minutes) and more share the last bucket.
+ */
+class mfpkg::latency_histogram
+{
+public:
+
+    static constexpr unsigned sub_bits = 3;
+    static constexpr unsigned range_bits = 40;
+
+private:
+
+    static constexpr std::uint64_t sub_count = std::uint64_t(1) << sub_bits;
+    static constexpr std::size_t buckets = (range_bits - sub_bits + 1) * sub_count;
+
+    std::uint64_t counts[buckets] = {};
+    std::uint64_t total = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t low = ~std::uint64_t(0);
+    std::uint64_t high = 0;
+
+    static std::size_t bucket_of(std::uint64_t __ns) noexcept
+    {
+        if(__ns < 2 * sub_count)
+        {
+            return std::size_t(__ns);
+        }
+        const unsigned __shift = 63 - __builtin_clzll(__ns) - sub_bits;
+        const std::size_t __b = __shift * sub_count + (__ns >> __shift);
+        return std::min(__b, buckets - 1);
+    }
+
+    static std::uint64_t highest_of(std::size_t __b) noexcept
+    {
+        if(__b < 2 * sub_count)
+        {
+            return __b;
+        }
+        const unsigned __shift = unsigned(__b / sub_count) - 1;
+        const std::uint64_t __top = __b % sub_count + sub_count;
+        return ((__top + 1) << __shift) - 1;
+    }
+
+public:
+
+    void record(std::uint64_t __ns) noexcept
+    {
+        ++counts[bucket_of(__ns)];
+        ++total;
+        sum += __ns;
+        low = std::min(low, __ns);
+        high = std::max(high, __ns);
+    }
+
+    std::uint64_t count(void) const noexcept
+    {
+        return total;
+    }
+
+    std::uint64_t min(void) const noexcept
+    {
+        return total ? low : 0;
+    }
+
+    std::uint64_t max(void) const noexcept
+    {
+        return high;
+    }
+
+    double mean(void) const noexcept
+    {
+        return total ? double(sum) / double(total) : 0.0;
+    }
+
+    /**
+     * @brief Returns the value below which @a __p percent of the
+     * recorded values fall, e.g. percentile(99.9).
+     */
+    std::uint64_t percentile(double __p) const noexcept
+    {
+        if(!total)
+        {
+            return 0;
+        }
+        std::uint64_t __rank = std::uint64_t(__p / 100.0 * double(total) + 0.5);
+        __rank = std::min(std::max<std::uint64_t>(__rank, 1), total);
+        std::uint64_t __seen = 0;
+        for (std::size_t __b = 0; __b < buckets; ++__b)
+        {
+            __seen += counts[__b];
+            if(__seen >= __rank)
+            {
+                return std::min(highest_of(__b), high);
+            }
+        }
+        return high;
+    }
+};
+
+/**
+ *  Counters kept by an instrumented %forward_list.  Nodes moved in by
+ *  splice_after(), swap(), move construction or move assignment are
+ *  neither allocated nor freed by the receiving %list.
+ */
+struct mfpkg::list_stats
+{
+    static constexpr std::size_t ops = std::size_t(list_op::defragment) + 1;
+
+    std::uint64_t allocations = 0;
+    std::uint64_t frees = 0;
+    std::uint64_t erasures = 0;
+    std::uint64_t splices = 0;
+    std::uint64_t high_water = 0;
+    std::uint64_t calls[ops] = {};
+    std::uint64_t traversed[ops] = {};
+
+    static const char* name(list_op __op) noexcept
+    {
+        static const char* const __names[ops] =
+        {
+            "push_front", "push_back", "pop_front", "pop_back", "insert_after",
+            "erase_after", "splice_after", "remove", "unique", "sort", "reverse",
+            "resize", "assign", "clear", "swap", "defragment"
+        };
+        return __names[std::size_t(__op)];
+    }
+
+    /**
+     * Accounts for one call of @a __op that took the %list from @a __before
+     * to @a __after elements, creating or destroying the difference, and
+     * followed @a __walked links.
+     */
+    void record(list_op __op, std::size_t __before, std::size_t __after,
+                std::size_t __walked) noexcept
+    {
+        ++calls[std::size_t(__op)];
+        traversed[std::size_t(__op)] += __walked;
+        if(__after > __before)
+        {
+            allocations += __after - __before;
+        }
+        else
+        {
+            frees += __before - __after;
+            erasures += __before - __after;
+        }
+        high_water = std::max<std::uint64_t>(high_water, __after);
+    }
+
+    /**
+     * Accounts for one call of @a __op that relinked existing nodes and
+     * left the %list with @a __after elements.
+     */
+    void relinked(list_op __op, std::size_t __after) noexcept
+    {
+        ++calls[std::size_t(__op)];
+        splices += __op == list_op::splice_after;
+        high_water = std::max<std::uint64_t>(high_water, __after);
+    }
+
+    void dump(std::ostream& __out) const
+    {
+        __out << "allocations " << allocations << '\n'
+              << "frees " << frees << '\n'
+              << "erasures " << erasures << '\n'
+              << "splices " << splices << '\n'
+              << "high_water " << high_water << '\n';
+        for (std::size_t __i = 0; __i < ops; ++__i)
+        {
+            if(calls[__i])
+            {
+                __out << name(list_op(__i)) << " calls " << calls[__i]
+                      << " traversed " << traversed[__i] << '\n';
+            }
+        }
+    }
+};
+
+/**
+ *  Counters plus a latency_histogram per operation.  The histograms take
+ *  about 2.5 KiB each.
+ */
+struct mfpkg::timed_list_stats : mfpkg::list_stats
+{
+    latency_histogram latency[ops];
+
+    void dump(std::ostream& __out) const
+    {
+        list_stats::dump(__out);
+        for (std::size_t __i = 0; __i < ops; ++__i)
+        {
+            const latency_histogram& __h = latency[__i];
+            if(__h.count())
+            {
+                __out << name(list_op(__i)) << " ns"
+                      << " min " << __h.min()
+                      << " mean " << __h.mean()
+                      << " p50 " << __h.percentile(50)
+                      << " p90 " << __h.percentile(90)
+                      << " p99 " << __h.percentile(99)
+                      << " p99.9 " << __h.percentile(99.9)
+                      << " max " << __h.max() << '\n';
+            }
+        }
+    }
+};
+
+/**
+ *  @brief The default policy of mfpkg::forward_list; records nothing
+ *  and adds neither storage nor code.
+ *
+ *  A policy declares whether it is @c enabled, whether it is @c timed,
+ *  and the @c stats_type the %list keeps, which must provide the
+ *  record() and relinked() members of list_stats when enabled and a
+ *  latency array of latency_histogram when timed.  It also declares
+ *  whether the %list header keeps a tail link (@c has_tail) and a size
+ *  counter (@c has_size); see mfpkg::layout.
+ */
+struct mfpkg::no_instrumentation
+{
+    static constexpr bool enabled = false;
+    static constexpr bool timed = false;
+    static constexpr bool has_tail = true;
+    static constexpr bool has_size = true;
+
+    struct stats_type { };
+};
+
+/**
+ *  @brief Policy that makes a mfpkg::forward_list count its node
+ *  allocations, frees, erasures, splices, traversal steps and size
+ *  high-water mark, and with @a _Latency also time every operation.
+ *
+ *  @code
+ *      mfpkg::forward_list<int, mfpkg::instrumented<true>> __l;
+ *      ...
+ *      __l.stats().latency[std::size_t(mfpkg::list_op::sort)].percentile(99);
+ *      __l.dump_stats("list.stats");
+ *  @endcode
+ */
+template <bool _Latency>
+struct mfpkg::instrumented
+{
+    static constexpr bool enabled = true;
+    static constexpr bool timed = _Latency;
+    static constexpr bool has_tail = true;
+    static constexpr bool has_size = true;
+
+    typedef std::conditional_t<_Latency, timed_list_stats, list_stats> stats_type;
+};
+
+/**
+ *  @brief Policy that trims the header of a mfpkg::forward_list, which
+ *  otherwise holds a start link, a tail link and a size counter.
+ *
+ *  Without the tail link push_back() is unavailable, and back(),
+ *  rbegin() and splicing a whole %list walk to the last node.  Without
+ *  the size counter size() counts the elements.  With neither, the
+ *  header is a single pointer, as for a bucket or adjacency head.
+ *  The other members of @a _Base are kept; instrumentation requires
+ *  the size counter.
+ *
+ *  @code
+ *      std::vector<mfpkg::forward_list<int, mfpkg::layout<false, false>>> __buckets;
+ *  @endcode
+ */
+template <bool _Tail, bool _Size, typename _Base>
+struct mfpkg::layout : _Base
+{
+    static constexpr bool has_tail = _Tail;
+    static constexpr bool has_size = _Size;
+};
+
+#endif
@@ -0,0 +1,202 @@
+/**
+ *  @brief Interleaved traversal of many short lists.
+ *
+ *  Walking one %list is a chain of dependent loads: the address of the
+ *  next node is only known once the current one has arrived from memory.
+ *  When many lists are walked back to back, such as hash buckets or
+ *  adjacency lists, these algorithms keep a group of @a __width cursors
+ *  in different lists and advance them in round-robin order.  The next
+ *  node of each cursor is prefetched as soon as its address is known and
+ *  only dereferenced once the other cursors have had their turn, so up
+ *  to @a __width cache misses are in flight at once.
+ *
+ *  @a __lists is any range of lists, or of pointers to lists.  The
+ *  function objects take either an element, or the index of its %list
+ *  in @a __lists followed by the element.  A @a __width of zero means
+ *  default_width.  The lists must not be modified during the traversal.
+ *
+ *  @file interleaved.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef INTERLEAVED_H
+#define INTERLEAVED_H
+
+namespace basic_mfpkg
+{
+    /**
+     * Hints that @a __p will soon be read.
+     */
+    inline void prefetch(const void* __p) noexcept
+    {
+#if defined(__GNUC__)
+        __builtin_prefetch(__p, 0, 3);
+#else
+        (void)__p;
+#endif
+    }
+
+    struct interleave
+    {
+        static constexpr std::size_t default_width = 16;
+        static constexpr std::size_t max_width = 64;
+
+        template <typename _Ref>
+        static decltype(auto) list_of(_Ref& __r) noexcept
+        {
+            if constexpr (std::is_pointer<std::remove_cv_t<_Ref>>::value)
+            {
+                return *__r;
+            }
+            else
+            {
+                return (__r);
+            }
+        }
+
+        template <typename _Lists>
+        using iterator_t = decltype(list_of(*std::begin(std::declval<_Lists&>())).begin());
+
+        /**
+         * Calls @a __f with the element, and the %list index first when
+         * @a __f accepts it.
+         */
+        template <typename _Function, typename _Iter>
+        static decltype(auto) call(_Function& __f, std::size_t __list, const _Iter& __it)
+        {
+            if constexpr (std::is_invocable<_Function&, std::size_t, decltype(*__it)>::value)
+            {
+                return __f(__list, *__it);
+            }
+            else
+            {
+                return __f(*__it);
+            }
+        }
+
+        /**
+         * Walks every %list in @a __lists, @a __width at a time, calling
+         * @a __visit(list_index, iterator) on each element.  A %list is
+         * left as soon as @a __visit returns true.
+         */
+        template <typename _Lists, typename _Visit>
+        static void walk(_Lists& __lists, std::size_t __width, _Visit __visit)
+        {
+            typedef iterator_t<_Lists> _Iter;
+
+            struct cursor
+            {
+                _Iter it;
+                std::size_t list;
+            };
+
+            cursor __slots[max_width];
+            const std::size_t __w = std::min(__width ? __width : default_width, max_width);
+            auto __next = std::begin(__lists);
+            auto __last = std::end(__lists);
+            std::size_t __index = 0;
+
+            auto __refill = [&](cursor& __c)
+            {
+                for (; __next != __last; ++__next, ++__index)
+                {
+                    _Iter __it = list_of(*__next).begin();
+                    if(__it._M_node)
+                    {
+                        prefetch(__it._M_node);
+                        __c.it = __it;
+                        __c.list = __index;
+                        ++__next;
+                        ++__index;
+                        return true;
+                    }
+                }
+                return false;
+            };
+
+            std::size_t __active = 0;
+            while (__active < __w && __refill(__slots[__active]))
+            {
+                ++__active;
+            }
+            while (__active)
+            {
+                for (std::size_t __s = 0; __s < __active; )
+                {
+                    cursor& __c = __slots[__s];
+                    auto __link = __c.it._M_node->link;
+                    if(__link)
+                    {
+                        prefetch(__link);
+                    }
+                    if(__visit(__c.list, __c.it) || !__link)
+                    {
+                        if(!__refill(__c))
+                        {
+                            __c = __slots[--__active];
+                            continue;
+                        }
+                    }
+                    else
+                    {
+                        __c.it = _Iter(__link);
+                    }
+                    ++__s;
+                }
+            }
+        }
+    };
+};
+
+namespace mfpkg
+{
+    /**
+     * @brief Applies @a __f to every element of every %list in @a __lists,
+     * walking @a __width lists at a time.
+     *
+     * The elements of one %list are visited in order; elements of
+     * different lists are interleaved.
+     */
+    template <typename _Lists, typename _Function>
+    void for_each_interleaved(_Lists&& __lists, _Function __f, std::size_t __width = 0)
+    {
+        typedef basic_mfpkg::interleave _Walk;
+        _Walk::walk(__lists, __width, [&](std::size_t __list, const auto& __it)
+        {
+            _Walk::call(__f, __list, __it);
+            return false;
+        });
+    }
+
+    /**
+     * @brief Finds the first element satisfying @a __pred in each %list
+     * of @a __lists, walking @a __width lists at a time.
+     * @return  One iterator per %list in @a __lists, to its first match
+     *          or end() if it has none.
+     *
+     * A %list stops being walked at its first match.  With a predicate
+     * taking the %list index, each %list can be searched for its own
+     * key, as in a batch of hash table lookups.
+     */
+    template <typename _Lists, typename _Predicate>
+    std::vector<basic_mfpkg::interleave::iterator_t<_Lists>>
+    find_if_interleaved(_Lists&& __lists, _Predicate __pred, std::size_t __width = 0)
+    {
+        typedef basic_mfpkg::interleave _Walk;
+        std::vector<_Walk::iterator_t<_Lists>> __found(
+            std::size_t(std::distance(std::begin(__lists), std::end(__lists))));
+        _Walk::walk(__lists, __width, [&](std::size_t __list, const auto& __it)
+        {
+            if(_Walk::call(__pred, __list, __it))
+            {
+                __found[__list] = __it;
+                return true;
+            }
+            return false;
+        });
+        return __found;
+    }
+};
+
+#endif
@@ -0,0 +1,599 @@
+/**
+ *  @brief A singly linked %list living in a memory-mapped file.
+ *
+ *  @tparam _Tp  Type of element, trivially copyable.
+ *
+ *  The nodes of a %mapped_forward_list are kept in a file mapped with
+ *  MAP_SHARED and link to each other with offsets from the start of the
+ *  mapping, so the file stays valid wherever it is mapped.  The head link,
+ *  the last node, the size and the free list are persisted in a header at
+ *  the start of the file, so reopening a %list of any length costs one
+ *  mmap() and no traversal.
+ *
+ *  Modifications reach the file through the page cache; sync() is the
+ *  durability point.  A crash between two sync() calls may leave the
+ *  %list in any state reached since the last one.
+ *
+ *  Elements are stored byte-wise, so they must not hold pointers that
+ *  are expected to stay meaningful across runs.
+ *
+ *  @file mapped_forward_list.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef MAPPED_FORWARD_LIST_H
+#define MAPPED_FORWARD_LIST_H
+
+template <typename _Tp>
+class mfpkg::mapped_forward_list
+{
+    static_assert(std::is_trivially_copyable<_Tp>::value,
+                  "mapped_forward_list requires a trivially copyable type");
+
+    friend struct basic_mfpkg::index_chain;
+
+private:
+
+    typedef mapped_forward_list<_Tp> _Self;
+    typedef std::uint64_t offset_type;
+
+    struct node
+    {
+        offset_type link;
+        _Tp storage;
+    };
+
+    static_assert(alignof(node) <= 64, "mapped_forward_list element is over-aligned");
+
+    struct header
+    {
+        char magic[8];
+        offset_type start;
+        offset_type finish;
+        offset_type count;
+        offset_type free_head;
+        offset_type bump;
+        offset_type value_size;
+        offset_type node_align;
+    };
+
+    static constexpr char magic[8] = {'M', 'F', 'P', 'K', 'G', 'M', 'L', 1};
+
+    /**
+     * The link of the head slot is header::start, so the head is
+     * addressed like any node.
+     */
+    static constexpr offset_type head = offsetof(header, start);
+    static constexpr offset_type first_node =
+        (sizeof(header) + alignof(node) - 1) / alignof(node) * alignof(node);
+
+    int fd;
+    char* base;
+    std::size_t length;
+
+    header& meta(void) noexcept
+    {
+        return *reinterpret_cast<header*>(base);
+    }
+
+    const header& meta(void) const noexcept
+    {
+        return *reinterpret_cast<const header*>(base);
+    }
+
+    offset_type& link(offset_type __i) noexcept
+    {
+        return *reinterpret_cast<offset_type*>(base + __i);
+    }
+
+    offset_type link(offset_type __i) const noexcept
+    {
+        return *reinterpret_cast<const offset_type*>(base + __i);
+    }
+
+    _Tp& value(offset_type __i) noexcept
+    {
+        return reinterpret_cast<node*>(base + __i)->storage;
+    }
+
+    const _Tp& value(offset_type __i) const noexcept
+    {
+        return reinterpret_cast<const node*>(base + __i)->storage;
+    }
+
+    [[noreturn]] static void fail(const char* __what)
+    {
+        throw std::system_error(errno, std::generic_category(), __what);
+    }
+
+    static std::size_t page_size(void) noexcept
+    {
+        long __size = ::sysconf(_SC_PAGESIZE);
+        return __size > 0 ? std::size_t(__size) : 4096;
+    }
+
+    static std::size_t round_to_pages(std::size_t __bytes) noexcept
+    {
+        const std::size_t __page = page_size();
+        return (__bytes + __page - 1) / __page * __page;
+    }
+
+    /**
+     * Extends the file and the mapping to at least @a __bytes.  The
+     * mapping may move; offsets stay valid.
+     */
+    void grow(std::size_t __bytes)
+    {
+        std::size_t __length = round_to_pages(std::max(__bytes, 2 * length));
+        if(::ftruncate(fd, off_t(__length)) < 0)
+        {
+            fail("mfpkg::mapped_forward_list: cannot extend file");
+        }
+        void* __p = ::mremap(base, length, __length, MREMAP_MAYMOVE);
+        if(__p == MAP_FAILED)
+        {
+            fail("mfpkg::mapped_forward_list: cannot extend mapping");
+        }
+        base = static_cast<char*>(__p);
+        length = __length;
+    }
+
+    /**
+     * @a __val may live in the mapping, so it is copied out before the
+     * mapping can move.
+     */
+    offset_type get_node(const _Tp& __val)
+    {
+        unsigned char __copy[sizeof(_Tp)];
+        std::memcpy(__copy, std::addressof(__val), sizeof(_Tp));
+        header& __h = meta();
+        offset_type __node = __h.free_head;
+        if(__node)
+        {
+            __h.free_head = link(__node);
+        }
+        else
+        {
+            if(__h.bump + sizeof(node) > length)
+            {
+                grow(__h.bump + sizeof(node));
+            }
+            __node = meta().bump;
+            meta().bump += sizeof(node);
+        }
+        std::memcpy(static_cast<void*>(&value(__node)), __copy, sizeof(_Tp));
+        return __node;
+    }
+
+    void put_node(offset_type __node) noexcept
+    {
+        link(__node) = meta().free_head;
+        meta().free_head = __node;
+    }
+
+    offset_type link_after(offset_type __pos, const _Tp& __val)
+    {
+        offset_type __node = get_node(__val);
+        header& __h = meta();
+        link(__node) = link(__pos);
+        link(__pos) = __node;
+        if(__pos == __h.finish)
+        {
+            __h.finish = __node;
+        }
+        ++__h.count;
+        return __node;
+    }
+
+    void format(void)
+    {
+        length = round_to_pages(std::max<std::size_t>(length, first_node + sizeof(node)));
+        if(::ftruncate(fd, off_t(length)) < 0)
+        {
+            fail("mfpkg::mapped_forward_list: cannot size file");
+        }
+    }
+
+    void validate(void)
+    {
+        const header& __h = meta();
+        if(std::memcmp(__h.magic, magic, sizeof magic))
+        {
+            errno = EINVAL;
+            fail("mfpkg::mapped_forward_list: not a mapped list");
+        }
+        if(__h.value_size != sizeof(_Tp) || __h.node_align != alignof(node)
+           || __h.bump > length || __h.finish >= __h.bump)
+        {
+            errno = EINVAL;
+            fail("mfpkg::mapped_forward_list: element type mismatch or corrupt header");
+        }
+    }
+
+public:
+
+    typedef _Tp value_type;
+    typedef _Tp& reference;
+    typedef const _Tp& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    struct iterator
+    {
+        typedef iterator _Self;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef _Tp& reference;
+        typedef _Tp* pointer;
+
+        mapped_forward_list* _M_list;
+        offset_type _M_node;
+
+        iterator() noexcept : _M_list(nullptr), _M_node(0) {}
+
+        iterator(mapped_forward_list* __l, offset_type __n) noexcept : _M_list(__l), _M_node(__n) {}
+
+        reference operator*() const noexcept
+        {
+            return _M_list->value(_M_node);
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &_M_list->value(_M_node);
+        }
+
+        _Self& operator++() noexcept
+        {
+            _M_node = _M_list->link(_M_node);
+            return *this;
+        }
+
+        _Self operator++(int) noexcept
+        {
+            _Self __tmp(*this);
+            _M_node = _M_list->link(_M_node);
+            return __tmp;
+        }
+
+        friend bool operator==(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node == __y._M_node;
+        }
+
+        friend bool operator!=(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node != __y._M_node;
+        }
+    };
+
+    struct const_iterator
+    {
+        typedef const_iterator _Self;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const _Tp& reference;
+        typedef const _Tp* pointer;
+
+        const mapped_forward_list* _M_list;
+        offset_type _M_node;
+
+        const_iterator() noexcept : _M_list(nullptr), _M_node(0) {}
+
+        const_iterator(const mapped_forward_list* __l, offset_type __n) noexcept
+        : _M_list(__l), _M_node(__n) {}
+
+        const_iterator(const iterator& __it) noexcept : _M_list(__it._M_list), _M_node(__it._M_node) {}
+
+        reference operator*() const noexcept
+        {
+            return _M_list->value(_M_node);
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &_M_list->value(_M_node);
+        }
+
+        _Self& operator++() noexcept
+        {
+            _M_node = _M_list->link(_M_node);
+            return *this;
+        }
+
+        _Self operator++(int) noexcept
+        {
+            _Self __tmp(*this);
+            _M_node = _M_list->link(_M_node);
+            return __tmp;
+        }
+
+        friend bool operator==(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node == __y._M_node;
+        }
+
+        friend bool operator!=(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node != __y._M_node;
+        }
+    };
+
+    /**
+     * @brief Opens the %list stored in @a __path, creating an empty one
+     * if the file does not exist or is empty.
+     * @param __reserve  Number of nodes to make room for when creating.
+     *
+     * Opening an existing %list is constant time.  Throws std::system_error
+     * if the file cannot be opened or mapped, or holds a different
+     * element type.
+     */
+    explicit mapped_forward_list(const char* __path, size_type __reserve = 0)
+    : fd(::open(__path, O_RDWR | O_CREAT | O_CLOEXEC, 0644)), base(nullptr), length(0)
+    {
+        if(fd < 0)
+        {
+            fail("mfpkg::mapped_forward_list: cannot open file");
+        }
+        try
+        {
+            struct stat __st;
+            if(::fstat(fd, &__st) < 0)
+            {
+                fail("mfpkg::mapped_forward_list: cannot stat file");
+            }
+            length = std::size_t(__st.st_size);
+            const bool __fresh = length == 0;
+            if(__fresh)
+            {
+                length = first_node + __reserve * sizeof(node);
+                format();
+            }
+            else if(length < sizeof(header))
+            {
+                errno = EINVAL;
+                fail("mfpkg::mapped_forward_list: file too small");
+            }
+            void* __p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if(__p == MAP_FAILED)
+            {
+                fail("mfpkg::mapped_forward_list: cannot map file");
+            }
+            base = static_cast<char*>(__p);
+            if(__fresh)
+            {
+                header& __h = meta();
+                std::memcpy(__h.magic, magic, sizeof magic);
+                __h.start = 0;
+                __h.finish = head;
+                __h.count = 0;
+                __h.free_head = 0;
+                __h.bump = first_node;
+                __h.value_size = sizeof(_Tp);
+                __h.node_align = alignof(node);
+            }
+            else
+            {
+                validate();
+            }
+        }
+        catch (...)
+        {
+            if(base)
+            {
+                ::munmap(base, length);
+            }
+            ::close(fd);
+            throw;
+        }
+    }
+
+    mapped_forward_list(const _Self&) = delete;
+    _Self& operator=(const _Self&) = delete;
+
+    /**
+     * Unmaps the file without syncing it.  Call sync() first for a
+     * durable %list.
+     */
+    ~mapped_forward_list() noexcept
+    {
+        ::munmap(base, length);
+        ::close(fd);
+    }
+
+    /**
+     * @brief Flushes the mapping to the file and waits for completion.
+     *
+     * Throws std::system_error if msync() fails.
+     */
+    void sync(void)
+    {
+        if(::msync(base, length, MS_SYNC) < 0)
+        {
+            fail("mfpkg::mapped_forward_list: msync failed");
+        }
+    }
+
+    /**
+     * @brief Makes room for @a __n elements in total without growing the file.
+     */
+    void reserve(size_type __n)
+    {
+        const header& __h = meta();
+        if(__n > __h.count)
+        {
+            std::size_t __bytes = __h.bump + (__n - __h.count) * sizeof(node);
+            if(__bytes > length)
+            {
+                grow(__bytes);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the size of the backing file in bytes.
+     */
+    std::size_t file_size(void) const noexcept
+    {
+        return length;
+    }
+
+    iterator before_begin(void) noexcept
+    {
+        return iterator(this, head);
+    }
+
+    const_iterator before_begin(void) const noexcept
+    {
+        return const_iterator(this, head);
+    }
+
+    iterator begin(void) noexcept
+    {
+        return iterator(this, link(head));
+    }
+
+    const_iterator begin(void) const noexcept
+    {
+        return const_iterator(this, link(head));
+    }
+
+    /**
+     * Returns an iterator to the last element, or before_begin() when empty.
+     */
+    iterator rbegin(void) noexcept
+    {
+        return iterator(this, meta().finish);
+    }
+
+    const_iterator rbegin(void) const noexcept
+    {
+        return const_iterator(this, meta().finish);
+    }
+
+    iterator end(void) noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    const_iterator end(void) const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    reference front(void) noexcept
+    {
+        return *begin();
+    }
+
+    const_reference front(void) const noexcept
+    {
+        return *begin();
+    }
+
+    reference back(void) noexcept
+    {
+        return *rbegin();
+    }
+
+    const_reference back(void) const noexcept
+    {
+        return *rbegin();
+    }
+
+    bool empty(void) const noexcept
+    {
+        return link(head) == 0;
+    }
+
+    std::size_t size(void) const noexcept
+    {
+        return std::size_t(meta().count);
+    }
+
+    void push_back(const _Tp& __val)
+    {
+        link_after(meta().finish, __val);
+    }
+
+    void push_front(const _Tp& __val)
+    {
+        link_after(head, __val);
+    }
+
+    void pop_front(void) noexcept
+    {
+        erase_after(before_begin());
+    }
+
+    iterator insert_after(const iterator& __position, const _Tp& __val)
+    {
+        return iterator(this, link_after(__position._M_node, __val));
+    }
+
+    /**
+     * @brief Removes the element following @a __position.
+     * @return  An iterator to the element after the erased one, or end().
+     *
+     * The node goes to the free list kept in the file.
+     */
+    iterator erase_after(const iterator& __position) noexcept
+    {
+        offset_type __pos = __position._M_node;
+        offset_type __node = __pos ? link(__pos) : 0;
+        if(!__node)
+        {
+            return end();
+        }
+        header& __h = meta();
+        link(__pos) = link(__node);
+        if(__node == __h.finish)
+        {
+            __h.finish = __pos;
+        }
+        put_node(__node);
+        --__h.count;
+        return iterator(this, link(__pos));
+    }
+
+    /**
+     * @brief Erases all the elements.  Constant time: the whole chain is
+     * moved to the free list.
+     */
+    void clear(void) noexcept
+    {
+        header& __h = meta();
+        if(!__h.start)
+        {
+            return;
+        }
+        link(__h.finish) = __h.free_head;
+        __h.free_head = __h.start;
+        __h.start = 0;
+        __h.finish = head;
+        __h.count = 0;
+    }
+
+    /**
+     * @brief Sorts the list.  Equivalent elements remain in list order.
+     */
+    void sort(void)
+    {
+        offset_type __last = basic_mfpkg::index_chain::sort(*this, head);
+        meta().finish = __last;
+    }
+
+    /**
+     * @brief Reverses the order of elements in the list.
+     */
+    void reverse(void) noexcept
+    {
+        offset_type __last = basic_mfpkg::index_chain::reverse(*this, head);
+        meta().finish = __last;
+    }
+};
+
+#endif
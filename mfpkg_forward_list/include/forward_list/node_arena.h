@@ -0,0 +1,426 @@
+/**
+ * @file node_arena.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef NODE_ARENA_H
+#define NODE_ARENA_H
+
+/**
+ *  Node allocator backed by large anonymous mappings.  Regions are
+ *  requested with MAP_HUGETLB first; when no huge pages are reserved the
+ *  arena maps normal pages aligned to the huge page size and asks for
+ *  transparent huge pages with madvise(MADV_HUGEPAGE).  Either way, a list
+ *  of millions of nodes spans a few hundred TLB entries instead of tens
+ *  of thousands.
+ *
+ *  The arena is used by every list on a thread while a node_arena::scope
+ *  is alive on it.  Regions are registered with node_regions, so nodes
+ *  may be released from any thread, inside or outside of the scope, and
+ *  go back to per size class free lists.  The arena must outlive the
+ *  nodes it handed out.
+ *
+ *  Requests larger than max_size, or aligned beyond max_align, are left
+ *  to the heap.
+ */
+class mfpkg::node_arena
+{
+public:
+
+    static constexpr std::size_t default_region = std::size_t(64) << 20;
+    static constexpr std::size_t max_size = 4096;
+    static constexpr std::size_t max_align = 64;
+
+    struct statistics
+    {
+        std::size_t regions;
+        std::size_t huge_page_size;
+        std::size_t hugetlb_pages;      ///< huge pages taken from the hugetlbfs pool
+        std::size_t transparent_pages;  ///< transparent huge pages backing the regions now
+        std::size_t base_pages;         ///< normal pages mapped, resident or not
+        std::size_t reserved;           ///< bytes mapped
+        std::size_t used;               ///< bytes held by live nodes
+        std::size_t cached;             ///< bytes on the free lists
+
+        /**
+         * @brief Fraction of the reserved bytes held by live nodes.
+         */
+        double fill(void) const noexcept
+        {
+            return reserved ? double(used) / double(reserved) : 0.0;
+        }
+    };
+
+    /**
+     * Makes @a __a the arena of the calling thread until destruction.
+     * Scopes nest.
+     */
+    class scope
+    {
+    private:
+
+        node_arena* previous;
+
+    public:
+
+        explicit scope(node_arena& __a) noexcept : previous(current)
+        {
+            current = &__a;
+        }
+
+        ~scope()
+        {
+            current = previous;
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+    };
+
+private:
+
+    static constexpr std::size_t granule = 16;
+    static constexpr std::size_t classes = max_size / granule;
+    static constexpr std::size_t alignments = 3;
+
+    struct region : basic_mfpkg::node_regions::region
+    {
+        node_arena* owner;
+        region* next;
+        char* base;
+        std::size_t length;
+        bool hugetlb;
+    };
+
+    struct free_slot
+    {
+        free_slot* next;
+    };
+
+    static inline thread_local node_arena* current = nullptr;
+
+    mutable std::atomic_flag busy = ATOMIC_FLAG_INIT;
+    free_slot* free_lists[alignments][classes] = {};
+    region* regions = nullptr;
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    std::size_t region_bytes;
+    std::size_t reserved = 0;
+    std::size_t hugetlb_bytes = 0;
+    std::size_t used = 0;
+    std::size_t cached = 0;
+    bool try_hugetlb;
+
+    void lock(void) const noexcept
+    {
+        while (busy.test_and_set(std::memory_order_acquire));
+    }
+
+    void unlock(void) const noexcept
+    {
+        busy.clear(std::memory_order_release);
+    }
+
+    /**
+     * Default huge page size of the system, 2 MiB if unknown.
+     */
+    static std::size_t huge_page_size(void) noexcept
+    {
+        static const std::size_t __size = []
+        {
+            std::size_t __kb = 0;
+            if(std::FILE* __f = std::fopen("/proc/meminfo", "r"))
+            {
+                char __line[128];
+                while (std::fgets(__line, sizeof __line, __f))
+                {
+                    if(std::sscanf(__line, "Hugepagesize: %zu kB", &__kb) == 1)
+                    {
+                        break;
+                    }
+                }
+                std::fclose(__f);
+            }
+            return __kb ? __kb << 10 : std::size_t(2) << 20;
+        }();
+        return __size;
+    }
+
+    static std::size_t base_page_size(void) noexcept
+    {
+        long __size = ::sysconf(_SC_PAGESIZE);
+        return __size > 0 ? std::size_t(__size) : 4096;
+    }
+
+    static std::size_t class_of(std::size_t __size, std::size_t __align) noexcept
+    {
+        return (__size + __align - 1) / __align * __align / granule - 1;
+    }
+
+    static std::size_t alignment_of(std::size_t __align) noexcept
+    {
+        return __align == granule ? 0 : __align == 2 * granule ? 1 : 2;
+    }
+
+    /**
+     * Maps @a __bytes, rounded up to whole huge pages.
+     * Returns nullptr when the mapping fails.  Once the hugetlbfs pool
+     * runs dry, later regions use normal pages.
+     */
+    char* map(std::size_t& __bytes, bool& __hugetlb) noexcept
+    {
+        const std::size_t __huge = huge_page_size();
+        __bytes = (__bytes + __huge - 1) / __huge * __huge;
+#if defined(MAP_HUGETLB)
+        if(try_hugetlb)
+        {
+            void* __p = ::mmap(nullptr, __bytes, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if(__p != MAP_FAILED)
+            {
+                __hugetlb = true;
+                return static_cast<char*>(__p);
+            }
+            try_hugetlb = false;
+        }
+#endif
+        // Normal pages, over-mapped by one huge page and trimmed so the
+        // region starts on a huge page boundary.
+        void* __p = ::mmap(nullptr, __bytes + __huge, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(__p == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        __hugetlb = false;
+        char* __raw = static_cast<char*>(__p);
+        char* __base = reinterpret_cast<char*>(
+            (reinterpret_cast<std::uintptr_t>(__raw) + __huge - 1) / __huge * __huge);
+        if(__base != __raw)
+        {
+            ::munmap(__raw, __base - __raw);
+        }
+        ::munmap(__base + __bytes, __raw + __huge - __base);
+#if defined(MADV_HUGEPAGE)
+        ::madvise(__base, __bytes, MADV_HUGEPAGE);
+#endif
+        return __base;
+    }
+
+    /**
+     * Maps a new region large enough for @a __bytes and makes it current.
+     */
+    bool grow(std::size_t __bytes) noexcept
+    {
+        std::size_t __length = std::max(region_bytes, __bytes);
+        region* __r = new (std::nothrow) region;
+        if(!__r)
+        {
+            return false;
+        }
+        __r->base = map(__length, __r->hugetlb);
+        if(!__r->base)
+        {
+            delete __r;
+            return false;
+        }
+        __r->length = __length;
+        __r->first = __r->base;
+        __r->last = __r->base + __length;
+        __r->release = &node_arena::release_one;
+        __r->owner = this;
+        try
+        {
+            basic_mfpkg::node_regions::insert(__r);
+        }
+        catch (...)
+        {
+            ::munmap(__r->base, __length);
+            delete __r;
+            return false;
+        }
+        __r->next = regions;
+        regions = __r;
+        reserved += __length;
+        hugetlb_bytes += __r->hugetlb ? __length : 0;
+        cursor = __r->base;
+        limit = __r->base + __length;
+        return true;
+    }
+
+    static void release_one(basic_mfpkg::node_regions::region* __r, void* __p,
+                            std::size_t __size, std::size_t __align) noexcept
+    {
+        static_cast<region*>(__r)->owner->deallocate(__p, __size, __align);
+    }
+
+    /**
+     * Bytes of the regions currently backed by transparent huge pages,
+     * read from /proc/self/smaps.
+     */
+    std::size_t transparent_huge_bytes(void) const noexcept
+    {
+        std::size_t __total = 0;
+        std::FILE* __f = std::fopen("/proc/self/smaps", "r");
+        if(!__f)
+        {
+            return 0;
+        }
+        char __line[256];
+        bool __ours = false;
+        while (std::fgets(__line, sizeof __line, __f))
+        {
+            std::uintptr_t __first, __last;
+            std::size_t __kb;
+            if(std::sscanf(__line, "%" SCNxPTR "-%" SCNxPTR, &__first, &__last) == 2)
+            {
+                __ours = false;
+                for (const region* __r = regions; __r; __r = __r->next)
+                {
+                    std::uintptr_t __base = reinterpret_cast<std::uintptr_t>(__r->base);
+                    if(__first >= __base && __first < __base + __r->length)
+                    {
+                        __ours = true;
+                        break;
+                    }
+                }
+            }
+            else if(__ours && std::sscanf(__line, "AnonHugePages: %zu kB", &__kb) == 1)
+            {
+                __total += __kb << 10;
+            }
+        }
+        std::fclose(__f);
+        return __total;
+    }
+
+public:
+
+    /**
+     * Creates an empty arena that maps @a __region_bytes at a time.
+     * With @a __hugetlb false, MAP_HUGETLB is never attempted.
+     */
+    explicit node_arena(std::size_t __region_bytes = default_region,
+                        bool __hugetlb = true) noexcept
+        : region_bytes(__region_bytes ? __region_bytes : default_region),
+          try_hugetlb(__hugetlb)
+    {
+    }
+
+    node_arena(const node_arena&) = delete;
+    node_arena& operator=(const node_arena&) = delete;
+
+    /**
+     * Unmaps every region.  Nodes still living in the arena become invalid.
+     */
+    ~node_arena()
+    {
+        while (regions)
+        {
+            region* __r = regions;
+            regions = __r->next;
+            basic_mfpkg::node_regions::erase(__r);
+            ::munmap(__r->base, __r->length);
+            delete __r;
+        }
+    }
+
+    /**
+     * @brief Returns the arena of the calling thread, or nullptr.
+     */
+    static node_arena* active(void) noexcept
+    {
+        return current;
+    }
+
+    /**
+     * @brief Allocates @a __size bytes aligned to @a __align.
+     * @return nullptr if the request is not served by arenas or no region
+     *         could be mapped.
+     */
+    void* allocate(std::size_t __size, std::size_t __align) noexcept
+    {
+        if(__size > max_size || __align > max_align)
+        {
+            return nullptr;
+        }
+        __align = std::max(__align, granule);
+        const std::size_t __c = class_of(__size, __align);
+        const std::size_t __bytes = (__c + 1) * granule;
+        free_slot*& __head = free_lists[alignment_of(__align)][__c];
+        lock();
+        void* __p = __head;
+        if(__head)
+        {
+            __head = __head->next;
+            cached -= __bytes;
+        }
+        else
+        {
+            char* __q = reinterpret_cast<char*>(
+                (reinterpret_cast<std::uintptr_t>(cursor) + __align - 1) & ~(__align - 1));
+            if(!cursor || __q + __bytes > limit)
+            {
+                if(!grow(__bytes))
+                {
+                    unlock();
+                    return nullptr;
+                }
+                __q = cursor;
+            }
+            cursor = __q + __bytes;
+            __p = __q;
+        }
+        used += __bytes;
+        unlock();
+        return __p;
+    }
+
+    /**
+     * Returns memory obtained from allocate() with the same size and
+     * alignment to its free list.
+     */
+    void deallocate(void* __p, std::size_t __size, std::size_t __align) noexcept
+    {
+        __align = std::max(__align, granule);
+        const std::size_t __c = class_of(__size, __align);
+        const std::size_t __bytes = (__c + 1) * granule;
+        free_slot*& __head = free_lists[alignment_of(__align)][__c];
+        free_slot* __slot = static_cast<free_slot*>(__p);
+        lock();
+        __slot->next = __head;
+        __head = __slot;
+        used -= __bytes;
+        cached += __bytes;
+        unlock();
+    }
+
+    /**
+     * @brief Returns page counts and fill of the arena.
+     *
+     * Transparent huge pages are counted from /proc/self/smaps, so this
+     * is not meant for hot paths.
+     */
+    statistics stats(void) const noexcept
+    {
+        lock();
+        statistics __s {};
+        for (const region* __r = regions; __r; __r = __r->next)
+        {
+            ++__s.regions;
+        }
+        const std::size_t __thp = transparent_huge_bytes();
+        __s.huge_page_size = huge_page_size();
+        __s.hugetlb_pages = hugetlb_bytes / __s.huge_page_size;
+        __s.transparent_pages = __thp / __s.huge_page_size;
+        __s.base_pages = (reserved - hugetlb_bytes - __thp) / base_page_size();
+        __s.reserved = reserved;
+        __s.used = used;
+        __s.cached = cached;
+        unlock();
+        return __s;
+    }
+};
+
+#endif
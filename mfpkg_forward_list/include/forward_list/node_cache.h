@@ -0,0 +1,269 @@
+/**
+ * @file node_cache.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef NODE_CACHE_H
+#define NODE_CACHE_H
+
+/**
+ *  Process-wide cache of freed node memory shared by every list.  Nodes
+ *  are grouped into size classes of 16 bytes, so lists of different
+ *  element types with the same node size recycle each other's nodes.
+ *
+ *  Each thread keeps two magazines per class and touches no shared state
+ *  while one of them can serve the request.  When both run empty or full,
+ *  a whole magazine is exchanged with the global depot under a per class
+ *  lock.  Magazines beyond the depot limit are returned to the heap.
+ *
+ *  Nodes larger than max_size or aligned beyond the default new alignment
+ *  bypass the cache.  Define MFPKG_NO_NODE_CACHE to disable it.
+ */
+class basic_mfpkg::node_cache
+{
+public:
+
+    static constexpr std::size_t granule = 16;
+    static constexpr std::size_t max_size = 256;
+    static constexpr std::size_t magazine_size = 64;
+    static constexpr std::size_t depot_limit = 32;
+
+private:
+
+    static constexpr std::size_t classes = max_size / granule;
+
+    struct magazine
+    {
+        std::size_t count;
+        void* slots[magazine_size];
+    };
+
+    struct depot
+    {
+        std::mutex lock;
+        std::vector<magazine*> full;
+        std::vector<magazine*> empty;
+    };
+
+    struct thread_cache
+    {
+        magazine* loaded[classes] = {};
+        magazine* previous[classes] = {};
+
+        ~thread_cache()
+        {
+            for (std::size_t __c = 0; __c < classes; ++__c)
+            {
+                give(__c, loaded[__c]);
+                give(__c, previous[__c]);
+            }
+            torn_down = true;
+        }
+    };
+
+    static inline thread_local bool torn_down = false;
+
+    /**
+     * The depots are never destroyed, so that lists released during
+     * static destruction can still reach them.
+     */
+    static depot* depots(void) noexcept
+    {
+        static depot* const __d = new depot[classes];
+        return __d;
+    }
+
+    static thread_cache* local(void) noexcept
+    {
+        if(torn_down)
+        {
+            return nullptr;
+        }
+        thread_local thread_cache __cache;
+        return &__cache;
+    }
+
+    static std::size_t class_bytes(std::size_t __c) noexcept
+    {
+        return (__c + 1) * granule;
+    }
+
+    static void free_slots(magazine* __m) noexcept
+    {
+        for (std::size_t __i = 0; __i < __m->count; ++__i)
+        {
+            ::operator delete(__m->slots[__i]);
+        }
+        __m->count = 0;
+    }
+
+    /**
+     * Hands @a __m to the depot of class @a __c, full or empty.
+     */
+    static void give(std::size_t __c, magazine* __m) noexcept
+    {
+        if(!__m)
+        {
+            return;
+        }
+        depot& __d = depots()[__c];
+        std::lock_guard<std::mutex> __lock(__d.lock);
+        std::vector<magazine*>& __to = __m->count ? __d.full : __d.empty;
+        if(__to.size() < depot_limit)
+        {
+            try
+            {
+                __to.push_back(__m);
+                return;
+            }
+            catch (...)
+            {
+            }
+        }
+        free_slots(__m);
+        delete __m;
+    }
+
+    /**
+     * Takes a full magazine, or an empty one if @a __full is false,
+     * from the depot of class @a __c.
+     */
+    static magazine* take(std::size_t __c, bool __full) noexcept
+    {
+        depot& __d = depots()[__c];
+        std::lock_guard<std::mutex> __lock(__d.lock);
+        std::vector<magazine*>& __from = __full ? __d.full : __d.empty;
+        if(__from.empty())
+        {
+            return nullptr;
+        }
+        magazine* __m = __from.back();
+        __from.pop_back();
+        return __m;
+    }
+
+public:
+
+    /**
+     * @brief Returns true if nodes of @a __size bytes aligned to
+     * @a __align go through the cache.
+     */
+    static constexpr bool cached(std::size_t __size, std::size_t __align) noexcept
+    {
+#if defined(MFPKG_NO_NODE_CACHE)
+        (void)__size;
+        (void)__align;
+        return false;
+#else
+        return __size <= max_size && __align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+#endif
+    }
+
+    /**
+     * @brief Returns memory for a node of @a __size bytes, recycled if
+     * possible, or nullptr when out of memory.
+     */
+    static void* allocate(std::size_t __size) noexcept
+    {
+        const std::size_t __c = (__size + granule - 1) / granule - 1;
+        if(thread_cache* __t = local())
+        {
+            magazine*& __m = __t->loaded[__c];
+            magazine*& __p = __t->previous[__c];
+            if(!(__m && __m->count))
+            {
+                if(__p && __p->count)
+                {
+                    std::swap(__m, __p);
+                }
+                else if(magazine* __full = take(__c, true))
+                {
+                    give(__c, __p);
+                    __p = __m;
+                    __m = __full;
+                }
+            }
+            if(__m && __m->count)
+            {
+                return __m->slots[--__m->count];
+            }
+        }
+        return ::operator new(class_bytes(__c), std::nothrow);
+    }
+
+    /**
+     * Recycles node memory obtained from allocate() with the same size.
+     */
+    static void deallocate(void* __ptr, std::size_t __size) noexcept
+    {
+        const std::size_t __c = (__size + granule - 1) / granule - 1;
+        if(thread_cache* __t = local())
+        {
+            magazine*& __m = __t->loaded[__c];
+            magazine*& __p = __t->previous[__c];
+            if(!(__m && __m->count < magazine_size))
+            {
+                if(__p && __p->count < magazine_size)
+                {
+                    std::swap(__m, __p);
+                }
+                else
+                {
+                    magazine* __empty = take(__c, false);
+                    if(!__empty)
+                    {
+                        __empty = new (std::nothrow) magazine;
+                    }
+                    if(__empty)
+                    {
+                        __empty->count = 0;
+                        give(__c, __p);
+                        __p = __m;
+                        __m = __empty;
+                    }
+                }
+            }
+            if(__m && __m->count < magazine_size)
+            {
+                __m->slots[__m->count++] = __ptr;
+                return;
+            }
+        }
+        ::operator delete(__ptr);
+    }
+
+    /**
+     * Returns the nodes cached by the calling thread and by the depot to
+     * the heap.  Other threads keep their magazines.
+     */
+    static void trim(void) noexcept
+    {
+        if(thread_cache* __t = local())
+        {
+            for (std::size_t __c = 0; __c < classes; ++__c)
+            {
+                for (magazine* __m : {__t->loaded[__c], __t->previous[__c]})
+                {
+                    if(__m)
+                    {
+                        free_slots(__m);
+                    }
+                }
+            }
+        }
+        for (std::size_t __c = 0; __c < classes; ++__c)
+        {
+            depot& __d = depots()[__c];
+            std::lock_guard<std::mutex> __lock(__d.lock);
+            for (magazine* __m : __d.full)
+            {
+                free_slots(__m);
+                delete __m;
+            }
+            __d.full.clear();
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file node_regions.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef NODE_REGIONS_H
+#define NODE_REGIONS_H
+
+/**
+ *  Process-wide registry of memory regions that hand out many nodes at
+ *  once, such as the contiguous blocks built by defragment().  A node
+ *  that lives inside a registered region cannot be passed to operator
+ *  delete; releasing it is forwarded to the region instead.
+ *
+ *  Every free asks the registry first, so the common answer, that the
+ *  node belongs to no region, is found without locking: a table of
+ *  counters records how many registered granules of granule_size bytes
+ *  hash to each bucket, and a node whose bucket is zero cannot lie in a
+ *  region.  Only nodes near a region, or in a colliding bucket, take the
+ *  lock and look the region up.
+ */
+class basic_mfpkg::node_regions
+{
+public:
+
+    struct region
+    {
+        const char* first;
+        const char* last;
+        void (*release)(region* __r, void* __p,
+                        std::size_t __size, std::size_t __align) noexcept;
+    };
+
+private:
+
+    static constexpr unsigned granule_shift = 16;
+    static constexpr unsigned filter_bits = 16;
+
+    static inline std::atomic<std::uint32_t> filter[std::size_t(1) << filter_bits];
+    static inline std::shared_mutex lock;
+    static inline std::map<const char*, region*> regions;
+
+    static std::atomic<std::uint32_t>& bucket(std::uintptr_t __granule) noexcept
+    {
+        return filter[std::size_t((std::uint64_t(__granule) * 0x9e3779b97f4a7c15ull) >> (64 - filter_bits))];
+    }
+
+    static std::atomic<std::uint32_t>& bucket(const void* __p) noexcept
+    {
+        return bucket(reinterpret_cast<std::uintptr_t>(__p) >> granule_shift);
+    }
+
+    /**
+     * Adds @a __d to the buckets of every granule overlapping @a __r.
+     */
+    static void mark(const region* __r, std::uint32_t __d) noexcept
+    {
+        if(__r->first == __r->last)
+        {
+            return;
+        }
+        std::uintptr_t __g = reinterpret_cast<std::uintptr_t>(__r->first) >> granule_shift;
+        std::uintptr_t __end = (reinterpret_cast<std::uintptr_t>(__r->last) - 1) >> granule_shift;
+        for (; __g <= __end; ++__g)
+        {
+            bucket(__g).fetch_add(__d, std::memory_order_release);
+        }
+    }
+
+public:
+
+    static constexpr std::size_t granule_size = std::size_t(1) << granule_shift;
+
+    /**
+     * Registers @a __r.  Nodes inside [first, last) are released through it.
+     */
+    static void insert(region* __r)
+    {
+        std::unique_lock<std::shared_mutex> __lock(lock);
+        regions.emplace(__r->first, __r);
+        mark(__r, 1);
+    }
+
+    /**
+     * Unregisters @a __r.
+     */
+    static void erase(region* __r) noexcept
+    {
+        std::unique_lock<std::shared_mutex> __lock(lock);
+        if(regions.erase(__r->first))
+        {
+            mark(__r, std::uint32_t(-1));
+        }
+    }
+
+    /**
+     * @brief Returns the region holding @a __p, or nullptr.
+     */
+    static region* find(const void* __p) noexcept
+    {
+        if(!bucket(__p).load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        const char* __c = static_cast<const char*>(__p);
+        std::shared_lock<std::shared_mutex> __lock(lock);
+        auto __it = regions.upper_bound(__c);
+        if(__it == regions.begin())
+        {
+            return nullptr;
+        }
+        --__it;
+        return __c < __it->second->last ? __it->second : nullptr;
+    }
+
+    /**
+     * @brief Hands the node memory at @a __p, of @a __size bytes aligned
+     * to @a __align, back to its region.
+     * @return false if @a __p does not belong to any region.
+     *
+     * The region is looked up under a shared lock and released outside of
+     * it, since releasing the last node of a region unregisters it.
+     */
+    static bool release(void* __p, std::size_t __size, std::size_t __align) noexcept
+    {
+        region* __r = find(__p);
+        if(!__r)
+        {
+            return false;
+        }
+        __r->release(__r, __p, __size, __align);
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,269 @@
+/**
+ *  @brief Parallel algorithms over a mfpkg::forward_list.
+ *
+ *  A singly linked %list cannot be split without walking it, so every
+ *  algorithm first cuts the chain into segments with a single boundary
+ *  walk (or reuses a cached mfpkg::parallel::segments) and then hands
+ *  the segments to a process-wide pool of worker threads.  Each worker
+ *  owns a contiguous run of segments and steals from the other workers
+ *  once its own run is exhausted, so uneven per-element costs still
+ *  keep every core busy.
+ *
+ *  A @a __threads argument of zero means one thread per hardware core.
+ *  The %list must not be modified structurally while an algorithm runs.
+ *
+ *  @file parallel.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+namespace mfpkg
+{
+namespace parallel
+{
+    /**
+     *  @brief A cached split of a %forward_list into segments.
+     *
+     *  Built with one walk over the %list.  It stays valid for as long as
+     *  the %list is not modified structurally, so repeated passes over
+     *  the same %list can share it and skip the boundary walk.
+     */
+    template <typename _Tp>
+    class segments
+    {
+        public:
+
+        typedef basic_mfpkg::basic_forward_list::iterator<_Tp> iterator;
+
+        struct segment
+        {
+            iterator first;
+            std::size_t length;
+        };
+
+        private:
+
+        std::vector<segment> parts;
+        std::size_t threads;
+
+        public:
+
+        /**
+         * @brief Splits @a __list into segments for @a __threads threads.
+         * @param __list    The %list to split.
+         * @param __threads Number of threads, zero for one per core.
+         * @param __per_thread Segments per thread.  More segments give
+         *                     work stealing finer grain to balance with.
+         */
+        template <typename _Policy>
+        explicit segments(mfpkg::forward_list<_Tp, _Policy>& __list, std::size_t __threads = 0,
+                          std::size_t __per_thread = 8)
+        : threads(__threads)
+        {
+            std::size_t __size = __list.size();
+            std::size_t __t = __threads ? __threads : basic_mfpkg::task_pool::instance().capacity();
+            std::size_t __k = std::min(__size, __t * std::max<std::size_t>(__per_thread, 1));
+            if(!__k)
+            {
+                return;
+            }
+            parts.reserve(__k);
+            iterator __it = __list.begin();
+            for (std::size_t __i = 0; __i < __k; ++__i)
+            {
+                std::size_t __n = __size / __k + (__i < __size % __k);
+                parts.push_back({__it, __n});
+                __it += __n;
+            }
+        }
+
+        std::size_t size(void) const noexcept
+        {
+            return parts.size();
+        }
+
+        std::size_t thread_count(void) const noexcept
+        {
+            return threads;
+        }
+
+        const segment& operator[](std::size_t __i) const noexcept
+        {
+            return parts[__i];
+        }
+    };
+
+    /**
+     * @brief Applies @a __f to every element of the partition.
+     */
+    template <typename _Tp, typename _Function>
+    void for_each(const segments<_Tp>& __parts, _Function __f)
+    {
+        basic_mfpkg::task_pool::instance().run(__parts.size(), __parts.thread_count(),
+            [&](std::size_t __s)
+            {
+                auto __it = __parts[__s].first;
+                for (std::size_t __n = __parts[__s].length; __n; --__n, ++__it)
+                {
+                    __f(*__it);
+                }
+            });
+    }
+
+    /**
+     * @brief Applies @a __f to every element of @a __list in parallel.
+     *
+     * Elements are visited in no particular order.
+     */
+    template <typename _Tp, typename _Policy, typename _Function>
+    void for_each(mfpkg::forward_list<_Tp, _Policy>& __list, _Function __f, std::size_t __threads = 0)
+    {
+        for_each(segments<_Tp>(__list, __threads), __f);
+    }
+
+    /**
+     * @brief Replaces every element @c x of the partition with @a __f(x).
+     */
+    template <typename _Tp, typename _Function>
+    void transform_inplace(const segments<_Tp>& __parts, _Function __f)
+    {
+        for_each(__parts, [&](_Tp& __x) { __x = __f(static_cast<const _Tp&>(__x)); });
+    }
+
+    /**
+     * @brief Replaces every element @c x of @a __list with @a __f(x) in parallel.
+     */
+    template <typename _Tp, typename _Policy, typename _Function>
+    void transform_inplace(mfpkg::forward_list<_Tp, _Policy>& __list, _Function __f, std::size_t __threads = 0)
+    {
+        transform_inplace(segments<_Tp>(__list, __threads), __f);
+    }
+
+    /**
+     * @brief Folds the partition with @a __op starting from @a __init.
+     *
+     * Segments are reduced concurrently and their results combined in list
+     * order, so @a __op needs to be associative but not commutative.
+     */
+    template <typename _Tp, typename _Up, typename _BinaryOp>
+    _Up reduce(const segments<_Tp>& __parts, _Up __init, _BinaryOp __op)
+    {
+        std::vector<std::optional<_Up>> __partial(__parts.size());
+        basic_mfpkg::task_pool::instance().run(__parts.size(), __parts.thread_count(),
+            [&](std::size_t __s)
+            {
+                auto __it = __parts[__s].first;
+                _Up __acc = static_cast<_Up>(*__it);
+                ++__it;
+                for (std::size_t __n = __parts[__s].length - 1; __n; --__n, ++__it)
+                {
+                    __acc = __op(std::move(__acc), *__it);
+                }
+                __partial[__s].emplace(std::move(__acc));
+            });
+        for (auto& __p : __partial)
+        {
+            __init = __op(std::move(__init), std::move(*__p));
+        }
+        return __init;
+    }
+
+    /**
+     * @brief Folds @a __list with @a __op in parallel.
+     */
+    template <typename _Tp, typename _Policy, typename _Up, typename _BinaryOp>
+    _Up reduce(mfpkg::forward_list<_Tp, _Policy>& __list, _Up __init, _BinaryOp __op, std::size_t __threads = 0)
+    {
+        return reduce(segments<_Tp>(__list, __threads), std::move(__init), __op);
+    }
+
+    /**
+     * @brief Sums @a __list in parallel.
+     */
+    template <typename _Tp, typename _Policy>
+    _Tp reduce(mfpkg::forward_list<_Tp, _Policy>& __list, std::size_t __threads = 0)
+    {
+        return reduce(__list, _Tp(), std::plus<>(), __threads);
+    }
+
+    /**
+     * @brief Counts the elements of the partition satisfying @a __pred.
+     */
+    template <typename _Tp, typename _Predicate>
+    std::size_t count_if(const segments<_Tp>& __parts, _Predicate __pred)
+    {
+        std::atomic<std::size_t> __total(0);
+        basic_mfpkg::task_pool::instance().run(__parts.size(), __parts.thread_count(),
+            [&](std::size_t __s)
+            {
+                std::size_t __c = 0;
+                auto __it = __parts[__s].first;
+                for (std::size_t __n = __parts[__s].length; __n; --__n, ++__it)
+                {
+                    __c += static_cast<bool>(__pred(static_cast<const _Tp&>(*__it)));
+                }
+                __total.fetch_add(__c, std::memory_order_relaxed);
+            });
+        return __total.load();
+    }
+
+    /**
+     * @brief Counts the elements of @a __list satisfying @a __pred in parallel.
+     */
+    template <typename _Tp, typename _Policy, typename _Predicate>
+    std::size_t count_if(mfpkg::forward_list<_Tp, _Policy>& __list, _Predicate __pred, std::size_t __threads = 0)
+    {
+        return count_if(segments<_Tp>(__list, __threads), __pred);
+    }
+
+    /**
+     * @brief Finds the first element of the partition satisfying @a __pred.
+     * @return An iterator to the first match in list order, or end().
+     *
+     * Segments that lie after an already found match stop early.
+     */
+    template <typename _Tp, typename _Predicate>
+    typename segments<_Tp>::iterator find_if(const segments<_Tp>& __parts, _Predicate __pred)
+    {
+        typedef typename segments<_Tp>::iterator iterator;
+        std::atomic<std::size_t> __best(__parts.size());
+        std::vector<iterator> __found(__parts.size());
+        basic_mfpkg::task_pool::instance().run(__parts.size(), __parts.thread_count(),
+            [&](std::size_t __s)
+            {
+                auto __it = __parts[__s].first;
+                for (std::size_t __n = __parts[__s].length; __n; --__n, ++__it)
+                {
+                    if(__best.load(std::memory_order_relaxed) < __s)
+                    {
+                        return;
+                    }
+                    if(__pred(static_cast<const _Tp&>(*__it)))
+                    {
+                        __found[__s] = __it;
+                        std::size_t __cur = __best.load(std::memory_order_relaxed);
+                        while (__s < __cur && !__best.compare_exchange_weak(__cur, __s));
+                        return;
+                    }
+                }
+            });
+        std::size_t __s = __best.load();
+        return __s < __parts.size() ? __found[__s] : iterator();
+    }
+
+    /**
+     * @brief Finds the first element of @a __list satisfying @a __pred in parallel.
+     */
+    template <typename _Tp, typename _Policy, typename _Predicate>
+    typename segments<_Tp>::iterator find_if(mfpkg::forward_list<_Tp, _Policy>& __list, _Predicate __pred,
+                                             std::size_t __threads = 0)
+    {
+        return find_if(segments<_Tp>(__list, __threads), __pred);
+    }
+};
+};
+
+#endif
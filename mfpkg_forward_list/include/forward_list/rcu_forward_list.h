@@ -0,0 +1,506 @@
+/**
+ *  @brief A read-mostly singly linked %list whose readers never lock.
+ *
+ *  @tparam _Tp  Type of element.
+ *
+ *  Readers open a read-side section with read_lock() and then traverse
+ *  the %list with an ordinary const_iterator.  Following a link is a
+ *  single acquire load, so readers take no locks, perform no atomic
+ *  read-modify-write operations and never wait for a writer.
+ *
+ *  Writers are serialized by a mutex.  A new node is fully built before
+ *  it is published with a release store, and an unlinked node is retired
+ *  rather than freed.  Retired nodes are released once a grace period
+ *  has passed, that is once every read-side section that could still
+ *  see them has ended.  Grace periods are tracked by rcu_domain.
+ *
+ *  A writer must not call a modifying operation from inside its own
+ *  read-side section, since it would wait for itself.
+ *
+ *  @file rcu_forward_list.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef RCU_FORWARD_LIST_H
+#define RCU_FORWARD_LIST_H
+
+/**
+ *  Process-wide epoch based grace period detector shared by every
+ *  rcu_forward_list.  Each reader thread owns a slot holding the epoch
+ *  at which its current read-side section began, or zero when it is
+ *  outside one.
+ */
+class basic_mfpkg::rcu_domain
+{
+private:
+
+    struct reader
+    {
+        std::atomic<unsigned long long> epoch;
+        std::atomic<bool> used;
+        unsigned nesting;
+        reader* next;
+    };
+
+    struct thread_slot
+    {
+        reader* slot;
+
+        ~thread_slot() noexcept
+        {
+            slot->epoch.store(0, std::memory_order_release);
+            slot->used.store(false, std::memory_order_release);
+        }
+    };
+
+    static inline std::atomic<unsigned long long> global_epoch {1};
+    static inline std::atomic<reader*> readers {nullptr};
+
+    static reader* acquire_slot(void)
+    {
+        for (reader* __r = readers.load(std::memory_order_acquire); __r; __r = __r->next)
+        {
+            bool __free = false;
+            if(!__r->used.load(std::memory_order_relaxed) &&
+               __r->used.compare_exchange_strong(__free, true))
+            {
+                __r->nesting = 0;
+                return __r;
+            }
+        }
+        reader* __r = new reader;
+        __r->epoch.store(0, std::memory_order_relaxed);
+        __r->used.store(true, std::memory_order_relaxed);
+        __r->nesting = 0;
+        __r->next = readers.load(std::memory_order_relaxed);
+        while (!readers.compare_exchange_weak(__r->next, __r,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+        return __r;
+    }
+
+    static reader* self(void)
+    {
+        thread_local thread_slot __slot {acquire_slot()};
+        return __slot.slot;
+    }
+
+public:
+
+    /**
+     * Enters a read-side section.  Sections may nest.  Only the
+     * outermost call publishes the current epoch, using a plain store
+     * followed by a fence.
+     */
+    static void read_lock(void)
+    {
+        reader* __r = self();
+        if(__r->nesting++ == 0)
+        {
+            __r->epoch.store(global_epoch.load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    /**
+     * Leaves a read-side section.
+     */
+    static void read_unlock(void)
+    {
+        reader* __r = self();
+        if(--__r->nesting == 0)
+        {
+            __r->epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    /**
+     * Waits until every read-side section that began before the call
+     * has ended.  Only writers call this; readers are never blocked.
+     */
+    static void synchronize(void) noexcept
+    {
+        unsigned long long __target = global_epoch.fetch_add(1) + 1;
+        for (reader* __r = readers.load(std::memory_order_acquire); __r; __r = __r->next)
+        {
+            for (;;)
+            {
+                unsigned long long __e = __r->epoch.load(std::memory_order_acquire);
+                if(__e == 0 || __e >= __target)
+                {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+template <typename _Tp>
+class mfpkg::rcu_forward_list : public basic_mfpkg::basic_forward_list
+{
+private:
+
+    typedef rcu_forward_list<_Tp> _Self;
+    typedef basic_mfpkg::rcu_domain domain;
+
+    static node_base* load_link(const node_base* __n) noexcept
+    {
+        return __atomic_load_n(&__n->link, __ATOMIC_ACQUIRE);
+    }
+
+    static void publish_link(node_base* __n, node_base* __link) noexcept
+    {
+        __atomic_store_n(&__n->link, __link, __ATOMIC_RELEASE);
+    }
+
+public:
+
+    /**
+     * Read-only iterator used by readers.  Every step is one acquire load
+     * of the current node's link.
+     */
+    struct const_iterator
+    {
+        typedef const_iterator _Self;
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const _Tp& reference;
+        typedef const _Tp* pointer;
+
+        const node_base* _M_node;
+
+        const_iterator() noexcept : _M_node(nullptr) {}
+
+        const_iterator(const node_base* __n) noexcept : _M_node(__n) {}
+
+        reference operator*() const noexcept
+        {
+            return static_cast<const node<_Tp>*>(_M_node)->storage;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &static_cast<const node<_Tp>*>(_M_node)->storage;
+        }
+
+        _Self& operator++() noexcept
+        {
+            _M_node = load_link(_M_node);
+            return *this;
+        }
+
+        _Self operator++(int) noexcept
+        {
+            _Self __tmp(*this);
+            _M_node = load_link(_M_node);
+            return __tmp;
+        }
+
+        friend bool operator==(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node == __y._M_node;
+        }
+
+        friend bool operator!=(const _Self& __x, const _Self& __y) noexcept
+        {
+            return __x._M_node != __y._M_node;
+        }
+    };
+
+    /**
+     * RAII read-side section returned by read_lock().
+     */
+    struct read_guard
+    {
+        read_guard() { domain::read_lock(); }
+
+        read_guard(const read_guard&) = delete;
+
+        read_guard& operator=(const read_guard&) = delete;
+
+        ~read_guard() { domain::read_unlock(); }
+    };
+
+private:
+
+    node_base start;
+    node_base* finish;
+    std::atomic<std::size_t> count;
+    std::vector<node_base*> retired;
+    std::size_t retire_limit;
+    std::mutex writer;
+
+    node<_Tp>* get_node(const _Tp& __val)
+    {
+        node<_Tp>* __node = new_node<_Tp>(__val);
+        if(!__node)
+        {
+            throw std::bad_alloc();
+        }
+        return __node;
+    }
+
+    static void put_node(node_base* __node) noexcept
+    {
+        delete_node<_Tp>(__node);
+    }
+
+    void retire(node_base* __node)
+    {
+        retired.push_back(__node);
+    }
+
+    void reclaim_if_needed(void)
+    {
+        if(retired.size() >= retire_limit)
+        {
+            reclaim();
+        }
+    }
+
+    void reclaim(void) noexcept
+    {
+        if(retired.empty())
+        {
+            return;
+        }
+        domain::synchronize();
+        for (node_base* __n : retired)
+        {
+            put_node(__n);
+        }
+        retired.clear();
+    }
+
+    node_base* link_after(node_base* __pos, node_base* __node) noexcept
+    {
+        __node->link = __pos->link;
+        if(!__node->link)
+        {
+            finish = __node;
+        }
+        publish_link(__pos, __node);
+        count.fetch_add(1, std::memory_order_relaxed);
+        return __node;
+    }
+
+    node_base* mutable_node(const_iterator __it) noexcept
+    {
+        return const_cast<node_base*>(__it._M_node);
+    }
+
+public:
+
+    /**
+     * @brief Creates an empty list.
+     * @param __retire_limit Number of retired nodes a writer accumulates
+     *                       before it waits for a grace period and frees them.
+     */
+    explicit rcu_forward_list(std::size_t __retire_limit = 128)
+    : start({nullptr}), finish(&start), count(0), retire_limit(__retire_limit ? __retire_limit : 1) {}
+
+    rcu_forward_list(std::initializer_list<_Tp> __list) : rcu_forward_list()
+    {
+        for (auto& __x : __list)
+        {
+            push_back(__x);
+        }
+    }
+
+    rcu_forward_list(const _Self&) = delete;
+
+    _Self& operator=(const _Self&) = delete;
+
+    /**
+     * Destroys the list.  No reader may still be traversing it.
+     */
+    ~rcu_forward_list() noexcept
+    {
+        reclaim();
+        for (node_base* __it = start.link; __it; )
+        {
+            node_base* __temp = __it;
+            __it = __it->link;
+            put_node(__temp);
+        }
+    }
+
+    /**
+     * Returns a guard that keeps the calling thread inside a read-side
+     * section for its lifetime.  Iterators into the list may only be
+     * dereferenced while a guard is alive.
+     */
+    read_guard read_lock(void) const
+    {
+        return read_guard();
+    }
+
+    const_iterator before_begin(void) const noexcept
+    {
+        return &start;
+    }
+
+    const_iterator begin(void) const noexcept
+    {
+        return load_link(&start);
+    }
+
+    const_iterator end(void) const noexcept
+    {
+        return nullptr;
+    }
+
+    /**
+     * @brief  Returns true if the %list is empty.
+     */
+    bool empty(void) const noexcept
+    {
+        return load_link(&start) == nullptr;
+    }
+
+    /**
+     * @brief  Returns the number of elements in the %list.
+     *
+     * The value may already be stale when a concurrent writer is active.
+     */
+    std::size_t size(void) const noexcept
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Inserts given value after specified iterator.
+     * @return  An iterator that points to the inserted data.
+     *
+     * The node is fully constructed before it becomes visible to readers.
+     */
+    const_iterator insert_after(const_iterator __pos, const _Tp& __val)
+    {
+        node<_Tp>* __node = get_node(__val);
+        std::lock_guard<std::mutex> __lock(writer);
+        return link_after(mutable_node(__pos), __node);
+    }
+
+    void push_front(const _Tp& __val)
+    {
+        node<_Tp>* __node = get_node(__val);
+        std::lock_guard<std::mutex> __lock(writer);
+        link_after(&start, __node);
+    }
+
+    void push_back(const _Tp& __val)
+    {
+        node<_Tp>* __node = get_node(__val);
+        std::lock_guard<std::mutex> __lock(writer);
+        link_after(finish, __node);
+    }
+
+    /**
+     * @brief Unlinks the element following @a __pos.
+     *
+     * Readers currently standing on the element may keep using it; its
+     * memory is released after a later grace period.
+     */
+    void erase_after(const_iterator __pos)
+    {
+        std::lock_guard<std::mutex> __lock(writer);
+        node_base* __prev = mutable_node(__pos);
+        node_base* __node = __prev->link;
+        if(!__node)
+        {
+            return;
+        }
+        publish_link(__prev, __node->link);
+        if(finish == __node)
+        {
+            finish = __prev;
+        }
+        count.fetch_sub(1, std::memory_order_relaxed);
+        retire(__node);
+        reclaim_if_needed();
+    }
+
+    void pop_front(void)
+    {
+        erase_after(before_begin());
+    }
+
+    /**
+     * @brief Moves the elements in (__before, __last) of @a __list after @a __pos.
+     *
+     * The moved range is linked into this list before it is unlinked from
+     * @a __list, so a reader of @a __list that is inside the range may
+     * continue into this list, but never reaches freed memory.
+     */
+    void splice_after(const_iterator __pos, _Self& __list,
+                      const_iterator __before, const_iterator __last)
+    {
+        if(&__list == this)
+        {
+            return;
+        }
+        std::scoped_lock __lock(writer, __list.writer);
+        node_base* __prev = __list.mutable_node(__before);
+        node_base* __first = __prev->link;
+        node_base* __end = __list.mutable_node(__last);
+        if(!__first || __first == __end)
+        {
+            return;
+        }
+        std::size_t __n = 1;
+        node_base* __tail = __first;
+        for (; __tail->link != __end; __tail = __tail->link, ++__n);
+
+        node_base* __at = mutable_node(__pos);
+        publish_link(__tail, __at->link);
+        publish_link(__at, __first);
+        if(!__tail->link)
+        {
+            finish = __tail;
+        }
+        publish_link(__prev, __end);
+        if(!__end)
+        {
+            __list.finish = __prev;
+        }
+        __list.count.fetch_sub(__n, std::memory_order_relaxed);
+        count.fetch_add(__n, std::memory_order_relaxed);
+    }
+
+    void splice_after(const_iterator __pos, _Self& __list)
+    {
+        splice_after(__pos, __list, __list.before_begin(), __list.end());
+    }
+
+    /**
+     * @brief Unlinks every element.  The nodes are retired, not freed.
+     */
+    void clear(void)
+    {
+        std::lock_guard<std::mutex> __lock(writer);
+        node_base* __it = start.link;
+        publish_link(&start, nullptr);
+        finish = &start;
+        count.store(0, std::memory_order_relaxed);
+        for (; __it; __it = __it->link)
+        {
+            retire(__it);
+        }
+        reclaim_if_needed();
+    }
+
+    /**
+     * @brief Waits for a grace period and frees every retired node.
+     */
+    void synchronize(void)
+    {
+        std::lock_guard<std::mutex> __lock(writer);
+        reclaim();
+    }
+};
+
+#endif
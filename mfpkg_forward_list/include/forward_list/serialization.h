@@ -0,0 +1,493 @@
+/**
+ * @file serialization.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+/**
+ *  @brief Customization point describing how one element is stored.
+ *
+ *  The primary template handles trivially copyable types by copying
+ *  their bytes.  Other types specialize it with
+ *
+ *      template <typename _Sink>   static void write(_Sink&, const _Tp&);
+ *      template <typename _Source> static _Tp read(_Source&);
+ *
+ *  where a sink provides @c write(const void*, std::size_t) and a source
+ *  provides @c read(void*, std::size_t) and @c remaining(), an upper
+ *  bound on the bytes left.  Sources throw on short reads.
+ *  Specializations also declare @c trivial as false, since only the
+ *  primary template may be bulk loaded byte-wise.
+ *
+ *  A sink may keep a pointer to the bytes passed to write() instead of
+ *  copying them: the file descriptor sink does so for pieces of 256
+ *  bytes or more until its flush(), which runs after the last element.
+ *  write() must therefore be given memory that outlives the call, such
+ *  as the element itself, and never a local buffer.
+ *
+ *  Lengths read from the input are untrusted; a read() must check them
+ *  against remaining() or read in bounded pieces before allocating.
+ */
+template <typename _Tp>
+struct mfpkg::serializer
+{
+    static_assert(std::is_trivially_copyable<_Tp>::value,
+                  "mfpkg::serializer must be specialized for this type");
+
+    static constexpr bool trivial = true;
+
+    template <typename _Sink>
+    static void write(_Sink& __out, const _Tp& __x)
+    {
+        __out.write(std::addressof(__x), sizeof(_Tp));
+    }
+};
+
+template <>
+struct mfpkg::serializer<std::string>
+{
+    static constexpr bool trivial = false;
+
+    template <typename _Sink>
+    static void write(_Sink& __out, const std::string& __s)
+    {
+        std::uint64_t __n = __s.size();
+        __out.write(&__n, sizeof __n);
+        __out.write(__s.data(), __s.size());
+    }
+
+    template <typename _Source>
+    static std::string read(_Source& __in)
+    {
+        std::uint64_t __n;
+        __in.read(&__n, sizeof __n);
+        if(__n > __in.remaining())
+        {
+            throw std::ios_base::failure("mfpkg::deserialize: string longer than the input");
+        }
+        std::string __s;
+        while (__s.size() < __n)
+        {
+            std::size_t __at = __s.size();
+            __s.resize(__at + std::size_t(std::min<std::uint64_t>(__n - __at, 64 * 1024)));
+            __in.read(&__s[__at], __s.size() - __at);
+        }
+        return __s;
+    }
+};
+
+/**
+ *  Reading and writing of whole lists.  The stream starts with the magic
+ *  "MFPKGFL", a format version byte, the element width (sizeof(_Tp) for
+ *  trivial serializers, zero otherwise) and the element count, followed
+ *  by the elements.  Integers are stored in native byte order.
+ */
+struct basic_mfpkg::list_io
+{
+    static constexpr char magic[8] = {'M', 'F', 'P', 'K', 'G', 'F', 'L', 1};
+
+    /**
+     * remaining() of a source whose size is not known.
+     */
+    static constexpr std::uint64_t unknown = ~std::uint64_t(0);
+
+    /**
+     * Most nodes load() puts in one node block.
+     */
+    static constexpr std::size_t load_block = 64 * 1024;
+
+    struct header
+    {
+        char magic[8];
+        std::uint64_t width;
+        std::uint64_t count;
+    };
+
+    template <typename _Tp>
+    static constexpr std::uint64_t width(void) noexcept
+    {
+        return mfpkg::serializer<_Tp>::trivial ? sizeof(_Tp) : 0;
+    }
+
+    static void fail(const char* __what)
+    {
+        throw std::ios_base::failure(__what);
+    }
+
+    class ostream_sink
+    {
+    private:
+
+        std::ostream& out;
+
+    public:
+
+        explicit ostream_sink(std::ostream& __out) noexcept : out(__out) { }
+
+        void write(const void* __p, std::size_t __n)
+        {
+            if(!out.write(static_cast<const char*>(__p), std::streamsize(__n)))
+            {
+                fail("mfpkg::serialize: write failed");
+            }
+        }
+
+        void flush(void) { }
+    };
+
+    /**
+     * Reader over an std::istream.  The size of a seekable stream is
+     * measured up front; other streams report unknown.
+     */
+    class istream_source
+    {
+    private:
+
+        std::istream& in;
+        std::uint64_t left;
+
+    public:
+
+        explicit istream_source(std::istream& __in) : in(__in), left(unknown)
+        {
+            std::istream::pos_type __here = in.tellg();
+            if(__here == std::istream::pos_type(-1))
+            {
+                return;
+            }
+            if(in.seekg(0, std::ios_base::end))
+            {
+                std::istream::pos_type __end = in.tellg();
+                if(__end != std::istream::pos_type(-1) && __end >= __here)
+                {
+                    left = std::uint64_t(__end - __here);
+                }
+            }
+            in.clear();
+            in.seekg(__here);
+        }
+
+        void read(void* __p, std::size_t __n)
+        {
+            if(!in.read(static_cast<char*>(__p), std::streamsize(__n)))
+            {
+                fail("mfpkg::deserialize: unexpected end of stream");
+            }
+            if(left != unknown)
+            {
+                left -= std::min<std::uint64_t>(left, __n);
+            }
+        }
+
+        std::uint64_t remaining(void) const noexcept
+        {
+            return left;
+        }
+    };
+
+#if defined(MFPKG_HAS_FD_IO)
+
+    /**
+     * Gathers writes into iovec batches submitted with writev().  Small
+     * pieces are copied into a staging buffer; pieces of at least
+     * direct_size bytes are referenced in place and must stay alive until
+     * flush().
+     */
+    class fd_sink
+    {
+    private:
+
+        static constexpr std::size_t staging_size = 64 * 1024;
+        static constexpr std::size_t direct_size = 256;
+        static constexpr int batch = 1024;
+
+        int fd;
+        int used;
+        std::size_t staged;
+        struct iovec iov[batch];
+        char staging[staging_size];
+
+    public:
+
+        explicit fd_sink(int __fd) noexcept : fd(__fd), used(0), staged(0) { }
+
+        void write(const void* __p, std::size_t __n)
+        {
+            if(__n >= direct_size)
+            {
+                if(used == batch)
+                {
+                    flush();
+                }
+                iov[used++] = {const_cast<void*>(__p), __n};
+                return;
+            }
+            if(staged + __n > staging_size || used == batch)
+            {
+                flush();
+            }
+            char* __to = staging + staged;
+            std::memcpy(__to, __p, __n);
+            staged += __n;
+            if(used && static_cast<char*>(iov[used - 1].iov_base) + iov[used - 1].iov_len == __to)
+            {
+                iov[used - 1].iov_len += __n;
+            }
+            else
+            {
+                iov[used++] = {__to, __n};
+            }
+        }
+
+        void flush(void)
+        {
+            struct iovec* __v = iov;
+            int __left = used;
+            while (__left)
+            {
+                ssize_t __k = ::writev(fd, __v, __left);
+                if(__k < 0)
+                {
+                    if(errno == EINTR)
+                    {
+                        continue;
+                    }
+                    fail("mfpkg::serialize: writev failed");
+                }
+                std::size_t __done = std::size_t(__k);
+                for (; __left && __done >= __v->iov_len; ++__v, --__left)
+                {
+                    __done -= __v->iov_len;
+                }
+                if(__left)
+                {
+                    __v->iov_base = static_cast<char*>(__v->iov_base) + __done;
+                    __v->iov_len -= __done;
+                }
+            }
+            used = 0;
+            staged = 0;
+        }
+    };
+
+    /**
+     * Buffered reader over a file descriptor.  Reads larger than the
+     * buffer go straight to their destination.  Only regular files
+     * report their remaining size.
+     */
+    class fd_source
+    {
+    private:
+
+        static constexpr std::size_t buffer_size = 64 * 1024;
+
+        int fd;
+        std::size_t first;
+        std::size_t last;
+        std::uint64_t left;
+        char buffer[buffer_size];
+
+        std::size_t fill(char* __to, std::size_t __n)
+        {
+            for (;;)
+            {
+                ssize_t __k = ::read(fd, __to, __n);
+                if(__k >= 0)
+                {
+                    return std::size_t(__k);
+                }
+                if(errno != EINTR)
+                {
+                    fail("mfpkg::deserialize: read failed");
+                }
+            }
+        }
+
+    public:
+
+        explicit fd_source(int __fd) noexcept : fd(__fd), first(0), last(0), left(unknown)
+        {
+            struct stat __st;
+            off_t __here = ::lseek(fd, 0, SEEK_CUR);
+            if(__here >= 0 && ::fstat(fd, &__st) == 0 && S_ISREG(__st.st_mode))
+            {
+                left = __st.st_size > __here ? std::uint64_t(__st.st_size - __here) : 0;
+            }
+        }
+
+        std::uint64_t remaining(void) const noexcept
+        {
+            return left;
+        }
+
+        void read(void* __p, std::size_t __n)
+        {
+            if(left != unknown)
+            {
+                left -= std::min<std::uint64_t>(left, __n);
+            }
+            char* __to = static_cast<char*>(__p);
+            for (;;)
+            {
+                std::size_t __k = std::min(__n, last - first);
+                std::memcpy(__to, buffer + first, __k);
+                first += __k;
+                __to += __k;
+                __n -= __k;
+                if(!__n)
+                {
+                    return;
+                }
+                std::size_t __got;
+                if(__n >= buffer_size)
+                {
+                    __got = fill(__to, __n);
+                    __to += __got;
+                    __n -= __got;
+                    if(!__n)
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    first = 0;
+                    last = __got = fill(buffer, buffer_size);
+                }
+                if(!__got)
+                {
+                    fail("mfpkg::deserialize: unexpected end of file");
+                }
+            }
+        }
+    };
+
+#endif
+
+    template <typename _Tp, typename _Policy, typename _Sink>
+    static void save(const mfpkg::forward_list<_Tp, _Policy>& __list, _Sink& __out)
+    {
+        header __h {{}, width<_Tp>(), __list.size()};
+        std::memcpy(__h.magic, magic, sizeof magic);
+        __out.write(&__h, sizeof __h);
+        for (const _Tp& __x : __list)
+        {
+            mfpkg::serializer<_Tp>::write(__out, __x);
+        }
+        __out.flush();
+    }
+
+    /**
+     * Trivial elements are read straight into node blocks of at most
+     * load_block nodes, so a corrupt count from an input of unknown size
+     * fails at its end instead of allocating up front; the others are
+     * read one at a time through their serializer.  A count larger than
+     * a source of known size can hold is rejected before any allocation.
+     */
+    template <typename _Tp, typename _Source>
+    static mfpkg::forward_list<_Tp> load(_Source& __in)
+    {
+        header __h;
+        __in.read(&__h, sizeof __h);
+        if(std::memcmp(__h.magic, magic, sizeof magic))
+        {
+            fail("mfpkg::deserialize: not a serialized list");
+        }
+        if(__h.width != width<_Tp>())
+        {
+            fail("mfpkg::deserialize: element type mismatch");
+        }
+        if(__h.width && __h.count > __in.remaining() / __h.width)
+        {
+            fail("mfpkg::deserialize: element count exceeds the input");
+        }
+        mfpkg::forward_list<_Tp> __list;
+        if constexpr (mfpkg::serializer<_Tp>::trivial)
+        {
+            for (std::uint64_t __left = __h.count; __left; )
+            {
+                std::size_t __k = std::size_t(std::min<std::uint64_t>(__left, load_block));
+                __list.object.append_block(__k, [&](void* __p)
+                {
+                    __in.read(__p, sizeof(_Tp));
+                });
+                __left -= __k;
+            }
+        }
+        else
+        {
+            auto __pos = __list.before_begin();
+            for (std::uint64_t __i = 0; __i < __h.count; ++__i)
+            {
+                __pos = __list.insert_after(__pos, mfpkg::serializer<_Tp>::read(__in));
+            }
+        }
+        return __list;
+    }
+};
+
+/**
+ *  @brief Writes @a __list to @a __out in the binary list format.
+ *
+ *  Throws std::ios_base::failure if the stream fails.
+ */
+template <typename _Tp, typename _Policy>
+void mfpkg::serialize(const forward_list<_Tp, _Policy>& __list, std::ostream& __out)
+{
+    basic_mfpkg::list_io::ostream_sink __sink(__out);
+    basic_mfpkg::list_io::save(__list, __sink);
+}
+
+/**
+ *  @brief Reads a %list written by serialize() from @a __in.
+ *
+ *  Throws std::ios_base::failure on truncated or mismatched input.
+ *  Trivially copyable elements are read into node blocks, which are
+ *  freed only once every node in them has been erased, as after
+ *  forward_list::defragment().
+ */
+template <typename _Tp>
+mfpkg::forward_list<_Tp> mfpkg::deserialize(std::istream& __in)
+{
+    basic_mfpkg::list_io::istream_source __source(__in);
+    return basic_mfpkg::list_io::load<_Tp>(__source);
+}
+
+#if defined(MFPKG_HAS_FD_IO)
+
+/**
+ *  @brief Writes @a __list to the file descriptor @a __fd.
+ *
+ *  The elements are gathered into writev() batches of up to 1024 pieces,
+ *  so a %list is written in a few system calls per megabyte.
+ */
+template <typename _Tp, typename _Policy>
+void mfpkg::serialize(const forward_list<_Tp, _Policy>& __list, int __fd)
+{
+    std::unique_ptr<basic_mfpkg::list_io::fd_sink> __sink(
+        new basic_mfpkg::list_io::fd_sink(__fd));
+    basic_mfpkg::list_io::save(__list, *__sink);
+}
+
+/**
+ *  @brief Reads a %list written by serialize() from the file descriptor @a __fd.
+ *
+ *  Trivially copyable elements are read into blocks of nodes, each freed
+ *  only once every node in it has been erased.  Throws
+ *  std::ios_base::failure on truncated or mismatched input.  The
+ *  descriptor may be left past the end of the %list.
+ */
+template <typename _Tp>
+mfpkg::forward_list<_Tp> mfpkg::deserialize(int __fd)
+{
+    std::unique_ptr<basic_mfpkg::list_io::fd_source> __source(
+        new basic_mfpkg::list_io::fd_source(__fd));
+    return basic_mfpkg::list_io::load<_Tp>(*__source);
+}
+
+#endif
+
+#endif
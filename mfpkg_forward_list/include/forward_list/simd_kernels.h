@@ -0,0 +1,417 @@
+/**
+ * @file simd_kernels.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+/**
+ *  Search and reduction kernels over a block of up to @c block elements
+ *  that a %list has copied out of its nodes.  Following the links is left
+ *  to the caller; comparing and reducing the copied payloads then takes
+ *  a few vector instructions instead of one branch per node.
+ *
+ *  On x86 the instruction set is chosen once at run time, AVX2 when the
+ *  processor has it and SSE2 otherwise.  Other targets, element types
+ *  without a kernel and builds defining MFPKG_NO_SIMD use scalar loops
+ *  with the same results, except that float sums may round differently
+ *  since their terms are added in another order.  The result of min()
+ *  and max() is unspecified when the block holds a NaN.
+ */
+struct basic_mfpkg::simd_kernels
+{
+    static constexpr std::size_t block = 64;
+
+    enum class isa
+    {
+        scalar,
+        sse2,
+        avx2
+    };
+
+    /**
+     * Element types handled by equal_mask().
+     */
+    template <typename _Tp>
+    static constexpr bool compares = std::is_arithmetic<_Tp>::value && !std::is_same<_Tp, bool>::value
+                                     && (sizeof(_Tp) == 4 || sizeof(_Tp) == 8);
+
+    /**
+     * Element types handled by sum(), min() and max().
+     */
+    template <typename _Tp>
+    static constexpr bool reduces = std::is_same<_Tp, int>::value || std::is_same<_Tp, float>::value
+                                    || std::is_same<_Tp, double>::value;
+
+    static isa level(void) noexcept
+    {
+#if defined(MFPKG_HAS_X86_SIMD)
+        static const isa __level = []
+        {
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2"))
+            {
+                return isa::avx2;
+            }
+            return __builtin_cpu_supports("sse2") ? isa::sse2 : isa::scalar;
+        }();
+        return __level;
+#else
+        return isa::scalar;
+#endif
+    }
+
+    /**
+     * Returns a mask with bit @a i set when @a __p[i] == @a __v.
+     */
+    template <typename _Tp>
+    static std::uint64_t equal_mask(const _Tp* __p, std::size_t __n, _Tp __v) noexcept
+    {
+#if defined(MFPKG_HAS_X86_SIMD)
+        if constexpr (compares<_Tp>)
+        {
+            switch (level())
+            {
+                case isa::avx2:
+                    return equal_mask_avx2(__p, __n, __v);
+                case isa::sse2:
+                    return equal_mask_sse2(__p, __n, __v);
+                default:
+                    break;
+            }
+        }
+#endif
+        return equal_mask_scalar(__p, __n, __v, 0);
+    }
+
+    template <typename _Tp>
+    static _Tp sum(const _Tp* __p, std::size_t __n) noexcept
+    {
+        return reduce<plus>(__p, __n);
+    }
+
+    /**
+     * Requires @a __n > 0, as do max().
+     */
+    template <typename _Tp>
+    static _Tp min(const _Tp* __p, std::size_t __n) noexcept
+    {
+        return reduce<lesser>(__p, __n);
+    }
+
+    template <typename _Tp>
+    static _Tp max(const _Tp* __p, std::size_t __n) noexcept
+    {
+        return reduce<greater>(__p, __n);
+    }
+
+private:
+
+    template <typename _Tp>
+    static std::uint64_t equal_mask_scalar(const _Tp* __p, std::size_t __n, _Tp __v, std::size_t __i) noexcept
+    {
+        std::uint64_t __m = 0;
+        for (; __i < __n; ++__i)
+        {
+            if(__p[__i] == __v)
+            {
+                __m |= std::uint64_t(1) << __i;
+            }
+        }
+        return __m;
+    }
+
+    template <typename _Op, typename _Tp>
+    static _Tp reduce_scalar(const _Tp* __p, std::size_t __n) noexcept
+    {
+        _Tp __r = __p[0];
+        for (std::size_t __i = 1; __i < __n; ++__i)
+        {
+            __r = _Op::apply(__r, __p[__i]);
+        }
+        return __r;
+    }
+
+    template <typename _Op, typename _Tp>
+    static _Tp reduce(const _Tp* __p, std::size_t __n) noexcept
+    {
+        if(!__n)
+        {
+            return _Tp();
+        }
+#if defined(MFPKG_HAS_X86_SIMD)
+        if constexpr (reduces<_Tp>)
+        {
+            switch (level())
+            {
+                case isa::avx2:
+                    return reduce_avx2<_Op>(__p, __n);
+                case isa::sse2:
+                    return reduce_sse2<_Op>(__p, __n);
+                default:
+                    break;
+            }
+        }
+#endif
+        return reduce_scalar<_Op>(__p, __n);
+    }
+
+#if defined(MFPKG_HAS_X86_SIMD)
+
+    template <typename _Tp>
+    MFPKG_TARGET("sse2")
+    static std::uint64_t equal_mask_sse2(const _Tp* __p, std::size_t __n, _Tp __v) noexcept
+    {
+        std::uint64_t __m = 0;
+        std::size_t __i = 0;
+        if constexpr (std::is_same<_Tp, float>::value)
+        {
+            const __m128 __k = _mm_set1_ps(__v);
+            for (; __i + 4 <= __n; __i += 4)
+            {
+                __m128 __eq = _mm_cmpeq_ps(_mm_loadu_ps(__p + __i), __k);
+                __m |= std::uint64_t(_mm_movemask_ps(__eq)) << __i;
+            }
+        }
+        else if constexpr (std::is_same<_Tp, double>::value)
+        {
+            const __m128d __k = _mm_set1_pd(__v);
+            for (; __i + 2 <= __n; __i += 2)
+            {
+                __m128d __eq = _mm_cmpeq_pd(_mm_loadu_pd(__p + __i), __k);
+                __m |= std::uint64_t(_mm_movemask_pd(__eq)) << __i;
+            }
+        }
+        else if constexpr (sizeof(_Tp) == 4)
+        {
+            const __m128i __k = _mm_set1_epi32(std::int32_t(__v));
+            for (; __i + 4 <= __n; __i += 4)
+            {
+                __m128i __eq = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(__p + __i)), __k);
+                __m |= std::uint64_t(_mm_movemask_ps(_mm_castsi128_ps(__eq))) << __i;
+            }
+        }
+        /* SSE2 has no 64-bit integer compare. */
+        return __m | equal_mask_scalar(__p, __n, __v, __i);
+    }
+
+    template <typename _Tp>
+    MFPKG_TARGET("avx2")
+    static std::uint64_t equal_mask_avx2(const _Tp* __p, std::size_t __n, _Tp __v) noexcept
+    {
+        std::uint64_t __m = 0;
+        std::size_t __i = 0;
+        if constexpr (std::is_same<_Tp, float>::value)
+        {
+            const __m256 __k = _mm256_set1_ps(__v);
+            for (; __i + 8 <= __n; __i += 8)
+            {
+                __m256 __eq = _mm256_cmp_ps(_mm256_loadu_ps(__p + __i), __k, _CMP_EQ_OQ);
+                __m |= std::uint64_t(_mm256_movemask_ps(__eq)) << __i;
+            }
+        }
+        else if constexpr (std::is_same<_Tp, double>::value)
+        {
+            const __m256d __k = _mm256_set1_pd(__v);
+            for (; __i + 4 <= __n; __i += 4)
+            {
+                __m256d __eq = _mm256_cmp_pd(_mm256_loadu_pd(__p + __i), __k, _CMP_EQ_OQ);
+                __m |= std::uint64_t(_mm256_movemask_pd(__eq)) << __i;
+            }
+        }
+        else if constexpr (sizeof(_Tp) == 4)
+        {
+            const __m256i __k = _mm256_set1_epi32(std::int32_t(__v));
+            for (; __i + 8 <= __n; __i += 8)
+            {
+                __m256i __eq = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(__p + __i)), __k);
+                __m |= std::uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(__eq))) << __i;
+            }
+        }
+        else
+        {
+            const __m256i __k = _mm256_set1_epi64x(std::int64_t(__v));
+            for (; __i + 4 <= __n; __i += 4)
+            {
+                __m256i __eq = _mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(__p + __i)), __k);
+                __m |= std::uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(__eq))) << __i;
+            }
+        }
+        return __m | equal_mask_scalar(__p, __n, __v, __i);
+    }
+
+    /**
+     * Loads and stores of one vector register of _Tp.
+     */
+    template <typename _Tp> struct sse2_lanes;
+    template <typename _Tp> struct avx2_lanes;
+
+    /**
+     * Accumulates one vector register at a time, then folds the lanes and
+     * the elements left over.  The loop is spelled out once per target so
+     * that the SSE2 path never carries AVX encodings.
+     */
+#define MFPKG_REDUCE_LANES(_Lanes)                              \
+        constexpr std::size_t __w = _Lanes::width;              \
+        if(__n < 2 * __w)                                       \
+        {                                                       \
+            return reduce_scalar<_Op>(__p, __n);                \
+        }                                                       \
+        auto __acc = _Lanes::load(__p);                         \
+        std::size_t __i = __w;                                  \
+        for (; __i + __w <= __n; __i += __w)                    \
+        {                                                       \
+            __acc = _Op::apply(__acc, _Lanes::load(__p + __i)); \
+        }                                                       \
+        _Tp __lanes[__w];                                       \
+        _Lanes::store(__lanes, __acc);                          \
+        _Tp __r = reduce_scalar<_Op>(__lanes, __w);             \
+        for (; __i < __n; ++__i)                                \
+        {                                                       \
+            __r = _Op::apply(__r, __p[__i]);                    \
+        }                                                       \
+        return __r;
+
+    template <typename _Op, typename _Tp>
+    MFPKG_TARGET("sse2")
+    static _Tp reduce_sse2(const _Tp* __p, std::size_t __n) noexcept
+    {
+        MFPKG_REDUCE_LANES(sse2_lanes<_Tp>)
+    }
+
+    template <typename _Op, typename _Tp>
+    MFPKG_TARGET("avx2")
+    static _Tp reduce_avx2(const _Tp* __p, std::size_t __n) noexcept
+    {
+        MFPKG_REDUCE_LANES(avx2_lanes<_Tp>)
+    }
+
+#undef MFPKG_REDUCE_LANES
+
+#endif
+
+    struct plus
+    {
+        template <typename _Tp>
+        static _Tp apply(_Tp __a, _Tp __b) noexcept
+        {
+            return __a + __b;
+        }
+
+#if defined(MFPKG_HAS_X86_SIMD)
+        MFPKG_TARGET("sse2") static __m128 apply(__m128 __a, __m128 __b) noexcept { return _mm_add_ps(__a, __b); }
+        MFPKG_TARGET("sse2") static __m128d apply(__m128d __a, __m128d __b) noexcept { return _mm_add_pd(__a, __b); }
+        MFPKG_TARGET("sse2") static __m128i apply(__m128i __a, __m128i __b) noexcept { return _mm_add_epi32(__a, __b); }
+        MFPKG_TARGET("avx2") static __m256 apply(__m256 __a, __m256 __b) noexcept { return _mm256_add_ps(__a, __b); }
+        MFPKG_TARGET("avx2") static __m256d apply(__m256d __a, __m256d __b) noexcept { return _mm256_add_pd(__a, __b); }
+        MFPKG_TARGET("avx2") static __m256i apply(__m256i __a, __m256i __b) noexcept { return _mm256_add_epi32(__a, __b); }
+#endif
+    };
+
+    struct lesser
+    {
+        template <typename _Tp>
+        static _Tp apply(_Tp __a, _Tp __b) noexcept
+        {
+            return __b < __a ? __b : __a;
+        }
+
+#if defined(MFPKG_HAS_X86_SIMD)
+        MFPKG_TARGET("sse2") static __m128 apply(__m128 __a, __m128 __b) noexcept { return _mm_min_ps(__a, __b); }
+        MFPKG_TARGET("sse2") static __m128d apply(__m128d __a, __m128d __b) noexcept { return _mm_min_pd(__a, __b); }
+        MFPKG_TARGET("sse2") static __m128i apply(__m128i __a, __m128i __b) noexcept
+        {
+            /* SSE2 has no 32-bit integer min. */
+            __m128i __lt = _mm_cmplt_epi32(__b, __a);
+            return _mm_or_si128(_mm_and_si128(__lt, __b), _mm_andnot_si128(__lt, __a));
+        }
+        MFPKG_TARGET("avx2") static __m256 apply(__m256 __a, __m256 __b) noexcept { return _mm256_min_ps(__a, __b); }
+        MFPKG_TARGET("avx2") static __m256d apply(__m256d __a, __m256d __b) noexcept { return _mm256_min_pd(__a, __b); }
+        MFPKG_TARGET("avx2") static __m256i apply(__m256i __a, __m256i __b) noexcept { return _mm256_min_epi32(__a, __b); }
+#endif
+    };
+
+    struct greater
+    {
+        template <typename _Tp>
+        static _Tp apply(_Tp __a, _Tp __b) noexcept
+        {
+            return __a < __b ? __b : __a;
+        }
+
+#if defined(MFPKG_HAS_X86_SIMD)
+        MFPKG_TARGET("sse2") static __m128 apply(__m128 __a, __m128 __b) noexcept { return _mm_max_ps(__a, __b); }
+        MFPKG_TARGET("sse2") static __m128d apply(__m128d __a, __m128d __b) noexcept { return _mm_max_pd(__a, __b); }
+        MFPKG_TARGET("sse2") static __m128i apply(__m128i __a, __m128i __b) noexcept
+        {
+            __m128i __gt = _mm_cmpgt_epi32(__b, __a);
+            return _mm_or_si128(_mm_and_si128(__gt, __b), _mm_andnot_si128(__gt, __a));
+        }
+        MFPKG_TARGET("avx2") static __m256 apply(__m256 __a, __m256 __b) noexcept { return _mm256_max_ps(__a, __b); }
+        MFPKG_TARGET("avx2") static __m256d apply(__m256d __a, __m256d __b) noexcept { return _mm256_max_pd(__a, __b); }
+        MFPKG_TARGET("avx2") static __m256i apply(__m256i __a, __m256i __b) noexcept { return _mm256_max_epi32(__a, __b); }
+#endif
+    };
+};
+
+#if defined(MFPKG_HAS_X86_SIMD)
+
+template <> struct basic_mfpkg::simd_kernels::sse2_lanes<float>
+{
+    static constexpr std::size_t width = 4;
+    MFPKG_TARGET("sse2") static __m128 load(const float* __p) noexcept { return _mm_loadu_ps(__p); }
+    MFPKG_TARGET("sse2") static void store(float* __p, __m128 __v) noexcept { _mm_storeu_ps(__p, __v); }
+};
+
+template <> struct basic_mfpkg::simd_kernels::sse2_lanes<double>
+{
+    static constexpr std::size_t width = 2;
+    MFPKG_TARGET("sse2") static __m128d load(const double* __p) noexcept { return _mm_loadu_pd(__p); }
+    MFPKG_TARGET("sse2") static void store(double* __p, __m128d __v) noexcept { _mm_storeu_pd(__p, __v); }
+};
+
+template <> struct basic_mfpkg::simd_kernels::sse2_lanes<int>
+{
+    static constexpr std::size_t width = 4;
+    MFPKG_TARGET("sse2") static __m128i load(const int* __p) noexcept
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(__p));
+    }
+    MFPKG_TARGET("sse2") static void store(int* __p, __m128i __v) noexcept
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(__p), __v);
+    }
+};
+
+template <> struct basic_mfpkg::simd_kernels::avx2_lanes<float>
+{
+    static constexpr std::size_t width = 8;
+    MFPKG_TARGET("avx2") static __m256 load(const float* __p) noexcept { return _mm256_loadu_ps(__p); }
+    MFPKG_TARGET("avx2") static void store(float* __p, __m256 __v) noexcept { _mm256_storeu_ps(__p, __v); }
+};
+
+template <> struct basic_mfpkg::simd_kernels::avx2_lanes<double>
+{
+    static constexpr std::size_t width = 4;
+    MFPKG_TARGET("avx2") static __m256d load(const double* __p) noexcept { return _mm256_loadu_pd(__p); }
+    MFPKG_TARGET("avx2") static void store(double* __p, __m256d __v) noexcept { _mm256_storeu_pd(__p, __v); }
+};
+
+template <> struct basic_mfpkg::simd_kernels::avx2_lanes<int>
+{
+    static constexpr std::size_t width = 8;
+    MFPKG_TARGET("avx2") static __m256i load(const int* __p) noexcept
+    {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(__p));
+    }
+    MFPKG_TARGET("avx2") static void store(int* __p, __m256i __v) noexcept
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(__p), __v);
+    }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,551 @@
+/**
+ *  @brief A sorted singly linked %list indexed by a skip list.
+ *
+ *  @tparam _Tp       Type of element.
+ *  @tparam _Compare  Strict weak ordering of _Tp.
+ *
+ *  The elements form an ordinary node_base chain in ascending order, so
+ *  a %sorted_forward_list iterates exactly like mfpkg::forward_list.  On
+ *  top of it every node carries a tower of express links of random
+ *  height (each level holding about a quarter of the nodes of the level
+ *  below), which gives expected logarithmic insert(), erase(),
+ *  lower_bound(), upper_bound(), find() and contains().
+ *
+ *  Equal elements are kept in insertion order.  Only const iterators
+ *  are provided, since changing an element in place could break the
+ *  order.
+ *
+ *  @file sorted_forward_list.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef SORTED_FORWARD_LIST_H
+#define SORTED_FORWARD_LIST_H
+
+template <typename _Tp, typename _Compare>
+class mfpkg::sorted_forward_list : public basic_mfpkg::basic_forward_list
+{
+private:
+
+    typedef sorted_forward_list<_Tp, _Compare> _Self;
+
+    static constexpr unsigned max_level = 24;
+
+    /**
+     * A node followed by up[0 .. height - 2], its links on levels
+     * 1 .. height - 1.  The tower is allocated in the same block.
+     */
+    struct skip_node : node<_Tp>
+    {
+        unsigned height;
+        node_base* up[1];
+    };
+
+    node_base start;
+    node_base* head_up[max_level - 1];
+    node_base* finish;
+    std::size_t count;
+    unsigned level;
+    std::uint64_t seed;
+    _Compare comp;
+
+    static std::size_t node_bytes(unsigned __height) noexcept
+    {
+        return sizeof(skip_node) + (__height > 2 ? __height - 2 : 0) * sizeof(node_base*);
+    }
+
+    static constexpr bool over_aligned_node(void) noexcept
+    {
+        return alignof(skip_node) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+    }
+
+    /**
+     * Skip nodes come in a few sizes, all of which fit node_cache.
+     */
+    static void* node_memory(unsigned __height) noexcept
+    {
+        const std::size_t __bytes = node_bytes(__height);
+        if constexpr (over_aligned_node())
+        {
+            return ::operator new(__bytes, std::align_val_t(alignof(skip_node)), std::nothrow);
+        }
+        else
+        {
+            if(basic_mfpkg::node_cache::cached(__bytes, alignof(skip_node)))
+            {
+                return basic_mfpkg::node_cache::allocate(__bytes);
+            }
+            return ::operator new(__bytes, std::nothrow);
+        }
+    }
+
+    static void free_memory(void* __p, unsigned __height) noexcept
+    {
+        const std::size_t __bytes = node_bytes(__height);
+        if constexpr (over_aligned_node())
+        {
+            ::operator delete(__p, std::align_val_t(alignof(skip_node)));
+        }
+        else
+        {
+            if(basic_mfpkg::node_cache::cached(__bytes, alignof(skip_node)))
+            {
+                basic_mfpkg::node_cache::deallocate(__p, __bytes);
+                return;
+            }
+            ::operator delete(__p);
+        }
+    }
+
+    static void put_node(node_base* __n) noexcept
+    {
+        skip_node* __node = static_cast<skip_node*>(__n);
+        const unsigned __height = __node->height;
+        __node->~skip_node();
+        free_memory(__node, __height);
+    }
+
+    void exit(const char* __msg) noexcept
+    {
+        std::cerr << __msg << " : Out of memory" << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+
+    template <typename _Arg>
+    skip_node* get_node(_Arg&& __val, unsigned __height)
+    {
+        void* __p = node_memory(__height);
+        if(!__p)
+        {
+            clear();
+            exit(__PRETTY_FUNCTION__);
+        }
+        skip_node* __node;
+        try
+        {
+            __node = ::new (__p) skip_node{{{nullptr}, std::forward<_Arg>(__val)}, __height, {nullptr}};
+        }
+        catch (...)
+        {
+            free_memory(__p, __height);
+            throw;
+        }
+        for (unsigned __i = 1; __i < __height; ++__i)
+        {
+            __node->up[__i - 1] = nullptr;
+        }
+        return __node;
+    }
+
+    /**
+     * Link of @a __x on @a __lvl, where @a __x is a node or the head.
+     */
+    node_base*& next(node_base* __x, unsigned __lvl) noexcept
+    {
+        if(!__lvl)
+        {
+            return __x->link;
+        }
+        return __x == &start ? head_up[__lvl - 1] : static_cast<skip_node*>(__x)->up[__lvl - 1];
+    }
+
+    const node_base* next(const node_base* __x, unsigned __lvl) const noexcept
+    {
+        return const_cast<_Self*>(this)->next(const_cast<node_base*>(__x), __lvl);
+    }
+
+    static const _Tp& value(const node_base* __x) noexcept
+    {
+        return static_cast<const node<_Tp>*>(__x)->storage;
+    }
+
+    /**
+     * Geometric height with p = 1/4, from a xorshift generator.
+     */
+    unsigned random_height(void) noexcept
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        unsigned __h = 1 + unsigned(__builtin_ctzll(seed | (std::uint64_t(1) << 62))) / 2;
+        return std::min(__h, max_level);
+    }
+
+    /**
+     * Fills @a __update with the last node on each level for which
+     * @a __before holds, so that its successor does not satisfy it.
+     */
+    template <typename _Before>
+    void search(node_base** __update, _Before __before) noexcept
+    {
+        node_base* __x = &start;
+        for (unsigned __i = level; __i-- > 0; )
+        {
+            for (node_base* __n = next(__x, __i); __n && __before(value(__n)); __n = next(__x, __i))
+            {
+                __x = __n;
+            }
+            __update[__i] = __x;
+        }
+    }
+
+    template <typename _Before>
+    const node_base* search(_Before __before) const noexcept
+    {
+        const node_base* __x = &start;
+        for (unsigned __i = level; __i-- > 0; )
+        {
+            for (const node_base* __n = next(__x, __i); __n && __before(value(__n)); __n = next(__x, __i))
+            {
+                __x = __n;
+            }
+        }
+        return __x;
+    }
+
+    /**
+     * Links @a __node after the predecessors in @a __update.
+     */
+    void link(skip_node* __node, node_base** __update) noexcept
+    {
+        for (unsigned __i = level; __i < __node->height; ++__i)
+        {
+            __update[__i] = &start;
+        }
+        level = std::max(level, __node->height);
+        for (unsigned __i = 0; __i < __node->height; ++__i)
+        {
+            next(__node, __i) = next(__update[__i], __i);
+            next(__update[__i], __i) = __node;
+        }
+        if(!__node->link)
+        {
+            finish = __node;
+        }
+        ++count;
+    }
+
+    void unlink(node_base* __node, node_base** __update) noexcept
+    {
+        const unsigned __height = static_cast<skip_node*>(__node)->height;
+        for (unsigned __i = 0; __i < __height; ++__i)
+        {
+            next(__update[__i], __i) = next(__node, __i);
+        }
+        if(__node == finish)
+        {
+            finish = __update[0];
+        }
+        for (; level > 1 && !head_up[level - 2]; --level);
+        if(!start.link)
+        {
+            level = 1;
+        }
+        --count;
+        put_node(__node);
+    }
+
+    void reset(void) noexcept
+    {
+        start.link = nullptr;
+        std::fill(head_up, head_up + (max_level - 1), nullptr);
+        finish = &start;
+        count = 0;
+        level = 1;
+    }
+
+    /**
+     * Appends a sequence in ascending order, in linear time.  An element
+     * smaller than its predecessor is inserted normally instead.
+     */
+    template <typename _InputIt>
+    void append_sorted(_InputIt __first, _InputIt __last)
+    {
+        node_base* __tails[max_level];
+        node_base* __update[max_level];
+        search(__tails, [](const _Tp&) { return true; });
+        for (unsigned __i = level; __i < max_level; ++__i)
+        {
+            __tails[__i] = &start;
+        }
+        for (; __first != __last; ++__first)
+        {
+            if(count && comp(*__first, value(finish)))
+            {
+                insert(*__first);
+                search(__tails, [](const _Tp&) { return true; });
+                continue;
+            }
+            skip_node* __node = get_node(*__first, random_height());
+            std::copy(__tails, __tails + max_level, __update);
+            link(__node, __update);
+            for (unsigned __i = 0; __i < __node->height; ++__i)
+            {
+                __tails[__i] = __node;
+            }
+        }
+    }
+
+public:
+
+    typedef _Tp value_type;
+    typedef const _Tp& reference;
+    typedef const _Tp& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef basic_forward_list::const_iterator<_Tp> iterator;
+    typedef basic_forward_list::const_iterator<_Tp> const_iterator;
+
+    explicit sorted_forward_list(const _Compare& __comp = _Compare())
+    : seed(reinterpret_cast<std::uintptr_t>(this) | 1), comp(__comp)
+    {
+        reset();
+    }
+
+    sorted_forward_list(std::initializer_list<_Tp> __list, const _Compare& __comp = _Compare())
+    : sorted_forward_list(__comp)
+    {
+        for (auto& __x : __list)
+        {
+            insert(__x);
+        }
+    }
+
+    /**
+     * @brief Builds a %list from the elements of @a __list, which is
+     * expected to be sorted already; then the build is linear.
+     */
+    template <typename _Policy>
+    explicit sorted_forward_list(const mfpkg::forward_list<_Tp, _Policy>& __list,
+                                 const _Compare& __comp = _Compare())
+    : sorted_forward_list(__comp)
+    {
+        append_sorted(__list.begin(), __list.end());
+    }
+
+    sorted_forward_list(const _Self& __list) : sorted_forward_list(__list.comp)
+    {
+        append_sorted(__list.begin(), __list.end());
+    }
+
+    sorted_forward_list(_Self&& __list) noexcept : sorted_forward_list(__list.comp)
+    {
+        swap(__list);
+    }
+
+    ~sorted_forward_list() noexcept
+    {
+        clear();
+    }
+
+    _Self& operator=(const _Self& __list)
+    {
+        if(this != &__list)
+        {
+            _Self __copy(__list);
+            swap(__copy);
+        }
+        return *this;
+    }
+
+    _Self& operator=(_Self&& __list) noexcept
+    {
+        swap(__list);
+        return *this;
+    }
+
+    const_iterator before_begin(void) const noexcept
+    {
+        return &start;
+    }
+
+    const_iterator begin(void) const noexcept
+    {
+        return start.link;
+    }
+
+    const_iterator cbegin(void) const noexcept
+    {
+        return start.link;
+    }
+
+    const_iterator end(void) const noexcept
+    {
+        return nullptr;
+    }
+
+    const_iterator cend(void) const noexcept
+    {
+        return nullptr;
+    }
+
+    const_reference front(void) const noexcept
+    {
+        return value(start.link);
+    }
+
+    const_reference back(void) const noexcept
+    {
+        return value(finish);
+    }
+
+    bool empty(void) const noexcept
+    {
+        return !start.link;
+    }
+
+    size_type size(void) const noexcept
+    {
+        return count;
+    }
+
+    /**
+     * @brief Inserts @a __val after the elements equal to it.
+     * @return  An iterator to the new element.
+     */
+    const_iterator insert(const _Tp& __val)
+    {
+        node_base* __update[max_level];
+        search(__update, [&](const _Tp& __x) { return !comp(__val, __x); });
+        skip_node* __node = get_node(__val, random_height());
+        link(__node, __update);
+        return __node;
+    }
+
+    /**
+     * @brief Appends the elements of [__first, __last), expected in
+     * ascending order and not below back(); then the insertion is linear.
+     */
+    template <typename _InputIt>
+    void insert_sorted(_InputIt __first, _InputIt __last)
+    {
+        append_sorted(__first, __last);
+    }
+
+    /**
+     * @brief Returns an iterator to the first element not less than @a __val.
+     */
+    const_iterator lower_bound(const _Tp& __val) const noexcept
+    {
+        return search([&](const _Tp& __x) { return comp(__x, __val); })->link;
+    }
+
+    /**
+     * @brief Returns an iterator to the first element greater than @a __val.
+     */
+    const_iterator upper_bound(const _Tp& __val) const noexcept
+    {
+        return search([&](const _Tp& __x) { return !comp(__val, __x); })->link;
+    }
+
+    /**
+     * @brief Returns an iterator to the first element equivalent to
+     * @a __val, or end().
+     */
+    const_iterator find(const _Tp& __val) const noexcept
+    {
+        const node_base* __n = search([&](const _Tp& __x) { return comp(__x, __val); })->link;
+        return __n && !comp(__val, value(__n)) ? __n : nullptr;
+    }
+
+    bool contains(const _Tp& __val) const noexcept
+    {
+        return find(__val) != end();
+    }
+
+    /**
+     * @brief Removes the first element equivalent to @a __val.
+     * @return false if there is none.
+     */
+    bool erase(const _Tp& __val) noexcept
+    {
+        node_base* __update[max_level];
+        search(__update, [&](const _Tp& __x) { return comp(__x, __val); });
+        node_base* __n = __update[0]->link;
+        if(!__n || comp(__val, value(__n)))
+        {
+            return false;
+        }
+        unlink(__n, __update);
+        return true;
+    }
+
+    /**
+     * @brief Removes the element at @a __position.
+     * @return  An iterator to the following element.
+     */
+    const_iterator erase(const_iterator __position) noexcept
+    {
+        node_base* __target = const_cast<node_base*>(__position._M_node);
+        const _Tp& __val = value(__target);
+        node_base* __update[max_level];
+        search(__update, [&](const _Tp& __x) { return comp(__x, __val); });
+        // Step over the equivalent elements in front of the target.
+        for (node_base* __n = __update[0]->link; __n != __target; __n = __n->link)
+        {
+            for (unsigned __i = 0; __i < static_cast<skip_node*>(__n)->height; ++__i)
+            {
+                __update[__i] = __n;
+            }
+        }
+        node_base* __next = __target->link;
+        unlink(__target, __update);
+        return __next;
+    }
+
+    void pop_front(void) noexcept
+    {
+        if(!empty())
+        {
+            erase(begin());
+        }
+    }
+
+    /**
+     * @brief Removes every element equivalent to @a __val.
+     * @return  The number of elements removed.
+     */
+    size_type remove(const _Tp& __val) noexcept
+    {
+        size_type __n = 0;
+        node_base* __update[max_level];
+        search(__update, [&](const _Tp& __x) { return comp(__x, __val); });
+        for (node_base* __x = __update[0]->link; __x && !comp(__val, value(__x)); __x = __update[0]->link)
+        {
+            unlink(__x, __update);
+            ++__n;
+        }
+        return __n;
+    }
+
+    void clear(void) noexcept
+    {
+        for (node_base* __it = start.link; __it; )
+        {
+            node_base* __temp = __it;
+            __it = __it->link;
+            put_node(__temp);
+        }
+        reset();
+    }
+
+    void swap(_Self& __list) noexcept
+    {
+        std::swap(start, __list.start);
+        std::swap(head_up, __list.head_up);
+        std::swap(finish, __list.finish);
+        std::swap(count, __list.count);
+        std::swap(level, __list.level);
+        std::swap(comp, __list.comp);
+        for (_Self* __l : {this, &__list})
+        {
+            if(!__l->count)
+            {
+                __l->finish = &__l->start;
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,212 @@
+/** 
+ * @file task_pool.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+/**
+ *  Persistent pool of worker threads executing one indexed job at a time.
+ *  The calling thread takes part in every job as participant zero.  A job
+ *  submitted from inside a task runs inline on the submitting thread.
+ */
+class basic_mfpkg::task_pool
+{
+private:
+
+    struct alignas(64) task_range
+    {
+        std::atomic<std::size_t> next;
+        std::size_t end;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<task_range> ranges;
+    std::mutex submit;
+    std::mutex state;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(std::size_t)>* body;
+    std::size_t participants;
+    std::size_t active;
+    std::size_t generation;
+    std::exception_ptr error;
+    bool stopping;
+
+    /**
+     * True on a thread while it takes part in a job.
+     */
+    static bool& inside(void) noexcept
+    {
+        thread_local bool __inside = false;
+        return __inside;
+    }
+
+    bool run_one(std::size_t __owner)
+    {
+        task_range& __r = ranges[__owner];
+        std::size_t __k = __r.next.fetch_add(1, std::memory_order_relaxed);
+        if(__k >= __r.end)
+        {
+            return false;
+        }
+        try
+        {
+            (*body)(__k);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> __lock(state);
+            if(!error)
+            {
+                error = std::current_exception();
+            }
+        }
+        return true;
+    }
+
+    void participate(std::size_t __self)
+    {
+        while (run_one(__self));
+        for (std::size_t __i = 1; __i < participants; ++__i)
+        {
+            std::size_t __victim = (__self + __i) % participants;
+            while (run_one(__victim));
+        }
+    }
+
+    void worker_loop(std::size_t __self)
+    {
+        inside() = true;
+        std::size_t __seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> __lock(state);
+                wake.wait(__lock, [&] { return stopping || generation != __seen; });
+                if(stopping)
+                {
+                    return;
+                }
+                __seen = generation;
+                if(__self >= participants)
+                {
+                    continue;
+                }
+            }
+            participate(__self);
+            std::lock_guard<std::mutex> __lock(state);
+            if(--active == 0)
+            {
+                done.notify_one();
+            }
+        }
+    }
+
+    task_pool() : ranges(std::max(1u, std::thread::hardware_concurrency())), body(nullptr),
+                  participants(0), active(0), generation(0), stopping(false)
+    {
+        for (std::size_t __i = 1; __i < ranges.size(); ++__i)
+        {
+            workers.emplace_back(&task_pool::worker_loop, this, __i);
+        }
+    }
+
+public:
+
+    task_pool(const task_pool&) = delete;
+
+    task_pool& operator=(const task_pool&) = delete;
+
+    ~task_pool() noexcept
+    {
+        {
+            std::lock_guard<std::mutex> __lock(state);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& __t : workers)
+        {
+            __t.join();
+        }
+    }
+
+    /**
+     * Returns the process-wide pool, creating it on first use.
+     */
+    static task_pool& instance(void)
+    {
+        static task_pool __pool;
+        return __pool;
+    }
+
+    /**
+     * Returns the largest number of threads a job can use.
+     */
+    std::size_t capacity(void) const noexcept
+    {
+        return ranges.size();
+    }
+
+    /**
+     * @brief Runs @a __f(0) ... @a __f(__tasks - 1) on up to @a __threads threads.
+     *
+     * Task indices are dealt out in contiguous runs, one per thread, and
+     * idle threads steal from the runs of busy ones.  Returns once every
+     * task has finished and rethrows the first exception a task raised.
+     *
+     * When called from inside a task the pool is already busy with the
+     * outer job, so the tasks run in order on the calling thread and the
+     * first exception propagates at once.
+     */
+    void run(std::size_t __tasks, std::size_t __threads, const std::function<void(std::size_t)>& __f)
+    {
+        if(!__tasks)
+        {
+            return;
+        }
+        if(inside())
+        {
+            for (std::size_t __k = 0; __k < __tasks; ++__k)
+            {
+                __f(__k);
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> __job(submit);
+        std::size_t __p = std::min({__threads ? __threads : capacity(), capacity(), __tasks});
+        for (std::size_t __i = 0, __first = 0; __i < __p; ++__i)
+        {
+            std::size_t __n = __tasks / __p + (__i < __tasks % __p);
+            ranges[__i].next.store(__first, std::memory_order_relaxed);
+            ranges[__i].end = __first + __n;
+            __first += __n;
+        }
+        {
+            std::lock_guard<std::mutex> __lock(state);
+            body = &__f;
+            participants = __p;
+            active = __p - 1;
+            error = nullptr;
+            ++generation;
+        }
+        if(__p > 1)
+        {
+            wake.notify_all();
+        }
+        inside() = true;
+        participate(0);
+        inside() = false;
+        std::unique_lock<std::mutex> __lock(state);
+        done.wait(__lock, [&] { return active == 0; });
+        body = nullptr;
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+#endif
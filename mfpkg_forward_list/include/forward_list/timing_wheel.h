@@ -0,0 +1,475 @@
+/**
+ *  @brief A hierarchical hashed timing wheel.
+ *
+ *  @tparam _Tp  Type of the value carried by a timer.
+ *
+ *  Time is counted in ticks.  The wheel has @c levels rings of @c slots
+ *  slots each; a timer due in fewer than slots ticks waits in a slot of
+ *  the first ring, a later one in the ring whose span covers it, and
+ *  timers beyond the last ring in an overflow chain.  Every slot is a
+ *  node_base chain.  Whenever the first ring completes a turn, the due
+ *  slot of the next ring is redistributed one ring down by relinking
+ *  its nodes, so a timer is moved at most @c levels times over its life.
+ *
+ *  schedule() takes constant time and cancel() amortized constant time.
+ *  Cancelling only marks the timer; its node is reclaimed once the wheel
+ *  reaches its slot.  When cancelled timers come to outnumber both the
+ *  live ones and the slots of a ring, every chain is swept and the
+ *  cancelled nodes are released, and a wheel left with no live timer
+ *  releases them all before its clock moves on.
+ *  Every ring keeps a bitmap of its occupied slots, so advance() jumps
+ *  straight from one due slot or cascade to the next.  It returns the
+ *  timers that fell due, in deadline order, as a mfpkg::forward_list
+ *  built from the timer nodes themselves.
+ *
+ *  @file timing_wheel.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+template <typename _Tp>
+class mfpkg::timing_wheel : public basic_mfpkg::basic_forward_list
+{
+public:
+
+    /**
+     * A timer that fell due, with the deadline it was scheduled for.
+     */
+    struct expiry
+    {
+        std::uint64_t deadline;
+        _Tp value;
+    };
+
+    typedef mfpkg::forward_list<expiry> expired_list;
+
+    static constexpr unsigned slot_bits = 8;
+    static constexpr std::size_t slots = std::size_t(1) << slot_bits;
+    static constexpr unsigned levels = 4;
+
+    /**
+     * Refers to a scheduled timer.  It may be passed to cancel() until
+     * the timer is returned by advance() or the wheel is destroyed.
+     * Once the timer is cancelled, copies of its handle must not be used.
+     */
+    class handle
+    {
+        node_base* _M_node;
+
+        friend class timing_wheel;
+
+        explicit handle(node_base* __n) noexcept : _M_node(__n) {}
+
+        public:
+
+        handle() noexcept : _M_node(nullptr) {}
+
+        explicit operator bool(void) const noexcept
+        {
+            return _M_node != nullptr;
+        }
+    };
+
+private:
+
+    typedef timing_wheel<_Tp> _Self;
+    typedef node<expiry> timer_node;
+
+    static constexpr std::uint64_t cancelled = ~std::uint64_t(0);
+    static constexpr std::uint64_t slot_mask = slots - 1;
+
+    /**
+     * A slot: a chain appended at @c tail, which is &head when empty.
+     */
+    struct chain
+    {
+        node_base head;
+        node_base* tail;
+    };
+
+    chain wheel[levels][slots];
+    chain overflow;
+    std::uint64_t occupied[levels][slots / 64];
+    std::uint64_t current;
+    std::size_t live;
+    std::size_t dead;
+
+    static expiry& entry(node_base* __n) noexcept
+    {
+        return static_cast<timer_node*>(__n)->storage;
+    }
+
+    static void reset(chain& __c) noexcept
+    {
+        __c.head.link = nullptr;
+        __c.tail = &__c.head;
+    }
+
+    static void append(chain& __c, node_base* __n) noexcept
+    {
+        __n->link = nullptr;
+        __c.tail->link = __n;
+        __c.tail = __n;
+    }
+
+    static node_base* take(chain& __c) noexcept
+    {
+        node_base* __first = __c.head.link;
+        reset(__c);
+        return __first;
+    }
+
+    node_base* take(unsigned __l, std::size_t __s) noexcept
+    {
+        occupied[__l][__s / 64] &= ~(std::uint64_t(1) << (__s % 64));
+        return take(wheel[__l][__s]);
+    }
+
+    /**
+     * Returns how many slots past @a __from the next occupied slot of
+     * ring @a __l lies, wrapping around, or @c slots if there is none.
+     */
+    std::size_t next_occupied(unsigned __l, std::size_t __from) const noexcept
+    {
+        constexpr std::size_t __words = slots / 64;
+        for (std::size_t __i = 0; __i <= __words; ++__i)
+        {
+            const std::size_t __w = (__from / 64 + __i) % __words;
+            std::uint64_t __bits = occupied[__l][__w];
+            if(__i == 0)
+            {
+                __bits &= ~std::uint64_t(0) << (__from % 64);
+            }
+            else if(__i == __words)
+            {
+                __bits &= ~(~std::uint64_t(0) << (__from % 64));
+            }
+            if(__bits)
+            {
+                return (__w * 64 + unsigned(__builtin_ctzll(__bits)) - __from) & slot_mask;
+            }
+        }
+        return slots;
+    }
+
+    /**
+     * Releases the cancelled timers of @a __c, keeping the others in
+     * order.  Returns false if the chain is left empty.
+     */
+    bool sweep(chain& __c) noexcept
+    {
+        for (node_base* __it = take(__c); __it; )
+        {
+            node_base* __next = __it->link;
+            if(entry(__it).deadline == cancelled)
+            {
+                delete_node<expiry>(__it);
+                --dead;
+            }
+            else
+            {
+                append(__c, __it);
+            }
+            __it = __next;
+        }
+        return __c.head.link != nullptr;
+    }
+
+    /**
+     * Releases every cancelled timer still linked into the wheel.
+     */
+    void purge(void) noexcept
+    {
+        for (unsigned __l = 0; __l < levels && dead; ++__l)
+        {
+            for (std::size_t __s = 0; __s < slots && dead; ++__s)
+            {
+                if(!sweep(wheel[__l][__s]))
+                {
+                    occupied[__l][__s / 64] &= ~(std::uint64_t(1) << (__s % 64));
+                }
+            }
+        }
+        if(dead)
+        {
+            sweep(overflow);
+        }
+    }
+
+    static void release(node_base* __it) noexcept
+    {
+        while (__it)
+        {
+            node_base* __next = __it->link;
+            delete_node<expiry>(__it);
+            __it = __next;
+        }
+    }
+
+    /**
+     * Links @a __n into the slot its deadline falls in, as seen from the
+     * current tick.  A timer due now goes to the current slot, which
+     * process() expires after cascading.
+     */
+    void place(node_base* __n) noexcept
+    {
+        const std::uint64_t __due = std::max(entry(__n).deadline, current);
+        const std::uint64_t __delta = __due - current;
+        for (unsigned __l = 0; __l < levels; ++__l)
+        {
+            if(__delta < (std::uint64_t(1) << (slot_bits * (__l + 1))))
+            {
+                const std::size_t __s = std::size_t(__due >> (slot_bits * __l)) & slot_mask;
+                append(wheel[__l][__s], __n);
+                occupied[__l][__s / 64] |= std::uint64_t(1) << (__s % 64);
+                return;
+            }
+        }
+        append(overflow, __n);
+    }
+
+    /**
+     * Redistributes the chain @a __it, dropping the cancelled timers.
+     */
+    void cascade(node_base* __it) noexcept
+    {
+        while (__it)
+        {
+            node_base* __next = __it->link;
+            if(entry(__it).deadline == cancelled)
+            {
+                delete_node<expiry>(__it);
+                --dead;
+            }
+            else
+            {
+                place(__it);
+            }
+            __it = __next;
+        }
+    }
+
+    /**
+     * The next tick after the current one that has work: an occupied
+     * slot of the first ring, or the start of the span of an occupied
+     * slot of an outer ring or of the overflow chain.  Returns the
+     * largest tick when the wheel holds nothing.
+     */
+    std::uint64_t next_event(void) const noexcept
+    {
+        std::uint64_t __best = ~std::uint64_t(0);
+        std::size_t __d = next_occupied(0, std::size_t(current + 1) & slot_mask);
+        if(__d < slots)
+        {
+            __best = current + 1 + __d;
+        }
+        for (unsigned __l = 1; __l < levels; ++__l)
+        {
+            const unsigned __shift = slot_bits * __l;
+            const std::uint64_t __span = (current >> __shift) + 1;
+            __d = next_occupied(__l, std::size_t(__span) & slot_mask);
+            if(__d < slots)
+            {
+                __best = std::min(__best, (__span + __d) << __shift);
+            }
+        }
+        if(overflow.head.link)
+        {
+            __best = std::min(__best, ((current >> (slot_bits * levels)) + 1) << (slot_bits * levels));
+        }
+        return __best;
+    }
+
+    /**
+     * Moves the clock to @a __t, cascading at the start of a turn, and
+     * appends the live timers of the due slot to @a __out.
+     */
+    void process(std::uint64_t __t, chain& __out, std::size_t& __n) noexcept
+    {
+        current = __t;
+        if(!(__t & slot_mask))
+        {
+            for (unsigned __l = 1; __l < levels; ++__l)
+            {
+                const std::size_t __s = std::size_t(__t >> (slot_bits * __l)) & slot_mask;
+                cascade(take(__l, __s));
+                if(__s)
+                {
+                    break;
+                }
+                if(__l == levels - 1)
+                {
+                    cascade(take(overflow));
+                }
+            }
+        }
+        for (node_base* __it = take(0, std::size_t(__t & slot_mask)); __it; )
+        {
+            node_base* __next = __it->link;
+            if(entry(__it).deadline == cancelled)
+            {
+                delete_node<expiry>(__it);
+                --dead;
+            }
+            else
+            {
+                append(__out, __it);
+                ++__n;
+                --live;
+            }
+            __it = __next;
+        }
+    }
+
+public:
+
+    /**
+     * Creates an empty wheel whose clock reads @a __now.
+     */
+    explicit timing_wheel(std::uint64_t __now = 0) noexcept
+    : occupied(), current(__now), live(0), dead(0)
+    {
+        for (auto& __ring : wheel)
+        {
+            for (chain& __c : __ring)
+            {
+                reset(__c);
+            }
+        }
+        reset(overflow);
+    }
+
+    timing_wheel(const _Self&) = delete;
+
+    _Self& operator=(const _Self&) = delete;
+
+    ~timing_wheel() noexcept
+    {
+        for (auto& __ring : wheel)
+        {
+            for (chain& __c : __ring)
+            {
+                release(take(__c));
+            }
+        }
+        release(take(overflow));
+    }
+
+    /**
+     * @brief  Schedules @a __val to fall due at tick @a __deadline.
+     * @return  A handle to the timer.
+     *
+     * A deadline that has already passed falls due on the next tick.
+     */
+    handle schedule(std::uint64_t __deadline, _Tp __val)
+    {
+        __deadline = std::max(std::min(__deadline, cancelled - 1), current + 1);
+        node_base* __n = new_node<expiry>(expiry{__deadline, std::move(__val)});
+        if(!__n)
+        {
+            throw std::bad_alloc();
+        }
+        place(__n);
+        ++live;
+        return handle(__n);
+    }
+
+    /**
+     * @brief  Schedules @a __val to fall due @a __delay ticks from now.
+     */
+    handle schedule_after(std::uint64_t __delay, _Tp __val)
+    {
+        const std::uint64_t __deadline = __delay < cancelled - current ? current + __delay : cancelled - 1;
+        return schedule(__deadline, std::move(__val));
+    }
+
+    /**
+     * @brief  Cancels a pending timer and clears @a __h.
+     * @return  false if @a __h is empty or was already cancelled.
+     */
+    bool cancel(handle& __h) noexcept
+    {
+        if(!__h._M_node || entry(__h._M_node).deadline == cancelled)
+        {
+            return false;
+        }
+        entry(__h._M_node).deadline = cancelled;
+        __h._M_node = nullptr;
+        --live;
+        if(++dead > live && dead >= slots)
+        {
+            purge();
+        }
+        return true;
+    }
+
+    /**
+     * @brief  Moves the clock forward to tick @a __now.
+     * @return  The timers that fell due, ordered by deadline.
+     *
+     * Takes time proportional to the number of occupied slots passed,
+     * the timers cascaded and the timers returned, however far the
+     * clock moves.  Nothing is allocated or copied.
+     */
+    expired_list advance(std::uint64_t __now) noexcept
+    {
+        chain __out;
+        reset(__out);
+        std::size_t __n = 0;
+        while (current < __now)
+        {
+            if(!live)
+            {
+                // Only cancelled timers are left; the slots they sit in
+                // lose their meaning once the clock jumps.
+                purge();
+                current = __now;
+                break;
+            }
+            const std::uint64_t __t = next_event();
+            if(__t > __now)
+            {
+                current = __now;
+                break;
+            }
+            process(__t, __out, __n);
+        }
+        expired_list __list;
+        if(__n)
+        {
+            __list.object.link_chain(__list.object.before_begin(), __out.head.link, __out.tail, __n);
+        }
+        return __list;
+    }
+
+    /**
+     * @brief  Advances the clock by one tick.
+     */
+    expired_list tick(void) noexcept
+    {
+        return advance(current + 1);
+    }
+
+    std::uint64_t now(void) const noexcept
+    {
+        return current;
+    }
+
+    /**
+     * Returns the number of timers scheduled and not yet cancelled or due.
+     */
+    std::size_t pending(void) const noexcept
+    {
+        return live;
+    }
+
+    bool empty(void) const noexcept
+    {
+        return live == 0;
+    }
+};
+
+#endif
@@ -0,0 +1,576 @@
+/**
+ * @file trace.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ *  Operations recorded by mfpkg::traced_forward_list.  Every record
+ *  carries a list id, a position and a size, whose meaning depends on
+ *  the operation:
+ *
+ *    create        size is sizeof(_Tp), or 0 for non trivially copyable types
+ *    copy          position is the id of the copied list, size as create
+ *    insertions    position is the number of elements before the new one,
+ *                  size is the value size in bytes
+ *    erase_after   position is the number of elements before the erased one
+ *    erase_range,
+ *    splice_out,
+ *    splice_in     position as erase_after, size is the number of elements
+ *    remove,
+ *    unique        size is the number of elements removed
+ *    resize        position is the new size, size the value size in bytes
+ */
+enum class mfpkg::trace_op : std::uint8_t
+{
+    create,
+    copy,
+    destroy,
+    push_front,
+    push_back,
+    pop_front,
+    pop_back,
+    insert_after,
+    erase_after,
+    erase_range,
+    splice_out,
+    splice_in,
+    sort,
+    reverse,
+    unique,
+    remove,
+    resize,
+    clear
+};
+
+struct mfpkg::trace_record
+{
+    trace_op op;
+    std::uint64_t list;
+    std::uint64_t position;
+    std::uint64_t size;
+};
+
+/**
+ *  @brief A binary log of list operations shared by any number of
+ *  traced lists.
+ *
+ *  The log starts with the magic "MFPKGTR" and a format version byte.
+ *  Each record is the operation byte followed by the list id, position
+ *  and size as LEB128 varints, so most records take four bytes.  Records
+ *  are buffered and written in blocks of 64 KiB; the log is flushed on
+ *  destruction and must outlive the lists that write to it.
+ */
+class mfpkg::trace_log
+{
+public:
+
+    static constexpr char magic[8] = {'M', 'F', 'P', 'K', 'G', 'T', 'R', 1};
+
+private:
+
+    static constexpr std::size_t buffer_size = 64 * 1024;
+
+    std::mutex lock;
+    std::ostream& out;
+    std::vector<char> buffer;
+    std::uint64_t lists;
+
+    void put(std::uint64_t __v)
+    {
+        for (; __v >= 0x80; __v >>= 7)
+        {
+            buffer.push_back(char(__v | 0x80));
+        }
+        buffer.push_back(char(__v));
+    }
+
+    void write(void)
+    {
+        out.write(buffer.data(), std::streamsize(buffer.size()));
+        buffer.clear();
+    }
+
+    static std::uint64_t get(std::istream& __in)
+    {
+        std::uint64_t __v = 0;
+        for (unsigned __shift = 0; __shift < 64; __shift += 7)
+        {
+            int __c = __in.get();
+            if(__c == std::char_traits<char>::eof())
+            {
+                throw std::ios_base::failure("mfpkg::trace_log: truncated record");
+            }
+            __v |= std::uint64_t(__c & 0x7f) << __shift;
+            if(!(__c & 0x80))
+            {
+                return __v;
+            }
+        }
+        throw std::ios_base::failure("mfpkg::trace_log: malformed record");
+    }
+
+public:
+
+    explicit trace_log(std::ostream& __out) : out(__out), lists(0)
+    {
+        buffer.reserve(buffer_size + 64);
+        buffer.insert(buffer.end(), magic, magic + sizeof magic);
+    }
+
+    trace_log(const trace_log&) = delete;
+
+    ~trace_log()
+    {
+        flush();
+    }
+
+    /**
+     * Returns a new list id.
+     */
+    std::uint64_t open(void) noexcept
+    {
+        std::lock_guard<std::mutex> __guard(lock);
+        return lists++;
+    }
+
+    void record(trace_op __op, std::uint64_t __list, std::uint64_t __position,
+                std::uint64_t __size)
+    {
+        std::lock_guard<std::mutex> __guard(lock);
+        buffer.push_back(char(__op));
+        put(__list);
+        put(__position);
+        put(__size);
+        if(buffer.size() >= buffer_size)
+        {
+            write();
+        }
+    }
+
+    void flush(void)
+    {
+        std::lock_guard<std::mutex> __guard(lock);
+        write();
+        out.flush();
+    }
+
+    /**
+     * @brief Reads back a whole log written by a trace_log.
+     *
+     * Throws std::ios_base::failure on a bad header or a truncated record.
+     */
+    static std::vector<trace_record> read(std::istream& __in)
+    {
+        char __m[sizeof magic];
+        if(!__in.read(__m, sizeof __m) || std::memcmp(__m, magic, sizeof magic))
+        {
+            throw std::ios_base::failure("mfpkg::trace_log: not an operation trace");
+        }
+        std::vector<trace_record> __records;
+        for (int __c; (__c = __in.get()) != std::char_traits<char>::eof(); )
+        {
+            if(__c > int(trace_op::clear))
+            {
+                throw std::ios_base::failure("mfpkg::trace_log: unknown operation");
+            }
+            trace_record __r;
+            __r.op = trace_op(__c);
+            __r.list = get(__in);
+            __r.position = get(__in);
+            __r.size = get(__in);
+            __records.push_back(__r);
+        }
+        return __records;
+    }
+};
+
+/**
+ *  @brief A mfpkg::forward_list that records every modifying operation
+ *  to a trace_log, for replay against other list configurations.
+ *
+ *  Positions are logged as element indices.  The iterators of this class
+ *  carry their index, so an operation through an iterator obtained since
+ *  the last change to the %list is logged in constant time; older
+ *  iterators have their index recomputed with a walk from the front.
+ *  Elements are read through list().
+ */
+template <typename _Tp, typename _Policy>
+class mfpkg::traced_forward_list
+{
+private:
+
+    typedef traced_forward_list<_Tp, _Policy> _Self;
+    typedef mfpkg::forward_list<_Tp, _Policy> list_type;
+    typedef typename basic_mfpkg::basic_forward_list::iterator<_Tp> base_iterator;
+
+    list_type items;
+    trace_log* log;
+    std::uint64_t id;
+    std::uint64_t epoch;
+
+public:
+
+    class iterator
+    {
+    private:
+
+        friend class traced_forward_list;
+
+        base_iterator it;
+        std::size_t index;
+        std::uint64_t epoch;
+
+        iterator(base_iterator __it, std::size_t __index, std::uint64_t __epoch) noexcept
+        : it(__it), index(__index), epoch(__epoch) { }
+
+    public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef _Tp value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef _Tp& reference;
+        typedef _Tp* pointer;
+
+        iterator() noexcept : index(0), epoch(0) { }
+
+        reference operator*() const noexcept
+        {
+            return *it;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return it.operator->();
+        }
+
+        iterator& operator++() noexcept
+        {
+            ++it;
+            ++index;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator __tmp(*this);
+            ++*this;
+            return __tmp;
+        }
+
+        friend bool operator==(const iterator& __x, const iterator& __y) noexcept
+        {
+            return __x.it == __y.it;
+        }
+
+        friend bool operator!=(const iterator& __x, const iterator& __y) noexcept
+        {
+            return __x.it != __y.it;
+        }
+    };
+
+private:
+
+    static constexpr std::uint64_t width(void) noexcept
+    {
+        return std::is_trivially_copyable<_Tp>::value ? sizeof(_Tp) : 0;
+    }
+
+    template <typename _Up, typename = void>
+    struct sized : std::false_type { };
+
+    template <typename _Up>
+    struct sized<_Up, std::void_t<decltype(std::declval<const _Up&>().size()),
+                                  typename _Up::value_type>> : std::true_type { };
+
+    static std::uint64_t value_size(const _Tp& __val) noexcept
+    {
+        if constexpr (sized<_Tp>::value)
+        {
+            return __val.size() * sizeof(typename _Tp::value_type);
+        }
+        else
+        {
+            return sizeof(__val);
+        }
+    }
+
+    void record(trace_op __op, std::uint64_t __position = 0, std::uint64_t __size = 0)
+    {
+        log->record(__op, id, __position, __size);
+    }
+
+    /**
+     * Number of elements before the one following @a __it.
+     */
+    std::size_t index_of(const iterator& __it) const noexcept
+    {
+        if(__it.epoch == epoch)
+        {
+            return __it.index;
+        }
+        std::size_t __i = 0;
+        for (auto __p = items.before_begin(); __p._M_node != __it.it._M_node; ++__p)
+        {
+            ++__i;
+        }
+        return __i;
+    }
+
+    iterator at(base_iterator __it, std::size_t __index) const noexcept
+    {
+        return iterator(__it, __index, epoch);
+    }
+
+public:
+
+    typedef _Tp value_type;
+    typedef _Tp& reference;
+    typedef const _Tp& const_reference;
+    typedef std::size_t size_type;
+
+    explicit traced_forward_list(trace_log& __log)
+    : log(&__log), id(__log.open()), epoch(0)
+    {
+        record(trace_op::create, 0, width());
+    }
+
+    traced_forward_list(const _Self& __list)
+    : items(__list.items), log(__list.log), id(log->open()), epoch(0)
+    {
+        record(trace_op::copy, __list.id, width());
+    }
+
+    ~traced_forward_list()
+    {
+        record(trace_op::destroy);
+    }
+
+    _Self& operator=(const _Self&) = delete;
+
+    /**
+     * Read access to the elements.
+     */
+    const list_type& list(void) const noexcept
+    {
+        return items;
+    }
+
+    iterator before_begin(void) noexcept
+    {
+        return at(items.before_begin(), 0);
+    }
+
+    iterator begin(void) noexcept
+    {
+        return at(items.begin(), 1);
+    }
+
+    iterator end(void) noexcept
+    {
+        return at(items.end(), items.size() + 1);
+    }
+
+    reference front(void) noexcept
+    {
+        return items.front();
+    }
+
+    reference back(void) noexcept
+    {
+        return items.back();
+    }
+
+    bool empty(void) const noexcept
+    {
+        return items.empty();
+    }
+
+    std::size_t size(void) const noexcept
+    {
+        return items.size();
+    }
+
+    void push_front(const _Tp& __val)
+    {
+        record(trace_op::push_front, 0, value_size(__val));
+        items.push_front(__val);
+        ++epoch;
+    }
+
+    void push_front(_Tp&& __val)
+    {
+        record(trace_op::push_front, 0, value_size(__val));
+        items.push_front(std::move(__val));
+        ++epoch;
+    }
+
+    void push_back(const _Tp& __val)
+    {
+        record(trace_op::push_back, items.size(), value_size(__val));
+        items.push_back(__val);
+    }
+
+    void push_back(_Tp&& __val)
+    {
+        record(trace_op::push_back, items.size(), value_size(__val));
+        items.push_back(std::move(__val));
+    }
+
+    void pop_front(void)
+    {
+        record(trace_op::pop_front);
+        items.pop_front();
+        ++epoch;
+    }
+
+    void pop_back(void)
+    {
+        record(trace_op::pop_back, items.size() - 1);
+        items.pop_back();
+    }
+
+    iterator insert_after(const iterator& __position, const _Tp& __val)
+    {
+        std::size_t __i = index_of(__position);
+        record(trace_op::insert_after, __i, value_size(__val));
+        auto __it = items.insert_after(__position.it, __val);
+        ++epoch;
+        return at(__it, __i + 1);
+    }
+
+    iterator insert_after(const iterator& __position, _Tp&& __val)
+    {
+        std::size_t __i = index_of(__position);
+        record(trace_op::insert_after, __i, value_size(__val));
+        auto __it = items.insert_after(__position.it, std::move(__val));
+        ++epoch;
+        return at(__it, __i + 1);
+    }
+
+    iterator erase_after(const iterator& __position)
+    {
+        std::size_t __i = index_of(__position);
+        record(trace_op::erase_after, __i);
+        auto __it = items.erase_after(__position.it);
+        ++epoch;
+        return at(__it, __i + 1);
+    }
+
+    iterator erase_after(const iterator& __before, const iterator& __last)
+    {
+        std::size_t __i = index_of(__before);
+        std::size_t __n = 0;
+        for (auto __p = ++base_iterator(__before.it); __p != __last.it; ++__p)
+        {
+            ++__n;
+        }
+        record(trace_op::erase_range, __i, __n);
+        auto __it = items.erase_after(__before.it, __last.it);
+        ++epoch;
+        return at(__it, __i + 1);
+    }
+
+    /**
+     * Moves the elements in (__before, __last) of @a __list after
+     * @a __position.  Both lists log their side of the move.
+     */
+    void splice_after(const iterator& __position, _Self& __list, const iterator& __before,
+                                                                 const iterator& __last)
+    {
+        std::size_t __n = 0;
+        for (auto __p = ++base_iterator(__before.it); __p != __last.it; ++__p)
+        {
+            ++__n;
+        }
+        if(!__n)
+        {
+            return;
+        }
+        __list.record(trace_op::splice_out, __list.index_of(__before), __n);
+        record(trace_op::splice_in, index_of(__position), __n);
+        items.splice_after(__position.it, __list.items, __before.it, __last.it);
+        ++epoch;
+        ++__list.epoch;
+    }
+
+    void splice_after(const iterator& __position, _Self& __list)
+    {
+        splice_after(__position, __list, __list.before_begin(), __list.end());
+    }
+
+    void splice_after(const iterator& __position, _Self& __list, const iterator& __i)
+    {
+        iterator __last = __i;
+        ++__last;
+        if(__last != __list.end())
+        {
+            ++__last;
+            splice_after(__position, __list, __i, __last);
+        }
+    }
+
+    void sort(void) noexcept
+    {
+        record(trace_op::sort);
+        items.sort();
+        ++epoch;
+    }
+
+    void reverse(void) noexcept
+    {
+        record(trace_op::reverse);
+        items.reverse();
+        ++epoch;
+    }
+
+    void unique(void)
+    {
+        std::size_t __n = items.size();
+        items.unique();
+        record(trace_op::unique, 0, __n - items.size());
+        ++epoch;
+    }
+
+    void remove(const _Tp& __val)
+    {
+        std::size_t __n = items.size();
+        items.remove(__val);
+        record(trace_op::remove, 0, __n - items.size());
+        ++epoch;
+    }
+
+    void remove_if(bool (*__pred)(const _Tp& __val))
+    {
+        std::size_t __n = items.size();
+        items.remove_if(__pred);
+        record(trace_op::remove, 0, __n - items.size());
+        ++epoch;
+    }
+
+    void resize(std::size_t __n)
+    {
+        record(trace_op::resize, __n, sizeof(_Tp));
+        items.resize(__n);
+        ++epoch;
+    }
+
+    void resize(std::size_t __n, const _Tp& __val)
+    {
+        record(trace_op::resize, __n, value_size(__val));
+        items.resize(__n, __val);
+        ++epoch;
+    }
+
+    void clear(void)
+    {
+        record(trace_op::clear);
+        items.clear();
+        ++epoch;
+    }
+};
+
+#endif
@@ -0,0 +1,468 @@
+/**
+ *  @brief Lazy views over a mfpkg::forward_list.
+ *
+ *  A view does not own or copy elements; it wraps the iterators of the
+ *  range it adapts.  Views are composed with @c operator| and the whole
+ *  pipeline runs as a single traversal of the underlying node chain when
+ *  it is iterated, for example:
+ *
+ *  @code
+ *  auto __big = __list | mfpkg::views::filter(__is_big)
+ *                      | mfpkg::views::transform(__score)
+ *                      | mfpkg::views::to<mfpkg::forward_list>();
+ *  @endcode
+ *
+ *  The adapted %list must outlive the view, and iterators into a view
+ *  must not outlive the view itself.
+ *
+ *  @file views.h
+ *  This is an internal header file, included by mfpkg.h
+ *  Do not attempt to use it directly.
+ */
+
+#ifndef VIEWS_H
+#define VIEWS_H
+
+namespace mfpkg
+{
+namespace views
+{
+    /**
+     *  Tag base of every view.  Views are held by value when composed,
+     *  any other range is held by reference.
+     */
+    struct view_base {};
+
+    template <typename _Range>
+    class ref_view : public view_base
+    {
+        _Range* range;
+
+        public:
+
+        explicit ref_view(_Range& __r) noexcept : range(&__r) {}
+
+        auto begin(void) const { return range->begin(); }
+
+        auto end(void) const { return range->end(); }
+    };
+
+    template <typename _Range>
+    using all_t = typename std::conditional<
+                      std::is_base_of<view_base, typename std::decay<_Range>::type>::value,
+                      typename std::decay<_Range>::type,
+                      ref_view<typename std::remove_reference<_Range>::type>>::type;
+
+    template <typename _View>
+    using iterator_t = decltype(std::declval<const _View&>().begin());
+
+    template <typename _Iterator>
+    using category_t = typename std::conditional<
+                           std::is_base_of<std::forward_iterator_tag,
+                               typename std::iterator_traits<_Iterator>::iterator_category>::value,
+                           std::forward_iterator_tag, std::input_iterator_tag>::type;
+
+    /**
+     *  A pair of iterators that can be used as a range.
+     */
+    template <typename _Iterator>
+    class subrange : public view_base
+    {
+        _Iterator first;
+        _Iterator last;
+
+        public:
+
+        subrange() = default;
+
+        subrange(_Iterator __first, _Iterator __last) : first(__first), last(__last) {}
+
+        _Iterator begin(void) const { return first; }
+
+        _Iterator end(void) const { return last; }
+    };
+
+    /**
+     *  @brief View of the elements of a range that satisfy a predicate.
+     */
+    template <typename _View, typename _Pred>
+    class filter_view : public view_base
+    {
+        typedef iterator_t<_View> base_iterator;
+
+        _View base;
+        _Pred pred;
+
+        public:
+
+        struct iterator
+        {
+            typedef category_t<base_iterator> iterator_category;
+            typedef typename std::iterator_traits<base_iterator>::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef typename std::iterator_traits<base_iterator>::reference reference;
+            typedef void pointer;
+
+            base_iterator _M_cur;
+            base_iterator _M_last;
+            const filter_view* _M_view;
+
+            iterator() = default;
+
+            iterator(base_iterator __cur, base_iterator __last, const filter_view* __v)
+            : _M_cur(__cur), _M_last(__last), _M_view(__v)
+            {
+                satisfy();
+            }
+
+            void satisfy(void)
+            {
+                while (_M_cur != _M_last && !_M_view->pred(*_M_cur))
+                {
+                    ++_M_cur;
+                }
+            }
+
+            reference operator*() const { return *_M_cur; }
+
+            iterator& operator++()
+            {
+                ++_M_cur;
+                satisfy();
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator __tmp(*this);
+                ++*this;
+                return __tmp;
+            }
+
+            friend bool operator==(const iterator& __x, const iterator& __y)
+            {
+                return __x._M_cur == __y._M_cur;
+            }
+
+            friend bool operator!=(const iterator& __x, const iterator& __y)
+            {
+                return __x._M_cur != __y._M_cur;
+            }
+        };
+
+        filter_view(_View __base, _Pred __pred) : base(std::move(__base)), pred(std::move(__pred)) {}
+
+        iterator begin(void) const { return iterator(base.begin(), base.end(), this); }
+
+        iterator end(void) const { return iterator(base.end(), base.end(), this); }
+    };
+
+    /**
+     *  @brief View that applies a function to each element of a range.
+     */
+    template <typename _View, typename _Function>
+    class transform_view : public view_base
+    {
+        typedef iterator_t<_View> base_iterator;
+
+        _View base;
+        _Function fun;
+
+        public:
+
+        struct iterator
+        {
+            typedef decltype(std::declval<const _Function&>()(*std::declval<base_iterator>())) reference;
+            typedef typename std::decay<reference>::type value_type;
+            typedef typename std::conditional<std::is_reference<reference>::value,
+                                              category_t<base_iterator>,
+                                              std::input_iterator_tag>::type iterator_category;
+            typedef std::ptrdiff_t difference_type;
+            typedef void pointer;
+
+            base_iterator _M_cur;
+            const transform_view* _M_view;
+
+            iterator() = default;
+
+            iterator(base_iterator __cur, const transform_view* __v) : _M_cur(__cur), _M_view(__v) {}
+
+            reference operator*() const { return _M_view->fun(*_M_cur); }
+
+            iterator& operator++()
+            {
+                ++_M_cur;
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator __tmp(*this);
+                ++_M_cur;
+                return __tmp;
+            }
+
+            friend bool operator==(const iterator& __x, const iterator& __y)
+            {
+                return __x._M_cur == __y._M_cur;
+            }
+
+            friend bool operator!=(const iterator& __x, const iterator& __y)
+            {
+                return __x._M_cur != __y._M_cur;
+            }
+        };
+
+        transform_view(_View __base, _Function __f) : base(std::move(__base)), fun(std::move(__f)) {}
+
+        iterator begin(void) const { return iterator(base.begin(), this); }
+
+        iterator end(void) const { return iterator(base.end(), this); }
+    };
+
+    /**
+     *  @brief View of the leading elements of a range that satisfy a predicate.
+     *
+     *  Once the predicate fails the iterator jumps straight to the end of
+     *  the underlying range, so the rest of the chain is never touched.
+     */
+    template <typename _View, typename _Pred>
+    class take_while_view : public view_base
+    {
+        typedef iterator_t<_View> base_iterator;
+
+        _View base;
+        _Pred pred;
+
+        public:
+
+        struct iterator
+        {
+            typedef category_t<base_iterator> iterator_category;
+            typedef typename std::iterator_traits<base_iterator>::value_type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef typename std::iterator_traits<base_iterator>::reference reference;
+            typedef void pointer;
+
+            base_iterator _M_cur;
+            base_iterator _M_last;
+            const take_while_view* _M_view;
+
+            iterator() = default;
+
+            iterator(base_iterator __cur, base_iterator __last, const take_while_view* __v)
+            : _M_cur(__cur), _M_last(__last), _M_view(__v)
+            {
+                check();
+            }
+
+            void check(void)
+            {
+                if(_M_cur != _M_last && !_M_view->pred(*_M_cur))
+                {
+                    _M_cur = _M_last;
+                }
+            }
+
+            reference operator*() const { return *_M_cur; }
+
+            iterator& operator++()
+            {
+                ++_M_cur;
+                check();
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator __tmp(*this);
+                ++*this;
+                return __tmp;
+            }
+
+            friend bool operator==(const iterator& __x, const iterator& __y)
+            {
+                return __x._M_cur == __y._M_cur;
+            }
+
+            friend bool operator!=(const iterator& __x, const iterator& __y)
+            {
+                return __x._M_cur != __y._M_cur;
+            }
+        };
+
+        take_while_view(_View __base, _Pred __pred) : base(std::move(__base)), pred(std::move(__pred)) {}
+
+        iterator begin(void) const { return iterator(base.begin(), base.end(), this); }
+
+        iterator end(void) const { return iterator(base.end(), base.end(), this); }
+    };
+
+    /**
+     *  @brief View of a range as consecutive chunks of @a n elements.
+     *
+     *  Each chunk is a subrange of the underlying iterators; the last
+     *  chunk may be shorter.  No element is copied.
+     */
+    template <typename _View>
+    class chunk_view : public view_base
+    {
+        typedef iterator_t<_View> base_iterator;
+
+        _View base;
+        std::size_t n;
+
+        public:
+
+        struct iterator
+        {
+            typedef category_t<base_iterator> iterator_category;
+            typedef subrange<base_iterator> value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef value_type reference;
+            typedef void pointer;
+
+            base_iterator _M_cur;
+            base_iterator _M_next;
+            base_iterator _M_last;
+            std::size_t _M_n;
+
+            iterator() = default;
+
+            iterator(base_iterator __cur, base_iterator __last, std::size_t __n)
+            : _M_cur(__cur), _M_next(__cur), _M_last(__last), _M_n(__n)
+            {
+                advance();
+            }
+
+            void advance(void)
+            {
+                for (std::size_t __i = 0; __i < _M_n && _M_next != _M_last; ++__i)
+                {
+                    ++_M_next;
+                }
+            }
+
+            reference operator*() const { return value_type(_M_cur, _M_next); }
+
+            iterator& operator++()
+            {
+                _M_cur = _M_next;
+                advance();
+                return *this;
+            }
+
+            iterator operator++(int)
+            {
+                iterator __tmp(*this);
+                ++*this;
+                return __tmp;
+            }
+
+            friend bool operator==(const iterator& __x, const iterator& __y)
+            {
+                return __x._M_cur == __y._M_cur;
+            }
+
+            friend bool operator!=(const iterator& __x, const iterator& __y)
+            {
+                return __x._M_cur != __y._M_cur;
+            }
+        };
+
+        chunk_view(_View __base, std::size_t __n) : base(std::move(__base)), n(__n ? __n : 1) {}
+
+        iterator begin(void) const { return iterator(base.begin(), base.end(), n); }
+
+        iterator end(void) const { return iterator(base.end(), base.end(), n); }
+    };
+
+    template <template <typename, typename> class _View, typename _Arg>
+    struct adaptor
+    {
+        _Arg arg;
+    };
+
+    template <typename _Range, template <typename, typename> class _View, typename _Arg>
+    _View<all_t<_Range>, _Arg> operator|(_Range&& __r, adaptor<_View, _Arg> __a)
+    {
+        return _View<all_t<_Range>, _Arg>(all_t<_Range>(__r), std::move(__a.arg));
+    }
+
+    struct chunk_adaptor
+    {
+        std::size_t n;
+    };
+
+    template <typename _Range>
+    chunk_view<all_t<_Range>> operator|(_Range&& __r, chunk_adaptor __a)
+    {
+        return chunk_view<all_t<_Range>>(all_t<_Range>(__r), __a.n);
+    }
+
+    template <template <typename...> class _Container>
+    struct to_adaptor {};
+
+    /**
+     * @brief Materializes a range into a new container.
+     *
+     * The container is filled through a single range insert_after(), so a
+     * mfpkg::forward_list result is built as one detached chain and linked
+     * in once.
+     */
+    template <typename _Range, template <typename...> class _Container>
+    auto operator|(_Range&& __r, to_adaptor<_Container>)
+    {
+        typedef typename std::iterator_traits<iterator_t<all_t<_Range>>>::value_type value_type;
+        _Container<value_type> __c;
+        __c.insert_after(__c.before_begin(), __r.begin(), __r.end());
+        return __c;
+    }
+
+    /**
+     * @brief Keeps the elements for which @a __pred returns true.
+     */
+    template <typename _Pred>
+    adaptor<filter_view, _Pred> filter(_Pred __pred)
+    {
+        return {std::move(__pred)};
+    }
+
+    /**
+     * @brief Replaces every element @c x with @a __f(x).
+     */
+    template <typename _Function>
+    adaptor<transform_view, _Function> transform(_Function __f)
+    {
+        return {std::move(__f)};
+    }
+
+    /**
+     * @brief Keeps elements up to the first one for which @a __pred returns false.
+     */
+    template <typename _Pred>
+    adaptor<take_while_view, _Pred> take_while(_Pred __pred)
+    {
+        return {std::move(__pred)};
+    }
+
+    /**
+     * @brief Groups elements into consecutive chunks of @a __n.
+     */
+    inline chunk_adaptor chunk(std::size_t __n)
+    {
+        return {__n};
+    }
+
+    /**
+     * @brief Collects a pipeline into a @a _Container, e.g. to<mfpkg::forward_list>().
+     */
+    template <template <typename...> class _Container>
+    to_adaptor<_Container> to(void)
+    {
+        return {};
+    }
+};
+};
+
+#endif
@@ -1,19 +1,154 @@
 #ifndef MFPKG_H
 #define MFPKG_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
 #include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define MFPKG_HAS_NODE_ARENA 1
+#define MFPKG_HAS_FD_IO 1
+#define MFPKG_HAS_MAPPED_LIST 1
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(MFPKG_NO_SIMD)
+#include <immintrin.h>
+#define MFPKG_HAS_X86_SIMD 1
+#define MFPKG_TARGET(__isa) __attribute__((target(__isa)))
+#endif
+
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define MFPKG_HAS_COROUTINES 1
+#endif
 
 namespace basic_mfpkg
 {
     class basic_forward_list;
+    class rcu_domain;
+    class task_pool;
+    class node_regions;
+    class node_cache;
+    struct index_chain;
+    struct simd_kernels;
+    struct list_io;
 };
 
 namespace mfpkg
 {
-    template <typename _Tp> class forward_list;
+    enum class list_op : unsigned;
+    class latency_histogram;
+    struct list_stats;
+    struct timed_list_stats;
+    struct no_instrumentation;
+    template <bool _Latency = false> struct instrumented;
+    template <bool _Tail, bool _Size, typename _Base = no_instrumentation> struct layout;
+
+    template <typename _Tp, typename _Policy = no_instrumentation> class forward_list;
+    template <typename _Tp> class rcu_forward_list;
+    template <typename _Tp, typename _Hash = std::hash<_Tp>,
+              typename _Eq = std::equal_to<_Tp>> class indexed_forward_list;
+    template <typename _Tp, typename _Compare = std::less<_Tp>> class sorted_forward_list;
+    template <typename _Tp> class compact_arena;
+    template <typename _Tp> class compact_forward_list;
+    template <typename _Tp, std::size_t _Np> class inplace_forward_list;
+    template <typename _Tp> class timing_wheel;
+
+    template <typename _Tp> struct serializer;
+
+    enum class trace_op : std::uint8_t;
+    struct trace_record;
+    class trace_log;
+    template <typename _Tp, typename _Policy = no_instrumentation> class traced_forward_list;
+
+    template <typename _Tp, typename _Policy>
+    void serialize(const forward_list<_Tp, _Policy>& __list, std::ostream& __out);
+    template <typename _Tp>
+    forward_list<_Tp> deserialize(std::istream& __in);
+
+#if defined(MFPKG_HAS_FD_IO)
+    template <typename _Tp, typename _Policy>
+    void serialize(const forward_list<_Tp, _Policy>& __list, int __fd);
+    template <typename _Tp>
+    forward_list<_Tp> deserialize(int __fd);
+#endif
+
+#if defined(MFPKG_HAS_NODE_ARENA)
+    class node_arena;
+#endif
+
+#if defined(MFPKG_HAS_MAPPED_LIST)
+    template <typename _Tp> class mapped_forward_list;
+#endif
+
+#if defined(MFPKG_HAS_COROUTINES)
+    template <typename _Tp, bool _ThreadSafe = false> class async_queue;
+#endif
 };
 
+#include "forward_list/task_pool.h"
+#include "forward_list/node_regions.h"
+#include "forward_list/node_cache.h"
+
+#if defined(MFPKG_HAS_NODE_ARENA)
+#include "forward_list/node_arena.h"
+#endif
+
+#include "forward_list/simd_kernels.h"
 #include "forward_list/basic_forward_list.h"
+#include "forward_list/instrumentation.h"
 #include "forward_list/forward_list.h"
+#include "forward_list/rcu_forward_list.h"
+#include "forward_list/indexed_forward_list.h"
+#include "forward_list/sorted_forward_list.h"
+#include "forward_list/index_chain.h"
+#include "forward_list/compact_forward_list.h"
+#include "forward_list/inplace_forward_list.h"
+#include "forward_list/timing_wheel.h"
+
+#if defined(MFPKG_HAS_MAPPED_LIST)
+#include "forward_list/mapped_forward_list.h"
+#endif
+
+#include "forward_list/parallel.h"
+#include "forward_list/views.h"
+#include "forward_list/interleaved.h"
+#include "forward_list/serialization.h"
+#include "forward_list/trace.h"
+
+#if defined(MFPKG_HAS_COROUTINES)
+#include "forward_list/async_queue.h"
+#endif
 
 #endif
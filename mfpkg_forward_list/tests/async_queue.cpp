@@ -0,0 +1,161 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#if defined(MFPKG_HAS_COROUTINES)
+
+namespace
+{
+    struct detached
+    {
+        struct promise_type
+        {
+            detached get_return_object(void) noexcept { return {}; }
+            std::suspend_never initial_suspend(void) noexcept { return {}; }
+            std::suspend_never final_suspend(void) noexcept { return {}; }
+            void return_void(void) noexcept {}
+            void unhandled_exception(void) noexcept { std::terminate(); }
+        };
+    };
+
+    template <typename Queue>
+    detached consume(Queue& q, std::vector<int>& out, int n)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            out.push_back(co_await q.pop());
+        }
+    }
+
+    std::vector<std::coroutine_handle<>> scheduled;
+
+    void defer(std::coroutine_handle<> h, void* ctx)
+    {
+        CHECK(ctx == &scheduled);
+        scheduled.push_back(h);
+    }
+}
+
+static void buffered_values_are_popped_in_order(void)
+{
+    mfpkg::async_queue<int> q;
+    q.push(1);
+    q.push(2);
+    CHECK(q.size() == 2);
+
+    std::vector<int> out;
+    consume(q, out, 2);
+    CHECK((out == std::vector<int>{1, 2}));
+    CHECK(q.empty());
+    CHECK(q.waiting() == 0);
+}
+
+static void waiters_are_resumed_by_push(void)
+{
+    mfpkg::async_queue<int> q;
+    std::vector<int> a, b;
+    consume(q, a, 2);
+    consume(q, b, 1);
+    CHECK(q.waiting() == 2);
+
+    q.push(10);
+    q.push(20);
+    q.push(30);
+    CHECK((a == std::vector<int>{10, 30}));
+    CHECK((b == std::vector<int>{20}));
+    CHECK(q.waiting() == 0);
+    CHECK(q.empty());
+
+    int x = 0;
+    CHECK(!q.try_pop(x));
+    q.push(40);
+    CHECK(q.try_pop(x) && x == 40);
+}
+
+static void scheduler_receives_woken_waiters(void)
+{
+    mfpkg::async_queue<int> q(defer, &scheduled);
+    std::vector<int> out;
+    consume(q, out, 1);
+    q.push(7);
+    CHECK(out.empty());
+    CHECK(scheduled.size() == 1);
+    scheduled.back().resume();
+    scheduled.clear();
+    CHECK((out == std::vector<int>{7}));
+}
+
+/*
+ * Pushed values are moved into the queue, so move-only payloads work
+ * and copyable ones are never copied on the way through.
+ */
+static void values_are_moved_not_copied(void)
+{
+    mfpkg::async_queue<std::unique_ptr<int>> q;
+    q.push(std::make_unique<int>(1));
+    q.push(std::make_unique<int>(2));
+    std::unique_ptr<int> p;
+    CHECK(q.try_pop(p) && p && *p == 1);
+
+    std::vector<int> out;
+    [](mfpkg::async_queue<std::unique_ptr<int>>& q, std::vector<int>& out) -> detached
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            std::unique_ptr<int> v = co_await q.pop();
+            out.push_back(*v);
+        }
+    }(q, out);
+    q.push(std::make_unique<int>(3));
+    CHECK((out == std::vector<int>{2, 3}));
+
+    mfpkg::async_queue<test::counted> c;
+    test::counted::reset();
+    c.push(test::counted(5));
+    test::counted v;
+    CHECK(c.try_pop(v) && v.value == 5);
+    CHECK(test::counted::copies == 0);
+}
+
+static void thread_safe_queue_passes_values_between_threads(void)
+{
+    mfpkg::async_queue<int, true> q;
+    std::vector<int> out;
+    const int n = 10000;
+    consume(q, out, n);
+    std::thread producer([&]
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            q.push(i);
+        }
+    });
+    producer.join();
+    CHECK(int(out.size()) == n);
+    bool ordered = true;
+    for (int i = 0; i < int(out.size()); ++i)
+    {
+        ordered = ordered && out[i] == i;
+    }
+    CHECK(ordered);
+    CHECK(q.waiting() == 0);
+}
+
+int main(void)
+{
+    buffered_values_are_popped_in_order();
+    waiters_are_resumed_by_push();
+    scheduler_receives_woken_waiters();
+    values_are_moved_not_copied();
+    thread_safe_queue_passes_values_between_threads();
+    return test::result();
+}
+
+#else
+
+int main(void)
+{
+    std::puts("async_queue needs C++20 coroutines; skipped");
+    return 0;
+}
+
+#endif
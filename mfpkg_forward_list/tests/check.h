@@ -0,0 +1,84 @@
+/**
+ *  @brief Minimal checking helpers shared by the behaviour tests.
+ *
+ *  Each test is a plain executable.  CHECK() reports a failed condition
+ *  and keeps going, so one run lists every failure; main() returns
+ *  test::result() so that ctest sees a non-zero exit status.
+ */
+
+#ifndef MFPKG_TEST_CHECK_H
+#define MFPKG_TEST_CHECK_H
+
+#include <cstdio>
+#include <initializer_list>
+
+namespace test
+{
+    inline int failures = 0;
+
+    inline int result(void)
+    {
+        if(failures)
+        {
+            std::fprintf(stderr, "%d check(s) failed\n", failures);
+        }
+        return failures ? 1 : 0;
+    }
+
+    /**
+     * True when @a list holds exactly @a expected, in order.
+     */
+    template <typename List, typename T>
+    bool equal(const List& list, std::initializer_list<T> expected)
+    {
+        auto it = expected.begin();
+        for (const auto& x : list)
+        {
+            if(it == expected.end() || !(x == *it))
+            {
+                return false;
+            }
+            ++it;
+        }
+        return it == expected.end();
+    }
+
+    /**
+     * Counts copies and moves, to check that an operation relinks nodes
+     * instead of copying elements.
+     */
+    struct counted
+    {
+        static inline int copies = 0;
+        static inline int moves = 0;
+
+        int value;
+
+        counted(int v = 0) noexcept : value(v) {}
+        counted(const counted& c) noexcept : value(c.value) { ++copies; }
+        counted(counted&& c) noexcept : value(c.value) { ++moves; }
+        counted& operator=(const counted& c) noexcept { value = c.value; ++copies; return *this; }
+        counted& operator=(counted&& c) noexcept { value = c.value; ++moves; return *this; }
+
+        bool operator==(const counted& c) const noexcept { return value == c.value; }
+        bool operator<(const counted& c) const noexcept { return value < c.value; }
+
+        static void reset(void) noexcept
+        {
+            copies = 0;
+            moves = 0;
+        }
+    };
+};
+
+#define CHECK(cond)                                                              \
+    do                                                                           \
+    {                                                                            \
+        if(!(cond))                                                              \
+        {                                                                        \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++test::failures;                                                    \
+        }                                                                        \
+    } while (0)
+
+#endif
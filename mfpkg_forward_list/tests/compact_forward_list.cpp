@@ -0,0 +1,134 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void basic_operations(void)
+{
+    mfpkg::compact_forward_list<int> list {3, 1, 2};
+    list.push_front(0);
+    list.push_back(4);
+    CHECK(test::equal(list, {0, 3, 1, 2, 4}));
+    CHECK(list.size() == 5 && list.front() == 0 && list.back() == 4);
+
+    list.pop_front();
+    list.pop_back();
+    CHECK(test::equal(list, {3, 1, 2}));
+
+    list.insert_after(list.begin(), {7, 7});
+    CHECK(test::equal(list, {3, 7, 7, 1, 2}));
+    list.unique();
+    CHECK(test::equal(list, {3, 7, 1, 2}));
+    list.remove(7);
+    CHECK(test::equal(list, {3, 1, 2}));
+
+    list.sort();
+    CHECK(test::equal(list, {1, 2, 3}));
+    list.reverse();
+    CHECK(test::equal(list, {3, 2, 1}));
+    list.push_back(0);
+    CHECK(list.back() == 0);
+
+    list.resize(2);
+    CHECK(test::equal(list, {3, 2}));
+    list.resize(4, 9);
+    CHECK(test::equal(list, {3, 2, 9, 9}));
+
+    list.erase_after(list.begin());
+    CHECK(test::equal(list, {3, 9, 9}));
+
+    list.clear();
+    CHECK(list.empty() && list.size() == 0);
+    list.push_back(5);
+    CHECK(test::equal(list, {5}));
+}
+
+static void copy_and_move(void)
+{
+    mfpkg::compact_forward_list<int> a {1, 2, 3};
+    mfpkg::compact_forward_list<int> b(a);
+    CHECK(test::equal(b, {1, 2, 3}));
+    CHECK(&a.get_arena() != &b.get_arena());
+
+    mfpkg::compact_forward_list<int> c(std::move(a));
+    CHECK(test::equal(c, {1, 2, 3}));
+    CHECK(a.empty());
+    a.push_back(4);
+    CHECK(test::equal(a, {4}));
+
+    b = c;
+    b.push_back(4);
+    CHECK(test::equal(b, {1, 2, 3, 4}));
+    CHECK(test::equal(c, {1, 2, 3}));
+}
+
+static void arenas_start_small(void)
+{
+    static_assert(std::is_nothrow_default_constructible<mfpkg::compact_forward_list<int>>::value);
+    static_assert(std::is_nothrow_move_constructible<mfpkg::compact_forward_list<int>>::value);
+
+    mfpkg::compact_forward_list<int> list;
+    CHECK(list.empty() && list.begin() == list.end());
+    list.push_back(1);
+    CHECK(list.get_arena().memory() < 1024);
+
+    mfpkg::compact_forward_list<int> moved(std::move(list));
+    CHECK(list.empty() && list.size() == 0 && list.begin() == list.end());
+    list.sort();
+    list.clear();
+    list.push_front(2);
+    CHECK(test::equal(list, {2}) && test::equal(moved, {1}));
+
+    const int* first = &moved.front();
+    for (int i = 2; i <= 10000; ++i)
+    {
+        moved.push_back(i);
+    }
+    CHECK(&moved.front() == first && moved.size() == 10000 && moved.back() == 10000);
+    long sum = 0;
+    for (int x : moved)
+    {
+        sum += x;
+    }
+    CHECK(sum == 10000L * 10001L / 2);
+}
+
+static void shared_arena_splices_by_relinking(void)
+{
+    mfpkg::compact_arena<int> arena;
+    mfpkg::compact_forward_list<int> a(arena), b(arena);
+    for (int i = 0; i < 4; ++i)
+    {
+        a.push_back(i);
+        b.push_back(10 + i);
+    }
+    std::size_t slots = arena.size();
+    const int* second = &*std::next(b.begin());
+
+    a.splice_after(a.begin(), b);
+    CHECK(test::equal(a, {0, 10, 11, 12, 13, 1, 2, 3}));
+    CHECK(b.empty() && a.size() == 8);
+    CHECK(arena.size() == slots);
+    CHECK(&*std::next(a.begin(), 2) == second);
+
+    b.splice_after(b.before_begin(), a, a.before_begin());
+    CHECK(test::equal(b, {0}));
+    CHECK(a.size() == 7 && a.front() == 10);
+}
+
+static void separate_arenas_move_elements(void)
+{
+    mfpkg::compact_forward_list<int> a {1, 2}, b {3, 4};
+    a.splice_after(a.begin(), b);
+    CHECK(test::equal(a, {1, 3, 4, 2}));
+    CHECK(b.empty());
+    CHECK(a.back() == 2);
+}
+
+int main(void)
+{
+    basic_operations();
+    copy_and_move();
+    arenas_start_small();
+    shared_arena_splices_by_relinking();
+    separate_arenas_move_elements();
+    return test::result();
+}
@@ -0,0 +1,93 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void defragmenting_keeps_order(void)
+{
+    mfpkg::forward_list<int> list;
+    for (int i = 0; i < 1000; ++i)
+    {
+        list.push_front(i);
+    }
+    list.sort();
+    const double scattered = list.fragmentation();
+    CHECK(list.defragment());
+    CHECK(list.size() == 1000 && list.front() == 0 && list.back() == 999);
+    CHECK(list.fragmentation() <= scattered);
+    CHECK(list.fragmentation() <= 2.0 * (sizeof(void*) + sizeof(int)));
+    list.remove(500);
+    list.push_back(1000);
+    CHECK(list.size() == 1000 && list.back() == 1000);
+
+    int expected = 0;
+    bool ordered = true;
+    for (int x : list)
+    {
+        ordered = ordered && x == expected;
+        expected += expected == 499 ? 2 : 1;
+    }
+    CHECK(ordered);
+}
+
+/*
+ * Nodes of a block and ordinary heap nodes are freed side by side, from
+ * several lists and threads, while the block is registered.
+ */
+static void block_and_heap_nodes_mix(void)
+{
+    mfpkg::forward_list<std::string> packed;
+    for (int i = 0; i < 200; ++i)
+    {
+        packed.push_back(std::to_string(i));
+    }
+    CHECK(packed.defragment());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t)
+    {
+        threads.emplace_back([]
+        {
+            mfpkg::forward_list<std::string> loose;
+            for (int i = 0; i < 5000; ++i)
+            {
+                loose.push_back(std::to_string(i));
+                if(i % 3 == 0)
+                {
+                    loose.pop_front();
+                }
+            }
+        });
+    }
+    packed.remove_if([](const std::string& s) { return s.size() == 2; });
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+    CHECK(packed.size() == 110 && packed.front() == "0" && packed.back() == "199");
+
+    mfpkg::forward_list<std::string> moved;
+    moved.splice_after(moved.before_begin(), packed);
+    CHECK(moved.size() == 110 && packed.empty());
+    moved.clear();
+    CHECK(moved.empty());
+}
+
+static void small_lists(void)
+{
+    mfpkg::forward_list<int> empty;
+    empty.defragment();
+    CHECK(empty.empty());
+
+    mfpkg::forward_list<int> one {7};
+    one.defragment();
+    CHECK(test::equal(one, {7}) && one.back() == 7);
+    one.pop_front();
+    CHECK(one.empty());
+}
+
+int main(void)
+{
+    defragmenting_keeps_order();
+    block_and_heap_nodes_mix();
+    small_lists();
+    return test::result();
+}
@@ -0,0 +1,82 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void element_access_and_modifiers(void)
+{
+    mfpkg::forward_list<int> list {2, 3};
+    list.push_front(1);
+    list.push_back(4);
+    CHECK(test::equal(list, {1, 2, 3, 4}));
+    CHECK(list.size() == 4 && list.front() == 1 && list.back() == 4);
+
+    list.pop_front();
+    list.pop_back();
+    CHECK(test::equal(list, {2, 3}));
+    CHECK(list.back() == 3);
+
+    list.insert_after(list.begin(), {7, 8});
+    CHECK(test::equal(list, {2, 7, 8, 3}));
+    list.erase_after(list.begin());
+    CHECK(test::equal(list, {2, 8, 3}));
+
+    list.resize(5, 0);
+    CHECK(test::equal(list, {2, 8, 3, 0, 0}));
+    list.resize(2);
+    CHECK(test::equal(list, {2, 8}));
+    CHECK(list.back() == 8);
+
+    list.clear();
+    CHECK(list.empty() && list.size() == 0);
+    list.push_back(1);
+    CHECK(list.front() == 1 && list.back() == 1);
+}
+
+static void list_algorithms(void)
+{
+    mfpkg::forward_list<int> list {5, 1, 4, 4, 9, 2, 6};
+    list.unique();
+    CHECK(test::equal(list, {5, 1, 4, 9, 2, 6}));
+    list.sort();
+    CHECK(test::equal(list, {1, 2, 4, 5, 6, 9}));
+    list.reverse();
+    CHECK(test::equal(list, {9, 6, 5, 4, 2, 1}));
+    list.remove(4);
+    CHECK(test::equal(list, {9, 6, 5, 2, 1}));
+    list.push_back(0);
+    CHECK(list.back() == 0);
+}
+
+static void splicing_and_swapping(void)
+{
+    mfpkg::forward_list<int> a {2, 4}, b {1, 3, 5};
+    a.splice_after(a.begin(), b);
+    CHECK(test::equal(a, {2, 1, 3, 5, 4}) && b.empty());
+    CHECK(a.back() == 4 && a.size() == 5);
+
+    b.splice_after(b.before_begin(), a, a.begin());
+    CHECK(test::equal(a, {2, 3, 5, 4}) && test::equal(b, {1}));
+    CHECK(b.back() == 1 && a.size() == 4);
+
+    a.swap(b);
+    CHECK(test::equal(a, {1}) && test::equal(b, {2, 3, 5, 4}));
+}
+
+static void copying(void)
+{
+    mfpkg::forward_list<std::string> a {"x", "y"};
+    mfpkg::forward_list<std::string> b(a);
+    b.push_back("z");
+    CHECK(a.size() == 2 && b.size() == 3);
+    CHECK(b.back() == "z");
+    a = b;
+    CHECK(test::equal(a, {std::string("x"), std::string("y"), std::string("z")}));
+}
+
+int main(void)
+{
+    element_access_and_modifiers();
+    list_algorithms();
+    splicing_and_swapping();
+    copying();
+    return test::result();
+}
@@ -0,0 +1,131 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void lookups_follow_modifications(void)
+{
+    mfpkg::indexed_forward_list<int> list {5, 3, 8, 3};
+    CHECK(list.contains(8) && !list.contains(4));
+    CHECK(list.count(3) == 2);
+    CHECK(*list.find(5) == 5);
+    CHECK(list.find(4) == list.end());
+    CHECK(list.find_before(5) == list.before_begin());
+
+    list.push_front(1);
+    list.push_back(9);
+    CHECK(test::equal(list, {1, 5, 3, 8, 3, 9}));
+    CHECK(list.find_before(5) == list.begin());
+
+    CHECK(list.erase(8));
+    CHECK(!list.erase(8));
+    CHECK(test::equal(list, {1, 5, 3, 3, 9}));
+    CHECK(list.remove(3) == 2);
+    CHECK(test::equal(list, {1, 5, 9}));
+
+    list.erase(list.find(5));
+    CHECK(test::equal(list, {1, 9}));
+    CHECK(!list.contains(5));
+
+    list.insert_after(list.begin(), 4);
+    list.erase_after(list.before_begin());
+    CHECK(test::equal(list, {4, 9}));
+    CHECK(list.find_before(9) == list.begin());
+}
+
+static void removing_an_element_by_its_own_reference(void)
+{
+    mfpkg::indexed_forward_list<std::string> list {"x", "y", "x", "x"};
+    CHECK(list.remove(*list.find("x")) == 3);
+    CHECK(test::equal(list, {std::string("y")}));
+}
+
+static void reordering_rebuilds_predecessors(void)
+{
+    mfpkg::indexed_forward_list<int> list {4, 2, 3, 1};
+    list.sort();
+    CHECK(test::equal(list, {1, 2, 3, 4}));
+    list.erase(list.find(3));
+    CHECK(test::equal(list, {1, 2, 4}));
+    list.reverse();
+    CHECK(test::equal(list, {4, 2, 1}));
+    list.erase(list.find(1));
+    CHECK(test::equal(list, {4, 2}));
+    CHECK(list.back() == 2);
+}
+
+static void splicing_moves_index_entries(void)
+{
+    mfpkg::indexed_forward_list<int> a {1, 2}, b {10, 11, 12};
+    a.splice_after(a.begin(), b, b.begin(), b.end());
+    CHECK(test::equal(a, {1, 11, 12, 2}));
+    CHECK(test::equal(b, {10}));
+    CHECK(a.contains(11) && a.contains(12));
+    CHECK(!b.contains(11) && b.contains(10));
+    a.erase(a.find(12));
+    CHECK(test::equal(a, {1, 11, 2}));
+
+    a.splice_after(a.before_begin(), b);
+    CHECK(test::equal(a, {10, 1, 11, 2}));
+    CHECK(b.empty() && !b.contains(10));
+    CHECK(a.find_before(1) == a.begin());
+
+    mfpkg::indexed_forward_list<int> c(a);
+    c.swap(b);
+    CHECK(c.empty() && test::equal(b, {10, 1, 11, 2}));
+    CHECK(b.find_before(10) == b.before_begin());
+}
+
+namespace
+{
+    /*
+     * Throws once when armed and asked to hash 5.
+     */
+    struct flaky_hash
+    {
+        static inline bool armed = false;
+
+        std::size_t operator()(int x) const
+        {
+            if(armed && x == 5)
+            {
+                armed = false;
+                throw std::runtime_error("hash");
+            }
+            return std::hash<int>()(x);
+        }
+    };
+}
+
+static void failed_splice_leaves_both_lists_indexed(void)
+{
+    mfpkg::indexed_forward_list<int, flaky_hash> a {1, 2}, b {3, 4, 5};
+    flaky_hash::armed = true;
+    bool thrown = false;
+    try
+    {
+        a.splice_after(a.begin(), b);
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(test::equal(a, {1, 2}) && test::equal(b, {3, 4, 5}));
+    CHECK(a.contains(1) && a.contains(2) && !a.contains(3) && !a.contains(4));
+    CHECK(b.contains(3) && b.contains(4) && b.contains(5));
+    CHECK(b.find_before(4) == b.begin());
+
+    a.splice_after(a.begin(), b);
+    CHECK(test::equal(a, {1, 3, 4, 5, 2}) && b.empty());
+    a.erase(a.find(4));
+    CHECK(test::equal(a, {1, 3, 5, 2}) && a.find_before(5) == std::next(a.begin()));
+}
+
+int main(void)
+{
+    lookups_follow_modifications();
+    removing_an_element_by_its_own_reference();
+    reordering_rebuilds_predecessors();
+    splicing_moves_index_entries();
+    failed_splice_leaves_both_lists_indexed();
+    return test::result();
+}
@@ -0,0 +1,122 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void capacity_is_never_exceeded(void)
+{
+    mfpkg::inplace_forward_list<int, 4> list;
+    CHECK(list.capacity() == 4);
+    CHECK(list.push_back(1) && list.push_back(2) && list.push_front(0) && list.push_back(3));
+    CHECK(list.full());
+    CHECK(!list.push_back(4));
+    CHECK(!list.push_front(-1));
+    CHECK(list.insert_after(list.begin(), 9) == list.end());
+    CHECK(test::equal(list, {0, 1, 2, 3}));
+    CHECK(list.size() == 4);
+
+    list.erase_after(list.begin());
+    CHECK(!list.full());
+    CHECK(list.push_back(5));
+    CHECK(test::equal(list, {0, 2, 3, 5}));
+    CHECK(sizeof(list) < 4 * sizeof(int) + 16);
+}
+
+static void push_and_pop_round_trips(void)
+{
+    mfpkg::inplace_forward_list<int, 4> list;
+    for (int round = 0; round < 3; ++round)
+    {
+        CHECK(list.push_back(1) && list.push_back(2) && list.push_front(0));
+        CHECK(test::equal(list, {0, 1, 2}));
+        list.pop_front();
+        CHECK(test::equal(list, {1, 2}) && list.front() == 1);
+        list.pop_back();
+        CHECK(test::equal(list, {1}) && list.back() == 1);
+        list.pop_front();
+        CHECK(list.empty() && list.size() == 0);
+        list.pop_front();
+        list.pop_back();
+        CHECK(list.empty());
+    }
+    CHECK(list.push_back(1) && list.push_back(2) && list.push_back(3) && list.push_back(4));
+    CHECK(list.full() && !list.push_front(0));
+    list.pop_front();
+    CHECK(list.push_back(5));
+    CHECK(test::equal(list, {2, 3, 4, 5}) && list.back() == 5);
+}
+
+static void list_algorithms(void)
+{
+    mfpkg::inplace_forward_list<int, 16> list {4, 1, 3, 1, 1, 2};
+    list.unique();
+    CHECK(test::equal(list, {4, 1, 3, 1, 2}));
+    list.remove(1);
+    CHECK(test::equal(list, {4, 3, 2}));
+    list.sort();
+    CHECK(test::equal(list, {2, 3, 4}));
+    list.reverse();
+    CHECK(test::equal(list, {4, 3, 2}));
+    CHECK(list.back() == 2);
+
+    CHECK(list.resize(5, 7));
+    CHECK(test::equal(list, {4, 3, 2, 7, 7}));
+    CHECK(list.resize(1));
+    CHECK(test::equal(list, {4}));
+    CHECK(!list.resize(17));
+}
+
+/*
+ * Shrinking drops the tail in one pass and hands its slots back, so
+ * they can be refilled up to the capacity afterwards.
+ */
+static void shrinking_frees_the_tail(void)
+{
+    mfpkg::inplace_forward_list<std::string, 6> list;
+    CHECK(list.resize(6, "x"));
+    CHECK(list.full());
+    CHECK(list.resize(2));
+    CHECK(list.size() == 2 && list.back() == "x");
+    CHECK(list.push_back("y") && list.back() == "y");
+    CHECK(list.resize(6, "z") && list.full());
+    CHECK(test::equal(list, {std::string("x"), std::string("x"), std::string("y"),
+                             std::string("z"), std::string("z"), std::string("z")}));
+    CHECK(list.resize(0));
+    CHECK(list.empty() && list.size() == 0);
+    CHECK(list.push_front("a") && list.back() == "a");
+    CHECK(list.resize(1));
+    CHECK(test::equal(list, {std::string("a")}));
+
+    mfpkg::inplace_forward_list<int, 3> small {1, 2, 3, 4, 5};
+    CHECK(small.full());
+    CHECK(test::equal(small, {1, 2, 3}) && small.back() == 3);
+}
+
+static void copy_move_and_splice(void)
+{
+    mfpkg::inplace_forward_list<std::string, 8> a {"a", "b"};
+    mfpkg::inplace_forward_list<std::string, 8> b(a);
+    b.push_back("c");
+    CHECK(test::equal(a, {std::string("a"), std::string("b")}));
+    CHECK(test::equal(b, {std::string("a"), std::string("b"), std::string("c")}));
+
+    mfpkg::inplace_forward_list<std::string, 8> c(std::move(b));
+    CHECK(b.empty());
+    CHECK(c.size() == 3);
+
+    CHECK(a.splice_after(a.begin(), c));
+    CHECK(test::equal(a, {std::string("a"), std::string("a"), std::string("b"),
+                          std::string("c"), std::string("b")}));
+    CHECK(c.empty());
+
+    a.swap(c);
+    CHECK(a.empty() && c.size() == 5);
+}
+
+int main(void)
+{
+    capacity_is_never_exceeded();
+    push_and_pop_round_trips();
+    list_algorithms();
+    shrinking_frees_the_tail();
+    copy_move_and_splice();
+    return test::result();
+}
@@ -0,0 +1,138 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+typedef mfpkg::forward_list<int, mfpkg::instrumented<false>> counted_list;
+typedef mfpkg::forward_list<int, mfpkg::instrumented<true>> timed_list;
+
+static std::uint64_t calls(const mfpkg::list_stats& s, mfpkg::list_op op)
+{
+    return s.calls[std::size_t(op)];
+}
+
+static std::uint64_t traversed(const mfpkg::list_stats& s, mfpkg::list_op op)
+{
+    return s.traversed[std::size_t(op)];
+}
+
+static void counters_follow_the_operations(void)
+{
+    counted_list list;
+    for (int i = 0; i < 5; ++i)
+    {
+        list.push_back(i);
+    }
+    list.push_front(-1);
+    list.pop_front();
+    list.pop_back();
+    list.remove(2);
+
+    const mfpkg::list_stats& s = list.stats();
+    CHECK(calls(s, mfpkg::list_op::push_back) == 5);
+    CHECK(calls(s, mfpkg::list_op::push_front) == 1);
+    CHECK(calls(s, mfpkg::list_op::remove) == 1);
+    CHECK(s.allocations == 6);
+    CHECK(s.frees == 3 && s.erasures == 3);
+    CHECK(s.high_water == 6);
+    CHECK(traversed(s, mfpkg::list_op::pop_back) == 4);
+    CHECK(traversed(s, mfpkg::list_op::remove) == 4);
+
+    counted_list other {7, 8};
+    list.splice_after(list.before_begin(), other);
+    CHECK(s.splices == 1 && s.allocations == 6);
+    CHECK(test::equal(list, {7, 8, 0, 1, 3}));
+    CHECK(s.high_water == 6);
+
+    list.clear();
+    CHECK(s.frees == 8 && calls(s, mfpkg::list_op::clear) == 1);
+    CHECK(s.high_water == 6);
+}
+
+/*
+ * Every link the sort reads is reported, including the hops between
+ * runs, so even a three element list shows a full pass per merge width.
+ */
+static void sort_reports_every_link_followed(void)
+{
+    counted_list small {3, 1, 2};
+    small.sort();
+    CHECK(test::equal(small, {1, 2, 3}));
+    CHECK(traversed(small.stats(), mfpkg::list_op::sort) >= 2 * 2);
+
+    counted_list list;
+    const std::size_t n = 1000;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        list.push_front(int(i * 7919 % n));
+    }
+    list.sort();
+    // Ten merge widths, each of which reaches every node.
+    CHECK(traversed(list.stats(), mfpkg::list_op::sort) >= 10 * (n - 1));
+    CHECK(list.front() == 0 && list.back() == int(n - 1));
+}
+
+static void histogram_percentiles(void)
+{
+    mfpkg::latency_histogram h;
+    CHECK(h.count() == 0 && h.percentile(50) == 0 && h.min() == 0);
+    for (std::uint64_t ns = 1; ns <= 1000; ++ns)
+    {
+        h.record(ns);
+    }
+    CHECK(h.count() == 1000 && h.min() == 1 && h.max() == 1000);
+    CHECK(h.mean() == 500.5);
+    const std::uint64_t p50 = h.percentile(50);
+    const std::uint64_t p99 = h.percentile(99);
+    CHECK(p50 >= 500 && p50 <= 500 + 500 / 8);
+    CHECK(p99 >= 990 && p99 <= 1000);
+    CHECK(h.percentile(100) == 1000 && h.percentile(0) == 1);
+
+    mfpkg::latency_histogram exact;
+    exact.record(5);
+    exact.record(9);
+    CHECK(exact.percentile(50) == 5 && exact.percentile(100) == 9);
+}
+
+static void timed_lists_and_dumps(void)
+{
+    timed_list list;
+    for (int i = 0; i < 100; ++i)
+    {
+        list.push_back(i);
+    }
+    list.reverse();
+    const mfpkg::timed_list_stats& s = list.stats();
+    const mfpkg::latency_histogram& pushes = s.latency[std::size_t(mfpkg::list_op::push_back)];
+    CHECK(pushes.count() == 100);
+    CHECK(pushes.percentile(50) <= pushes.percentile(99) && pushes.percentile(99) <= pushes.max());
+    CHECK(s.latency[std::size_t(mfpkg::list_op::reverse)].count() == 1);
+    CHECK(s.latency[std::size_t(mfpkg::list_op::sort)].count() == 0);
+
+    const char* path = "instrumentation.stats";
+    CHECK(list.dump_stats(path));
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    const std::string dumped = text.str();
+    CHECK(dumped.find("allocations 100\n") != std::string::npos);
+    CHECK(dumped.find("high_water 100\n") != std::string::npos);
+    CHECK(dumped.find("push_back calls 100 traversed 0\n") != std::string::npos);
+    CHECK(dumped.find("reverse calls 1 traversed 100\n") != std::string::npos);
+    CHECK(dumped.find("push_back ns min ") != std::string::npos);
+    CHECK(dumped.find("sort") == std::string::npos);
+    std::remove(path);
+
+    CHECK(!list.dump_stats("no/such/directory/list.stats"));
+}
+
+int main(void)
+{
+    counters_follow_the_operations();
+    sort_reports_every_link_followed();
+    histogram_percentiles();
+    timed_lists_and_dumps();
+    return test::result();
+}
@@ -0,0 +1,176 @@
+#include "mfpkg.h"
+#include "check.h"
+
+/*
+ * Lists of lengths 0, 1, 2, ... with every third one empty, so empty
+ * lists sit between, before and after non-empty ones.
+ */
+static std::vector<mfpkg::forward_list<int>> buckets(std::size_t n)
+{
+    std::vector<mfpkg::forward_list<int>> lists(n);
+    for (std::size_t l = 0; l < n; ++l)
+    {
+        if(l % 3 != 0)
+        {
+            for (std::size_t i = 0; i <= l; ++i)
+            {
+                lists[l].push_back(int(l * 1000 + i));
+            }
+        }
+    }
+    return lists;
+}
+
+/*
+ * True when @a seen holds every element of @a lists once, each list's
+ * elements in list order.
+ */
+static bool visited_in_order(const std::vector<mfpkg::forward_list<int>>& lists,
+                             const std::vector<std::vector<int>>& seen)
+{
+    if(seen.size() != lists.size())
+    {
+        return false;
+    }
+    for (std::size_t l = 0; l < lists.size(); ++l)
+    {
+        std::vector<int> expected(lists[l].begin(), lists[l].end());
+        if(seen[l] != expected)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void every_element_once_per_list_order(void)
+{
+    const std::vector<mfpkg::forward_list<int>> lists = buckets(40);
+    for (std::size_t width : {std::size_t(0), std::size_t(1), std::size_t(3), std::size_t(39),
+                              std::size_t(40), std::size_t(64), std::size_t(1000)})
+    {
+        std::vector<std::vector<int>> seen(lists.size());
+        mfpkg::for_each_interleaved(lists, [&](std::size_t l, int x)
+        {
+            seen[l].push_back(x);
+        }, width);
+        CHECK(visited_in_order(lists, seen));
+    }
+
+    long sum = 0;
+    mfpkg::for_each_interleaved(lists, [&](int x) { sum += x; }, 5);
+    long expected = 0;
+    for (const mfpkg::forward_list<int>& list : lists)
+    {
+        expected += list.sum();
+    }
+    CHECK(sum == expected);
+}
+
+static void ranges_of_pointers(void)
+{
+    std::vector<mfpkg::forward_list<int>> lists = buckets(10);
+    std::vector<mfpkg::forward_list<int>*> pointers;
+    for (std::size_t l = lists.size(); l-- > 0; )
+    {
+        pointers.push_back(&lists[l]);
+    }
+    std::vector<std::vector<int>> seen(lists.size());
+    mfpkg::for_each_interleaved(pointers, [&](std::size_t l, int& x)
+    {
+        seen[lists.size() - 1 - l].push_back(x);
+        x = -x;
+    }, 4);
+    for (mfpkg::forward_list<int>& list : lists)
+    {
+        for (int& x : list)
+        {
+            x = -x;
+        }
+    }
+    CHECK(visited_in_order(lists, seen));
+
+    auto found = mfpkg::find_if_interleaved(pointers, [](int x) { return x % 1000 == 2; }, 2);
+    CHECK(found.size() == pointers.size());
+    bool right = true;
+    for (std::size_t p = 0; p < pointers.size(); ++p)
+    {
+        const std::size_t l = lists.size() - 1 - p;
+        if(l % 3 == 0 || l < 2)
+        {
+            right = right && found[p] == pointers[p]->end();
+        }
+        else
+        {
+            right = right && found[p] != pointers[p]->end() && *found[p] == int(l * 1000 + 2);
+        }
+    }
+    CHECK(right);
+}
+
+/*
+ * Each list is searched for its own key and left at its first match,
+ * at widths below and above the number of lists.
+ */
+static void first_match_per_list(void)
+{
+    std::vector<mfpkg::forward_list<int>> lists = buckets(25);
+    lists[4].push_back(int(4 * 1000 + 1));
+    for (std::size_t width : {std::size_t(1), std::size_t(7), std::size_t(25), std::size_t(100)})
+    {
+        std::vector<std::size_t> visits(lists.size());
+        auto found = mfpkg::find_if_interleaved(lists, [&](std::size_t l, int x)
+        {
+            ++visits[l];
+            return x == int(l * 1000 + 1);
+        }, width);
+        CHECK(found.size() == lists.size());
+        bool right = true;
+        for (std::size_t l = 0; l < lists.size(); ++l)
+        {
+            if(l % 3 == 0)
+            {
+                right = right && found[l] == lists[l].end() && visits[l] == 0;
+            }
+            else
+            {
+                auto second = lists[l].begin();
+                ++second;
+                right = right && found[l] == second && visits[l] == 2;
+            }
+        }
+        CHECK(right);
+    }
+
+    auto none = mfpkg::find_if_interleaved(lists, [](int x) { return x < 0; });
+    bool ends = true;
+    for (std::size_t l = 0; l < lists.size(); ++l)
+    {
+        ends = ends && none[l] == lists[l].end();
+    }
+    CHECK(ends);
+}
+
+static void no_lists(void)
+{
+    std::vector<mfpkg::forward_list<int>> lists;
+    int calls = 0;
+    mfpkg::for_each_interleaved(lists, [&](int) { ++calls; });
+    CHECK(calls == 0);
+    CHECK(mfpkg::find_if_interleaved(lists, [](int) { return true; }).empty());
+
+    std::vector<mfpkg::forward_list<int>> empties(5);
+    mfpkg::for_each_interleaved(empties, [&](int) { ++calls; }, 2);
+    CHECK(calls == 0);
+    auto found = mfpkg::find_if_interleaved(empties, [](int) { return true; }, 2);
+    CHECK(found.size() == 5 && found[4] == empties[4].end());
+}
+
+int main(void)
+{
+    every_element_once_per_list_order();
+    ranges_of_pointers();
+    first_match_per_list();
+    no_lists();
+    return test::result();
+}
@@ -0,0 +1,258 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <algorithm>
+
+typedef mfpkg::layout<true, false> tail_only;
+typedef mfpkg::layout<false, true> size_only;
+typedef mfpkg::layout<false, false> bare;
+
+/*
+ * Compares @a list with @a ref through iteration, size(), empty() and
+ * back(), which take different paths depending on the layout.
+ */
+template <typename List>
+static bool same(const List& list, const std::vector<int>& ref)
+{
+    return list.size() == ref.size() && list.empty() == ref.empty()
+        && std::equal(ref.begin(), ref.end(), list.begin(), list.end())
+        && (ref.empty() || list.back() == ref.back());
+}
+
+template <typename List>
+static auto at(List& list, std::size_t n)
+{
+    auto it = list.before_begin();
+    for (; n; --n)
+    {
+        ++it;
+    }
+    return it;
+}
+
+template <typename List>
+static void append(List& list, int x)
+{
+    list.insert_after(at(list, list.size()), x);
+}
+
+template <typename List>
+static List make(std::initializer_list<int> values)
+{
+    List list;
+    for (int x : values)
+    {
+        append(list, x);
+    }
+    return list;
+}
+
+template <typename Layout>
+static void modifiers(void)
+{
+    typedef mfpkg::forward_list<int, Layout> list_type;
+    list_type list {3, 1, 2};
+    std::vector<int> ref {3, 1, 2};
+    CHECK(same(list, ref));
+
+    list.push_front(5);
+    ref.insert(ref.begin(), 5);
+    append(list, 4);
+    ref.push_back(4);
+    CHECK(same(list, ref));
+
+    list.pop_back();
+    ref.pop_back();
+    list.pop_front();
+    ref.erase(ref.begin());
+    CHECK(same(list, ref));
+
+    list.erase_after(at(list, 1));
+    ref.erase(ref.begin() + 1);
+    CHECK(same(list, ref));
+
+    list.resize(5, 9);
+    ref.resize(5, 9);
+    CHECK(same(list, ref));
+    list.resize(2);
+    ref.resize(2);
+    CHECK(same(list, ref));
+
+    list_type one {7};
+    one.pop_back();
+    CHECK(one.empty() && one.size() == 0);
+    one.pop_back();
+    one.resize(0);
+    CHECK(one.empty());
+    append(one, 8);
+    CHECK(same(one, {8}));
+
+    list.clear();
+    CHECK(same(list, {}));
+    append(list, 1);
+    CHECK(same(list, {1}));
+}
+
+template <typename Layout>
+static void relinking(void)
+{
+    typedef mfpkg::forward_list<int, Layout> list_type;
+    list_type a = make<list_type>({1, 2, 3});
+    list_type b = make<list_type>({7, 8, 9});
+
+    a.splice_after(at(a, 3), b);
+    CHECK(same(a, {1, 2, 3, 7, 8, 9}) && same(b, {}));
+
+    b.splice_after(b.before_begin(), a, at(a, 5));
+    CHECK(same(a, {1, 2, 3, 7, 8}) && same(b, {9}));
+    b.splice_after(b.begin(), a, at(a, 1), at(a, 4));
+    CHECK(same(a, {1, 7, 8}) && same(b, {9, 2, 3}));
+    b.splice_after(b.before_begin(), a, at(a, 1), a.end());
+    CHECK(same(a, {1}) && same(b, {7, 8, 9, 2, 3}));
+
+    b.sort();
+    CHECK(same(b, {2, 3, 7, 8, 9}));
+    b.reverse();
+    CHECK(same(b, {9, 8, 7, 3, 2}));
+    append(b, 2);
+    b.unique();
+    CHECK(same(b, {9, 8, 7, 3, 2}));
+    b.remove(2);
+    CHECK(same(b, {9, 8, 7, 3}));
+
+    auto odd = b.partition([](int x) { return x % 2 != 0; });
+    CHECK(same(odd, {9, 7, 3}) && same(b, {8}));
+    auto rest = odd.split_at(1);
+    CHECK(same(odd, {9}) && same(rest, {7, 3}));
+    auto tail = rest.split_after(rest.begin());
+    CHECK(same(rest, {7}) && same(tail, {3}));
+    CHECK(rest.split_at(5).empty() && same(rest, {7}));
+
+    a.swap(tail);
+    CHECK(same(a, {3}) && same(tail, {1}));
+    list_type empty;
+    a.swap(empty);
+    CHECK(same(a, {}) && same(empty, {3}));
+}
+
+template <typename Layout>
+static void node_handles(void)
+{
+    typedef mfpkg::forward_list<int, Layout> list_type;
+    list_type a = make<list_type>({1, 2, 3});
+    auto last = a.extract_after(at(a, 2));
+    CHECK(last && last.value() == 3 && same(a, {1, 2}));
+    auto first = a.extract_after(a.before_begin());
+    CHECK(same(a, {2}));
+
+    list_type b;
+    b.insert_after(b.before_begin(), std::move(last));
+    CHECK(same(b, {3}));
+    b.insert_after(b.begin(), std::move(first));
+    CHECK(same(b, {3, 1}));
+
+    mfpkg::forward_list<int> full;
+    full.push_back(4);
+    b.insert_after(at(b, 1), full.extract_after(full.before_begin()));
+    CHECK(same(b, {3, 4, 1}) && full.empty());
+    a.insert_after(at(a, 1), b.extract_after(at(b, 2)));
+    CHECK(same(a, {2, 1}) && same(b, {3, 4}));
+}
+
+template <typename Layout>
+static void copying_moving_and_defragmenting(void)
+{
+    typedef mfpkg::forward_list<int, Layout> list_type;
+    list_type a;
+    for (int i = 0; i < 200; ++i)
+    {
+        a.push_front(i);
+    }
+    a.sort();
+    CHECK(a.defragment());
+    std::vector<int> ref(200);
+    for (int i = 0; i < 200; ++i)
+    {
+        ref[std::size_t(i)] = i;
+    }
+    CHECK(same(a, ref));
+    a.remove(199);
+    ref.pop_back();
+    append(a, 500);
+    ref.push_back(500);
+    CHECK(same(a, ref));
+
+    list_type copy(a);
+    CHECK(same(copy, ref));
+    list_type moved(std::move(a));
+    CHECK(same(moved, ref) && same(a, {}));
+    append(a, 1);
+    CHECK(same(a, {1}));
+    a = std::move(moved);
+    CHECK(same(a, ref));
+    moved = copy;
+    CHECK(same(moved, ref));
+
+    list_type single {5};
+    single.defragment();
+    CHECK(same(single, {5}));
+}
+
+template <typename Layout>
+static void every_test(void)
+{
+    modifiers<Layout>();
+    relinking<Layout>();
+    node_handles<Layout>();
+    copying_moving_and_defragmenting<Layout>();
+}
+
+/*
+ * Moving a %list relinks its header; the elements are not touched.
+ */
+static void moving_copies_no_elements(void)
+{
+    static_assert(std::is_nothrow_move_constructible<mfpkg::forward_list<test::counted>>::value);
+    static_assert(std::is_nothrow_move_constructible<mfpkg::forward_list<test::counted, bare>>::value);
+
+    mfpkg::forward_list<test::counted> list {1, 2, 3};
+    test::counted::reset();
+    mfpkg::forward_list<test::counted> moved(std::move(list));
+    CHECK(test::counted::copies == 0 && test::counted::moves == 0);
+    CHECK(list.empty() && list.size() == 0);
+    CHECK(test::equal(moved, {test::counted(1), test::counted(2), test::counted(3)}));
+    CHECK(moved.back() == test::counted(3));
+    list.push_back(4);
+    CHECK(test::equal(list, {test::counted(4)}));
+
+    std::vector<mfpkg::forward_list<test::counted>> lists;
+    int copies = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        mfpkg::forward_list<test::counted> one {i};
+        test::counted::reset();
+        lists.push_back(std::move(one));
+        copies += test::counted::copies + test::counted::moves;
+    }
+    CHECK(copies == 0);
+    CHECK(lists.front().front() == test::counted(0) && lists.back().front() == test::counted(99));
+}
+
+static void header_sizes(void)
+{
+    CHECK(sizeof(mfpkg::forward_list<int, bare>) == sizeof(void*));
+    CHECK(sizeof(mfpkg::forward_list<int, tail_only>) == 2 * sizeof(void*));
+    CHECK(sizeof(mfpkg::forward_list<int, size_only>) == sizeof(void*) + sizeof(std::size_t));
+    CHECK(sizeof(mfpkg::forward_list<int, bare>) < sizeof(mfpkg::forward_list<int>));
+}
+
+int main(void)
+{
+    every_test<mfpkg::no_instrumentation>();
+    every_test<tail_only>();
+    every_test<size_only>();
+    every_test<bare>();
+    moving_copies_no_elements();
+    header_sizes();
+    return test::result();
+}
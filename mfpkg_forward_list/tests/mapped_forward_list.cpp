@@ -0,0 +1,131 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#if defined(MFPKG_HAS_MAPPED_LIST)
+
+namespace
+{
+    /* A fresh empty file, removed when the test ends. */
+    struct temp_file
+    {
+        char path[64];
+
+        temp_file()
+        {
+            std::snprintf(path, sizeof path, "/tmp/mfpkg_mapped_XXXXXX");
+            int fd = ::mkstemp(path);
+            CHECK(fd >= 0);
+            ::close(fd);
+        }
+
+        ~temp_file() { ::unlink(path); }
+    };
+
+    struct point
+    {
+        int x, y;
+
+        bool operator==(const point& p) const noexcept { return x == p.x && y == p.y; }
+    };
+}
+
+static void contents_survive_reopening(void)
+{
+    temp_file file;
+    {
+        mfpkg::mapped_forward_list<point> list(file.path);
+        CHECK(list.empty());
+        list.push_back({1, 2});
+        list.push_back({3, 4});
+        list.push_front({0, 0});
+        list.insert_after(list.begin(), {9, 9});
+        list.erase_after(list.begin());
+        list.sync();
+    }
+    {
+        mfpkg::mapped_forward_list<point> list(file.path);
+        CHECK(test::equal(list, {point{0, 0}, point{1, 2}, point{3, 4}}));
+        CHECK(list.size() == 3);
+        CHECK((list.back() == point{3, 4}));
+        list.push_back({5, 6});
+        CHECK(list.back().x == 5);
+    }
+}
+
+static void released_nodes_are_reused(void)
+{
+    temp_file file;
+    mfpkg::mapped_forward_list<long> list(file.path, 1000);
+    for (long i = 0; i < 1000; ++i)
+    {
+        list.push_back(999 - i);
+    }
+    std::size_t bytes = list.file_size();
+    list.clear();
+    CHECK(list.empty());
+    for (long i = 0; i < 1000; ++i)
+    {
+        list.push_front(i);
+    }
+    CHECK(list.file_size() == bytes);
+
+    list.sort();
+    CHECK(list.front() == 0 && list.back() == 999);
+    list.reverse();
+    CHECK(list.front() == 999 && list.back() == 0);
+    list.pop_front();
+    CHECK(list.size() == 999 && list.front() == 998);
+}
+
+static void mismatched_files_are_rejected(void)
+{
+    temp_file file;
+    {
+        mfpkg::mapped_forward_list<int> list(file.path);
+        list.push_back(1);
+    }
+    bool thrown = false;
+    try
+    {
+        mfpkg::mapped_forward_list<point> list(file.path);
+    }
+    catch (const std::system_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    temp_file junk;
+    {
+        std::ofstream out(junk.path, std::ios::binary);
+        out << std::string(256, 'x');
+    }
+    thrown = false;
+    try
+    {
+        mfpkg::mapped_forward_list<int> list(junk.path);
+    }
+    catch (const std::system_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+int main(void)
+{
+    contents_survive_reopening();
+    released_nodes_are_reused();
+    mismatched_files_are_rejected();
+    return test::result();
+}
+
+#else
+
+int main(void)
+{
+    std::puts("mapped_forward_list is not available on this platform; skipped");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void scopes_nest(void)
+{
+    CHECK(mfpkg::node_arena::active() == nullptr);
+    mfpkg::node_arena outer(1 << 20, false);
+    mfpkg::node_arena inner(1 << 20, false);
+    {
+        mfpkg::node_arena::scope a(outer);
+        CHECK(mfpkg::node_arena::active() == &outer);
+        {
+            mfpkg::node_arena::scope b(inner);
+            CHECK(mfpkg::node_arena::active() == &inner);
+        }
+        CHECK(mfpkg::node_arena::active() == &outer);
+    }
+    CHECK(mfpkg::node_arena::active() == nullptr);
+    CHECK(outer.stats().regions == 0 && inner.stats().regions == 0);
+}
+
+/*
+ * Nodes come from the arena of the innermost scope and may be released
+ * after it ended, on this thread or another one; either way their bytes
+ * go back to the arena's free lists.
+ */
+static void nodes_outlive_their_scope(void)
+{
+    mfpkg::node_arena outer(1 << 20, false);
+    mfpkg::node_arena inner(1 << 20, false);
+    mfpkg::forward_list<int> a, b, c;
+    {
+        mfpkg::node_arena::scope s(outer);
+        a.resize(100, 1);
+        {
+            mfpkg::node_arena::scope t(inner);
+            b.resize(200, 2);
+            c.resize(300, 3);
+        }
+        a.push_back(4);
+    }
+    mfpkg::forward_list<int> heap {5, 6};
+
+    const mfpkg::node_arena::statistics o = outer.stats();
+    const mfpkg::node_arena::statistics i = inner.stats();
+    CHECK(o.regions == 1 && i.regions == 1);
+    CHECK(o.used > 0 && i.used > o.used);
+    CHECK(o.reserved >= std::size_t(1 << 20) && o.fill() > 0.0);
+    CHECK(a.size() == 101 && a.back() == 4);
+
+    b.clear();
+    CHECK(inner.stats().used > 0 && inner.stats().cached > 0);
+    std::thread([&c] { c.clear(); }).join();
+    CHECK(inner.stats().used == 0);
+    CHECK(inner.stats().cached == i.used);
+
+    a.sort();
+    a.pop_front();
+    CHECK(outer.stats().used < o.used);
+    a.clear();
+    CHECK(outer.stats().used == 0);
+
+    {
+        mfpkg::node_arena::scope t(inner);
+        b.resize(200, 7);
+    }
+    CHECK(inner.stats().used > 0 && inner.stats().regions == 1);
+    CHECK(inner.stats().cached < i.used);
+    b.splice_after(b.before_begin(), heap);
+    CHECK(b.size() == 202 && b.front() == 5 && b.back() == 7);
+    b.clear();
+    CHECK(inner.stats().used == 0);
+}
+
+static void oversized_requests_use_the_heap(void)
+{
+    mfpkg::node_arena arena(1 << 20, false);
+    CHECK(arena.allocate(mfpkg::node_arena::max_size + 1, 16) == nullptr);
+    CHECK(arena.allocate(16, 2 * mfpkg::node_arena::max_align) == nullptr);
+
+    void* p = arena.allocate(24, 16);
+    CHECK(p != nullptr && arena.stats().used == 32);
+    arena.deallocate(p, 24, 16);
+    CHECK(arena.stats().used == 0 && arena.stats().cached == 32);
+    CHECK(arena.allocate(20, 16) == p);
+}
+
+int main(void)
+{
+    scopes_nest();
+    nodes_outlive_their_scope();
+    oversized_requests_use_the_heap();
+    return test::result();
+}
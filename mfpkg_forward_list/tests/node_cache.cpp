@@ -0,0 +1,129 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <set>
+
+typedef basic_mfpkg::node_cache cache;
+
+/* A size class no other test in this file touches. */
+static const std::size_t node_bytes = 200;
+
+static void freed_nodes_are_reused(void)
+{
+    CHECK(cache::cached(node_bytes, alignof(void*)));
+    CHECK(!cache::cached(cache::max_size + 1, alignof(void*)));
+
+    void* p = cache::allocate(node_bytes);
+    CHECK(p != nullptr);
+    cache::deallocate(p, node_bytes);
+    CHECK(cache::allocate(node_bytes - 4) == p);
+    cache::deallocate(p, node_bytes);
+}
+
+/*
+ * Nodes allocated on one thread and freed on another end up in the
+ * depot when the freeing thread exits, and a third thread gets them back.
+ */
+static void nodes_move_between_threads(void)
+{
+    const std::size_t n = 10 * cache::magazine_size;
+    std::vector<void*> nodes;
+    std::thread([&]
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            nodes.push_back(cache::allocate(node_bytes));
+        }
+    }).join();
+
+    std::thread([&]
+    {
+        for (void* p : nodes)
+        {
+            cache::deallocate(p, node_bytes);
+        }
+    }).join();
+
+    const std::set<void*> freed(nodes.begin(), nodes.end());
+    CHECK(freed.size() == n);
+    std::size_t reused = 0;
+    std::thread([&]
+    {
+        std::vector<void*> again;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            again.push_back(cache::allocate(node_bytes));
+            reused += freed.count(again.back());
+        }
+        for (void* p : again)
+        {
+            cache::deallocate(p, node_bytes);
+        }
+        cache::trim();
+    }).join();
+    CHECK(reused >= n - 2 * cache::magazine_size);
+}
+
+/*
+ * Lists built on producer threads are destroyed on a consumer thread
+ * while the producers keep allocating.
+ */
+static void lists_are_freed_on_other_threads(void)
+{
+    const int producers = 4;
+    const int rounds = 50;
+    std::mutex lock;
+    std::vector<mfpkg::forward_list<std::string>> handed;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < producers; ++t)
+    {
+        threads.emplace_back([&]
+        {
+            for (int r = 0; r < rounds; ++r)
+            {
+                mfpkg::forward_list<std::string> list;
+                for (int i = 0; i < 100; ++i)
+                {
+                    list.push_back(std::to_string(i));
+                }
+                std::lock_guard<std::mutex> guard(lock);
+                handed.push_back(std::move(list));
+            }
+        });
+    }
+    long total = 0;
+    bool intact = true;
+    std::thread consumer([&]
+    {
+        for (int done = 0; done < producers * rounds; )
+        {
+            std::vector<mfpkg::forward_list<std::string>> batch;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                batch.swap(handed);
+            }
+            for (mfpkg::forward_list<std::string>& list : batch)
+            {
+                intact = intact && list.front() == "0" && list.back() == "99";
+                total += long(list.size());
+                list.clear();
+                ++done;
+            }
+        }
+    });
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+    consumer.join();
+    CHECK(intact);
+    CHECK(total == long(producers) * rounds * 100);
+}
+
+int main(void)
+{
+    freed_nodes_are_reused();
+    nodes_move_between_threads();
+    lists_are_freed_on_other_threads();
+    return test::result();
+}
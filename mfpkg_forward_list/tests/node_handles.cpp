@@ -0,0 +1,117 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <memory>
+
+static void extract_and_insert(void)
+{
+    mfpkg::forward_list<int> a {2, 1, 3, 5};
+    mfpkg::forward_list<int> b {6};
+    const int* address = &*++a.begin();
+    auto node = a.extract_after(a.begin());
+    CHECK(node && node.value() == 1 && &node.value() == address);
+    CHECK(test::equal(a, {2, 3, 5}) && a.size() == 3);
+    auto it = b.insert_after(b.before_begin(), std::move(node));
+    CHECK(!node && test::equal(b, {1, 6}) && &*it == address);
+
+    auto last = a.extract_after(++a.begin());
+    CHECK(last.value() == 5 && a.back() == 3);
+    a.push_back(4);
+    CHECK(test::equal(a, {2, 3, 4}));
+    b.insert_after(++b.begin(), std::move(last));
+    CHECK(test::equal(b, {1, 6, 5}) && b.back() == 5 && b.size() == 3);
+
+    auto none = b.extract_after(++++b.begin());
+    CHECK(none.empty() && b.size() == 3);
+    CHECK(b.insert_after(b.begin(), std::move(none)) == b.begin());
+    CHECK(b.size() == 3);
+}
+
+static void handles_own_their_element(void)
+{
+    auto shared = std::make_shared<int>(1);
+    mfpkg::forward_list<std::shared_ptr<int>> list {shared, shared};
+    CHECK(shared.use_count() == 3);
+    {
+        auto node = list.extract_after(list.before_begin());
+        CHECK(shared.use_count() == 3 && list.size() == 1);
+        decltype(node) other;
+        other = std::move(node);
+        CHECK(!node && other && shared.use_count() == 3);
+    }
+    CHECK(shared.use_count() == 2);
+
+    auto node = list.extract_after(list.before_begin());
+    std::thread([&] { node = decltype(node)(); }).join();
+    CHECK(shared.use_count() == 1 && list.empty());
+}
+
+/*
+ * Handles travel between lists with different layouts and policies.
+ */
+static void handles_cross_list_types(void)
+{
+    mfpkg::forward_list<int, mfpkg::instrumented<false>> counted {1, 2};
+    mfpkg::forward_list<int, mfpkg::layout<false, false>> bare;
+    auto node = counted.extract_after(counted.before_begin());
+    bare.insert_after(bare.before_begin(), std::move(node));
+    CHECK(test::equal(bare, {1}) && test::equal(counted, {2}));
+    CHECK(counted.stats().frees == 0 && counted.stats().allocations == 2);
+    counted.insert_after(counted.begin(), bare.extract_after(bare.before_begin()));
+    CHECK(test::equal(counted, {2, 1}) && counted.back() == 1 && bare.empty());
+    CHECK(counted.stats().allocations == 2);
+}
+
+static void indexed_lists_file_and_unfile(void)
+{
+    mfpkg::indexed_forward_list<int> indexed {10, 20, 30, 20};
+    auto node = indexed.extract_after(indexed.find_before(30));
+    CHECK(node && node.value() == 30);
+    CHECK(!indexed.contains(30) && indexed.size() == 3 && indexed.back() == 20);
+    CHECK(test::equal(indexed, {10, 20, 20}));
+
+    // The element is refiled under the value it has when inserted.
+    node.value() = 35;
+    auto it = indexed.insert_after(indexed.before_begin(), std::move(node));
+    CHECK(!node && *it == 35 && it == indexed.begin());
+    CHECK(indexed.contains(35) && indexed.find(35) == indexed.begin());
+    CHECK(test::equal(indexed, {35, 10, 20, 20}));
+    CHECK(*indexed.find_before(10) == 35);
+
+    // The predecessor table is current on both sides of the moves.
+    indexed.erase(indexed.find(10));
+    CHECK(test::equal(indexed, {35, 20, 20}));
+    CHECK(indexed.erase(35) && test::equal(indexed, {20, 20}));
+    auto tail = indexed.extract_after(indexed.begin());
+    CHECK(tail.value() == 20 && indexed.count(20) == 1 && indexed.back() == 20);
+    indexed.push_back(40);
+    CHECK(test::equal(indexed, {20, 40}) && *indexed.find_before(40) == 20);
+
+    CHECK(indexed.extract_after(indexed.find(40)).empty());
+    CHECK(indexed.insert_after(indexed.begin(), decltype(tail)()) == indexed.begin());
+
+    mfpkg::forward_list<int> plain {1};
+    plain.insert_after(plain.begin(), std::move(tail));
+    CHECK(test::equal(plain, {1, 20}));
+    indexed.insert_after(indexed.find(40), plain.extract_after(plain.before_begin()));
+    CHECK(test::equal(indexed, {20, 40, 1}) && indexed.back() == 1);
+    CHECK(indexed.contains(1) && *indexed.find_before(1) == 40);
+    CHECK(indexed.remove(20) == 1 && test::equal(indexed, {40, 1}));
+    CHECK(test::equal(plain, {20}));
+
+    mfpkg::indexed_forward_list<std::string> empty;
+    mfpkg::forward_list<std::string> words {"x"};
+    empty.insert_after(empty.before_begin(), words.extract_after(words.before_begin()));
+    CHECK(empty.size() == 1 && empty.front() == "x" && empty.back() == "x" && words.empty());
+    empty.erase(empty.begin());
+    CHECK(empty.empty() && !empty.contains("x"));
+}
+
+int main(void)
+{
+    extract_and_insert();
+    handles_own_their_element();
+    handles_cross_list_types();
+    indexed_lists_file_and_unfile();
+    return test::result();
+}
@@ -0,0 +1,57 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void built_lists_keep_range_order(void)
+{
+    for (std::size_t n : {std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(100000)})
+    {
+        std::vector<long> values(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            values[i] = long(i) * 3;
+        }
+        auto list = mfpkg::forward_list<long>::from_range_parallel(values, 4);
+        CHECK(list.size() == n);
+        CHECK(std::equal(list.begin(), list.end(), values.begin(), values.end()));
+        if(n)
+        {
+            CHECK(list.back() == values.back());
+        }
+        list.push_back(-1);
+        CHECK(list.back() == -1 && list.size() == n + 1);
+
+        list.clear_parallel(4);
+        CHECK(list.empty() && list.size() == 0);
+        list.push_back(1);
+        CHECK(test::equal(list, {1L}));
+    }
+
+    std::vector<std::string> words {"a", "b", "c"};
+    auto strings = mfpkg::forward_list<std::string>::from_range_parallel(words);
+    CHECK(test::equal(strings, {std::string("a"), std::string("b"), std::string("c")}));
+}
+
+/*
+ * Building and clearing from inside a task runs inline on that task's
+ * thread.
+ */
+static void building_inside_a_task(void)
+{
+    std::vector<long> values(1000, 1);
+    std::atomic<int> built(0);
+    basic_mfpkg::task_pool::instance().run(4, 4, [&](std::size_t)
+    {
+        auto list = mfpkg::forward_list<long>::from_range_parallel(values, 4);
+        built.fetch_add(int(list.size()));
+        list.clear_parallel(4);
+        CHECK(list.empty());
+    });
+    CHECK(built.load() == 4000);
+}
+
+int main(void)
+{
+    built_lists_keep_range_order();
+    building_inside_a_task();
+    return test::result();
+}
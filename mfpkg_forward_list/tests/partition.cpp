@@ -0,0 +1,106 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void partition_and_split(void)
+{
+    mfpkg::forward_list<int> a {1, 2, 3, 4, 5, 6};
+    auto odd = a.partition([](int x) { return x % 2 != 0; });
+    CHECK(test::equal(odd, {1, 3, 5}));
+    CHECK(test::equal(a, {2, 4, 6}));
+    CHECK(odd.back() == 5 && a.back() == 6);
+    CHECK(odd.size() == 3 && a.size() == 3);
+
+    auto tail = a.split_at(1);
+    CHECK(test::equal(a, {2}) && test::equal(tail, {4, 6}));
+    CHECK(a.back() == 2 && tail.back() == 6);
+    auto rest = tail.split_after(tail.begin());
+    CHECK(test::equal(tail, {4}) && test::equal(rest, {6}));
+    CHECK(tail.back() == 4 && rest.back() == 6);
+
+    a.splice_after(a.begin(), odd);
+    CHECK(test::equal(a, {2, 1, 3, 5}) && odd.empty());
+    CHECK(a.back() == 5 && a.size() == 4);
+    a.push_back(7);
+    odd.push_back(9);
+    CHECK(test::equal(a, {2, 1, 3, 5, 7}) && test::equal(odd, {9}));
+}
+
+static void edge_cases(void)
+{
+    mfpkg::forward_list<int> list {1, 2, 3};
+    auto none = list.partition([](int) { return false; });
+    CHECK(none.empty() && test::equal(list, {1, 2, 3}) && list.back() == 3);
+    auto all = list.partition([](int) { return true; });
+    CHECK(list.empty() && test::equal(all, {1, 2, 3}) && all.back() == 3);
+    list.push_back(4);
+    CHECK(test::equal(list, {4}));
+
+    auto whole = all.split_at(0);
+    CHECK(all.empty() && test::equal(whole, {1, 2, 3}));
+    auto nothing = whole.split_at(3);
+    CHECK(nothing.empty() && whole.size() == 3 && whole.back() == 3);
+    CHECK(whole.split_at(10).empty());
+
+    auto moved = whole.split_after(whole.before_begin());
+    CHECK(whole.empty() && test::equal(moved, {1, 2, 3}));
+    auto last = moved.begin();
+    ++last;
+    ++last;
+    CHECK(moved.split_after(last).empty() && moved.back() == 3);
+
+    mfpkg::forward_list<int> empty;
+    CHECK(empty.partition([](int) { return true; }).empty());
+    CHECK(empty.split_at(0).empty() && empty.split_after(empty.before_begin()).empty());
+}
+
+/*
+ * Nodes are relinked, so iterators keep referring to the same elements.
+ */
+static void iterators_follow_their_elements(void)
+{
+    mfpkg::forward_list<int> list {10, 11, 12, 13};
+    auto eleven = list.begin();
+    ++eleven;
+    auto odd = list.partition([](int x) { return x % 2 != 0; });
+    CHECK(odd.begin() == eleven && *eleven == 11);
+    auto after = eleven;
+    ++after;
+    CHECK(*after == 13);
+}
+
+/*
+ * Lists returned by value are moved out, even where the compiler cannot
+ * elide the return.
+ */
+static void relinking_copies_no_elements(void)
+{
+    mfpkg::forward_list<test::counted> list {1, 2, 3, 4, 5, 6};
+    test::counted::reset();
+    auto odd = list.partition([](const test::counted& c) { return c.value % 2 != 0; });
+    auto tail = list.split_at(1);
+    auto rest = odd.split_after(odd.begin());
+    auto pick = [&](bool first)
+    {
+        auto a = rest.split_at(1);
+        auto b = rest.split_at(0);
+        if(first)
+        {
+            return a;
+        }
+        return b;
+    };
+    auto last = pick(false);
+    CHECK(test::counted::copies == 0 && test::counted::moves == 0);
+    CHECK(test::equal(list, {test::counted(2)}) && test::equal(tail, {test::counted(4), test::counted(6)}));
+    CHECK(test::equal(odd, {test::counted(1)}) && test::equal(last, {test::counted(3)}));
+    CHECK(rest.empty());
+}
+
+int main(void)
+{
+    partition_and_split();
+    edge_cases();
+    iterators_follow_their_elements();
+    relinking_copies_no_elements();
+    return test::result();
+}
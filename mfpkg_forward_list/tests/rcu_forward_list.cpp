@@ -0,0 +1,100 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void writer_operations(void)
+{
+    mfpkg::rcu_forward_list<int> list {2, 3};
+    list.push_front(1);
+    list.push_back(4);
+    CHECK(test::equal(list, {1, 2, 3, 4}));
+    CHECK(list.size() == 4);
+
+    list.erase_after(list.begin());
+    list.pop_front();
+    CHECK(test::equal(list, {3, 4}));
+
+    auto it = list.insert_after(list.begin(), 5);
+    CHECK(*it == 5);
+    list.push_back(6);
+    CHECK(test::equal(list, {3, 5, 4, 6}));
+
+    mfpkg::rcu_forward_list<int> other {7, 8};
+    list.splice_after(list.before_begin(), other);
+    CHECK(test::equal(list, {7, 8, 3, 5, 4, 6}));
+    CHECK(other.empty() && other.size() == 0);
+    other.push_back(9);
+    CHECK(test::equal(other, {9}));
+
+    list.clear();
+    CHECK(list.empty());
+    list.push_back(1);
+    CHECK(test::equal(list, {1}));
+    list.synchronize();
+}
+
+/*
+ * Readers walk the list while a writer keeps inserting and erasing.  A
+ * reader must only ever see values the writer could have published, and
+ * every node it reaches must still be alive.
+ */
+static void readers_run_alongside_a_writer(void)
+{
+    mfpkg::rcu_forward_list<int> list(64);
+    for (int i = 0; i < 64; ++i)
+    {
+        list.push_back(i);
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<int> bad(0);
+    std::atomic<long> walks(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&]
+        {
+            while (!done.load(std::memory_order_relaxed))
+            {
+                auto guard = list.read_lock();
+                for (int x : list)
+                {
+                    if(x < 0 || x >= 1 << 20)
+                    {
+                        bad.fetch_add(1);
+                    }
+                }
+                walks.fetch_add(1);
+            }
+        });
+    }
+
+    for (int i = 0; i < 4000; ++i)
+    {
+        list.push_back(64 + i);
+        list.pop_front();
+        if(i % 7 == 0)
+        {
+            list.insert_after(list.begin(), i);
+            list.erase_after(list.begin());
+        }
+    }
+    while (walks.load() < 3)
+    {
+        std::this_thread::yield();
+    }
+    done = true;
+    for (std::thread& t : readers)
+    {
+        t.join();
+    }
+    CHECK(bad.load() == 0);
+    CHECK(list.size() == 64);
+    CHECK(list.begin() != list.end() && *list.begin() == 4000);
+}
+
+int main(void)
+{
+    writer_operations();
+    readers_run_alongside_a_writer();
+    return test::result();
+}
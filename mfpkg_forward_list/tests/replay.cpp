@@ -0,0 +1,168 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <sstream>
+
+#include "../benchmark/replay.h"
+
+static void check_list(bench::replay_list& list)
+{
+    CHECK(list.consistent());
+}
+
+static std::vector<mfpkg::trace_record> read_back(std::stringstream& out)
+{
+    std::stringstream in(out.str());
+    return mfpkg::trace_log::read(in);
+}
+
+static void replay_everywhere(const std::vector<mfpkg::trace_record>& trace)
+{
+    const int before = test::failures;
+    bench::replay<bench::backend::mfpkg>(trace, check_list);
+#if defined(MFPKG_HAS_NODE_ARENA)
+    {
+        mfpkg::node_arena arena(1 << 20, false);
+        mfpkg::node_arena::scope scope(arena);
+        bench::replay<bench::backend::arena>(trace, check_list);
+    }
+#endif
+    bench::replay<bench::backend::compact>(trace, check_list);
+    bench::replay<bench::backend::standard>(trace, check_list);
+    CHECK(test::failures == before);
+}
+
+/*
+ * pop_front after a remove forgot to count the popped element, so every
+ * later seek walked past the end of the list.
+ */
+static void pop_front_after_remove(void)
+{
+    std::stringstream out;
+    {
+        mfpkg::trace_log log(out);
+        mfpkg::traced_forward_list<int> list(log);
+        list.push_back(1);
+        list.push_back(2);
+        list.push_back(3);
+        list.remove(2);
+        list.pop_front();
+        list.pop_front();
+        list.push_back(4);
+        list.push_back(5);
+        CHECK(test::equal(list.list(), {4, 5}));
+    }
+    const std::vector<mfpkg::trace_record> trace = read_back(out);
+    const mfpkg::trace_op expected[] =
+    {
+        mfpkg::trace_op::create, mfpkg::trace_op::push_back, mfpkg::trace_op::push_back,
+        mfpkg::trace_op::push_back, mfpkg::trace_op::remove, mfpkg::trace_op::pop_front,
+        mfpkg::trace_op::pop_front, mfpkg::trace_op::push_back, mfpkg::trace_op::push_back,
+        mfpkg::trace_op::destroy
+    };
+    CHECK(trace.size() == std::size(expected));
+    bool same = trace.size() == std::size(expected);
+    for (std::size_t i = 0; same && i < trace.size(); ++i)
+    {
+        same = trace[i].op == expected[i] && trace[i].list == trace[0].list;
+    }
+    CHECK(same);
+    CHECK(trace[4].size == 1 && trace[7].position == 0 && trace[8].position == 1);
+    replay_everywhere(trace);
+}
+
+static void every_operation(void)
+{
+    std::stringstream out;
+    {
+        mfpkg::trace_log log(out);
+        mfpkg::traced_forward_list<std::string> a(log);
+        mfpkg::traced_forward_list<long> b(log);
+        for (int i = 0; i < 20; ++i)
+        {
+            a.push_back(std::string(std::size_t(i % 5), 'x'));
+            b.push_front(long(i * 37 % 11));
+        }
+        a.insert_after(a.begin(), "inserted");
+        a.erase_after(a.before_begin());
+        a.pop_back();
+        a.unique();
+        a.pop_front();
+        a.push_back("tail");
+
+        mfpkg::traced_forward_list<long> c(b);
+        b.sort();
+        b.unique();
+        b.reverse();
+        b.pop_back();
+        b.push_back(100);
+        c.splice_after(c.begin(), b, b.begin(), b.end());
+        b.push_back(1);
+        b.splice_after(b.before_begin(), c, c.before_begin());
+        c.resize(5, 9);
+        c.push_back(10);
+        c.pop_front();
+        c.resize(12);
+        c.push_back(11);
+        auto it = c.begin();
+        ++it;
+        auto last = it;
+        ++last;
+        ++last;
+        ++last;
+        c.erase_after(it, last);
+        c.push_back(12);
+        c.clear();
+        c.push_back(13);
+        b.remove(1);
+        b.push_back(14);
+        CHECK(c.list().size() == 1 && b.list().back() == 14);
+    }
+    const std::vector<mfpkg::trace_record> trace = read_back(out);
+    CHECK(trace.size() > 60);
+    CHECK(trace.front().op == mfpkg::trace_op::create && trace.back().op == mfpkg::trace_op::destroy);
+    replay_everywhere(trace);
+}
+
+static void bad_traces_are_rejected(void)
+{
+    std::stringstream empty;
+    bool thrown = false;
+    try
+    {
+        mfpkg::trace_log::read(empty);
+    }
+    catch (const std::ios_base::failure&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    std::stringstream out;
+    {
+        mfpkg::trace_log log(out);
+        mfpkg::traced_forward_list<int> list(log);
+        list.push_back(1);
+    }
+    std::string cut = out.str();
+    cut.pop_back();
+    std::stringstream truncated(cut);
+    thrown = false;
+    try
+    {
+        mfpkg::trace_log::read(truncated);
+    }
+    catch (const std::ios_base::failure&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+int main(void)
+{
+    pop_front_after_remove();
+    every_operation();
+    bad_traces_are_rejected();
+    return test::result();
+}
@@ -0,0 +1,220 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <sstream>
+
+namespace
+{
+    template <typename T>
+    bool fails_to_load(const std::string& bytes)
+    {
+        std::istringstream in(bytes);
+        try
+        {
+            mfpkg::deserialize<T>(in);
+        }
+        catch (const std::ios_base::failure&)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    /*
+     * A stream that cannot seek, so its size is unknown to deserialize.
+     */
+    struct unseekable_buf : std::streambuf
+    {
+        explicit unseekable_buf(std::string& bytes)
+        {
+            setg(&bytes[0], &bytes[0], &bytes[0] + bytes.size());
+        }
+    };
+
+    template <typename T>
+    bool fails_to_load_unseekable(std::string bytes)
+    {
+        unseekable_buf buf(bytes);
+        std::istream in(&buf);
+        try
+        {
+            mfpkg::deserialize<T>(in);
+        }
+        catch (const std::ios_base::failure&)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    std::string with_count(std::string bytes, std::size_t at, std::uint64_t count)
+    {
+        std::memcpy(&bytes[at], &count, sizeof count);
+        return bytes;
+    }
+
+    template <typename T>
+    std::string bytes_of(const mfpkg::forward_list<T>& list)
+    {
+        std::ostringstream out;
+        mfpkg::serialize(list, out);
+        return out.str();
+    }
+}
+
+static void stream_round_trip(void)
+{
+    mfpkg::forward_list<int> ints;
+    for (int i = 0; i < 5000; ++i)
+    {
+        ints.push_back(i * 3);
+    }
+    std::istringstream in(bytes_of(ints));
+    mfpkg::forward_list<int> back = mfpkg::deserialize<int>(in);
+    CHECK(back.size() == ints.size());
+    CHECK(std::equal(back.begin(), back.end(), ints.begin(), ints.end()));
+    back.push_back(-1);
+    CHECK(back.back() == -1);
+    back.pop_front();
+    CHECK(back.front() == 3);
+
+    mfpkg::forward_list<std::string> strings {"", "one", std::string(1000, 'z')};
+    std::istringstream sin(bytes_of(strings));
+    mfpkg::forward_list<std::string> sback = mfpkg::deserialize<std::string>(sin);
+    CHECK(test::equal(sback, {std::string(), std::string("one"), std::string(1000, 'z')}));
+
+    mfpkg::forward_list<double> empty;
+    std::istringstream ein(bytes_of(empty));
+    CHECK(mfpkg::deserialize<double>(ein).empty());
+}
+
+#if defined(MFPKG_HAS_FD_IO)
+template <typename T>
+static void descriptor_round_trip(const mfpkg::forward_list<T>& list)
+{
+    char path[] = "/tmp/mfpkg_serial_XXXXXX";
+    int fd = ::mkstemp(path);
+    CHECK(fd >= 0);
+    ::unlink(path);
+    mfpkg::serialize(list, fd);
+    ::lseek(fd, 0, SEEK_SET);
+    auto back = mfpkg::deserialize<T>(fd);
+    CHECK(std::equal(back.begin(), back.end(), list.begin(), list.end()));
+    ::close(fd);
+}
+
+static void descriptor_round_trip(void)
+{
+    mfpkg::forward_list<std::string> strings;
+    mfpkg::forward_list<long> longs;
+    for (int i = 0; i < 3000; ++i)
+    {
+        strings.push_back(std::string(std::size_t(i % 400), char('a' + i % 26)));
+        longs.push_back(long(i) << 20);
+    }
+    descriptor_round_trip(strings);
+    descriptor_round_trip(longs);
+}
+
+static void descriptor_counts_are_checked(void)
+{
+    mfpkg::forward_list<int> ints {1, 2, 3};
+    std::ostringstream out;
+    mfpkg::serialize(ints, out);
+    std::string bad = with_count(out.str(), 16, (std::uint64_t(1) << 60) + 2);
+
+    char path[] = "/tmp/mfpkg_serial_XXXXXX";
+    int fd = ::mkstemp(path);
+    CHECK(fd >= 0);
+    ::unlink(path);
+    CHECK(::write(fd, bad.data(), bad.size()) == ssize_t(bad.size()));
+    ::lseek(fd, 0, SEEK_SET);
+    bool thrown = false;
+    try
+    {
+        mfpkg::deserialize<int>(fd);
+    }
+    catch (const std::ios_base::failure&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    ::close(fd);
+
+    int ends[2];
+    CHECK(::pipe(ends) == 0);
+    CHECK(::write(ends[1], bad.data(), bad.size()) == ssize_t(bad.size()));
+    ::close(ends[1]);
+    thrown = false;
+    try
+    {
+        mfpkg::deserialize<int>(ends[0]);
+    }
+    catch (const std::ios_base::failure&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    ::close(ends[0]);
+}
+#endif
+
+static void malformed_input_is_rejected(void)
+{
+    mfpkg::forward_list<int> ints {1, 2, 3};
+    std::string good = bytes_of(ints);
+
+    CHECK(fails_to_load<int>(""));
+    CHECK(fails_to_load<int>(good.substr(0, good.size() - 1)));
+    CHECK(fails_to_load<long long>(good));
+    CHECK(fails_to_load<std::string>(good));
+
+    std::string bad_magic = good;
+    bad_magic[0] = 'X';
+    CHECK(fails_to_load<int>(bad_magic));
+
+    mfpkg::forward_list<std::string> strings {"abc"};
+    std::string text = bytes_of(strings);
+    CHECK(fails_to_load<std::string>(text.substr(0, text.size() - 1)));
+}
+
+/*
+ * Element counts and string lengths come from the input and must not
+ * drive allocations, whether or not the input size is known.
+ */
+static void corrupt_counts_are_rejected(void)
+{
+    mfpkg::forward_list<int> ints {1, 2, 3};
+    std::string good = bytes_of(ints);
+    for (std::uint64_t count : {std::uint64_t(4), std::uint64_t(1) << 40,
+                                (std::uint64_t(1) << 60) + 2, ~std::uint64_t(0)})
+    {
+        CHECK(fails_to_load<int>(with_count(good, 16, count)));
+        CHECK(fails_to_load_unseekable<int>(with_count(good, 16, count)));
+    }
+    std::string back = good;
+    unseekable_buf buf(back);
+    std::istream in(&buf);
+    CHECK(test::equal(mfpkg::deserialize<int>(in), {1, 2, 3}));
+
+    mfpkg::forward_list<std::string> strings {"abc"};
+    std::string text = bytes_of(strings);
+    for (std::uint64_t length : {std::uint64_t(4), std::uint64_t(1) << 62, ~std::uint64_t(0)})
+    {
+        CHECK(fails_to_load<std::string>(with_count(text, 24, length)));
+        CHECK(fails_to_load_unseekable<std::string>(with_count(text, 24, length)));
+    }
+    CHECK(fails_to_load<std::string>(with_count(text, 16, std::uint64_t(1) << 61)));
+}
+
+int main(void)
+{
+    stream_round_trip();
+#if defined(MFPKG_HAS_FD_IO)
+    descriptor_round_trip();
+    descriptor_counts_are_checked();
+#endif
+    malformed_input_is_rejected();
+    corrupt_counts_are_rejected();
+    return test::result();
+}
@@ -0,0 +1,181 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+typedef basic_mfpkg::simd_kernels kernels;
+
+static std::mt19937 random_engine(2024);
+
+/* Lengths on both sides of the block boundaries, and a few more. */
+static const std::size_t lengths[] =
+{
+    0, 1, 2, 3, 7, 31, 63, 64, 65, 127, 128, 129, 191, 192, 193, 300, 1000
+};
+
+template <typename T>
+static std::vector<T> random_values(std::size_t n)
+{
+    // A narrow range gives repeated values, and float sums stay exact.
+    std::uniform_int_distribution<int> pick(-20, 20);
+    std::vector<T> values(n);
+    for (T& x : values)
+    {
+        x = T(pick(random_engine));
+    }
+    return values;
+}
+
+template <typename T>
+static bool same(const mfpkg::forward_list<T>& list, const std::vector<T>& ref)
+{
+    return list.size() == ref.size() && std::equal(ref.begin(), ref.end(), list.begin());
+}
+
+/*
+ * Values worth probing in a list: those at and around block boundaries,
+ * the last one, and one that is absent.
+ */
+template <typename T>
+static std::vector<T> probes(const std::vector<T>& ref)
+{
+    std::vector<T> v {T(99)};
+    for (std::size_t i : {std::size_t(0), kernels::block - 1, kernels::block,
+                          2 * kernels::block + 1, ref.size() - 1})
+    {
+        if(i < ref.size())
+        {
+            v.push_back(ref[i]);
+        }
+    }
+    return v;
+}
+
+template <typename T>
+static void matches_scalar_reference(void)
+{
+    for (std::size_t n : lengths)
+    {
+        for (int round = 0; round < 4; ++round)
+        {
+            const std::vector<T> ref = random_values<T>(n);
+            mfpkg::forward_list<T> list;
+            for (T x : ref)
+            {
+                list.push_back(x);
+            }
+
+            bool searched = true;
+            for (T v : probes(ref))
+            {
+                searched = searched && list.count(v) == std::size_t(std::count(ref.begin(), ref.end(), v));
+                const std::size_t at = std::size_t(std::find(ref.begin(), ref.end(), v) - ref.begin());
+                auto it = list.find(v);
+                std::size_t i = 0;
+                for (auto p = list.begin(); p != it; ++p)
+                {
+                    ++i;
+                }
+                searched = searched && i == at && (it == list.end()) == (at == n);
+            }
+            CHECK(searched);
+
+            if(n)
+            {
+                CHECK(list.sum() == std::accumulate(ref.begin(), ref.end(), T(0)));
+                CHECK(list.min() == *std::min_element(ref.begin(), ref.end()));
+                CHECK(list.max() == *std::max_element(ref.begin(), ref.end()));
+            }
+            else
+            {
+                CHECK(list.sum() == T(0));
+            }
+
+            std::vector<T> kept = ref;
+            bool removed = true;
+            for (T v : probes(ref))
+            {
+                kept.erase(std::remove(kept.begin(), kept.end(), v), kept.end());
+                list.remove(v);
+                removed = removed && same(list, kept);
+                removed = removed && (kept.empty() ? list.empty() : list.back() == kept.back());
+            }
+            CHECK(removed);
+            list.push_back(T(42));
+            CHECK(list.back() == T(42) && list.size() == kept.size() + 1);
+        }
+    }
+}
+
+/*
+ * The kernels themselves, on unaligned blocks of every length.
+ */
+template <typename T>
+static void kernels_match_loops(void)
+{
+    std::vector<T> storage = random_values<T>(kernels::block + 3);
+    bool right = true;
+    for (std::size_t offset = 0; offset < 3; ++offset)
+    {
+        const T* p = storage.data() + offset;
+        for (std::size_t n = 0; n <= kernels::block; ++n)
+        {
+            for (T v : {p[0], p[n ? n - 1 : 0], T(99)})
+            {
+                std::uint64_t expected = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    expected |= std::uint64_t(p[i] == v) << i;
+                }
+                right = right && kernels::equal_mask(p, n, v) == expected;
+            }
+            if(n && kernels::reduces<T>)
+            {
+                right = right && kernels::sum(p, n) == std::accumulate(p, p + n, T(0));
+                right = right && kernels::min(p, n) == *std::min_element(p, p + n);
+                right = right && kernels::max(p, n) == *std::max_element(p, p + n);
+            }
+        }
+    }
+    CHECK(right);
+}
+
+/*
+ * Signed zeros compare equal and NaN never does, as with operator==.
+ */
+template <typename T>
+static void floating_point_equality(void)
+{
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    mfpkg::forward_list<T> list;
+    for (std::size_t i = 0; i < 2 * kernels::block + 5; ++i)
+    {
+        list.push_back(i % 3 == 0 ? T(-0.0) : i % 3 == 1 ? nan : T(i));
+    }
+    CHECK(list.count(T(0.0)) == 45);
+    CHECK(list.count(nan) == 0 && list.find(nan) == list.end());
+    CHECK(list.find(T(0.0)) == list.begin());
+    list.remove(T(0.0));
+    CHECK(list.size() == 88 && list.count(T(-0.0)) == 0);
+    list.remove(nan);
+    CHECK(list.size() == 88 && std::isnan(list.front()) && list.back() == T(2 * kernels::block + 3));
+}
+
+int main(void)
+{
+    matches_scalar_reference<int>();
+    matches_scalar_reference<float>();
+    matches_scalar_reference<double>();
+    matches_scalar_reference<std::int64_t>();
+    kernels_match_loops<int>();
+    kernels_match_loops<float>();
+    kernels_match_loops<double>();
+    kernels_match_loops<std::int64_t>();
+    kernels_match_loops<std::uint32_t>();
+    floating_point_equality<float>();
+    floating_point_equality<double>();
+    return test::result();
+}
@@ -0,0 +1,96 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <random>
+
+static void elements_stay_ordered(void)
+{
+    mfpkg::sorted_forward_list<int> list {5, 1, 4, 1, 3};
+    CHECK(test::equal(list, {1, 1, 3, 4, 5}));
+    CHECK(list.size() == 5 && list.front() == 1 && list.back() == 5);
+
+    list.insert(2);
+    list.insert(6);
+    CHECK(test::equal(list, {1, 1, 2, 3, 4, 5, 6}));
+    CHECK(*list.lower_bound(4) == 4);
+    CHECK(*list.upper_bound(4) == 5);
+    CHECK(list.upper_bound(6) == list.end());
+    CHECK(list.contains(3) && !list.contains(7));
+
+    CHECK(list.erase(3));
+    CHECK(!list.erase(3));
+    CHECK(list.remove(1) == 2);
+    CHECK(test::equal(list, {2, 4, 5, 6}));
+
+    list.erase(list.find(5));
+    list.pop_front();
+    CHECK(test::equal(list, {4, 6}));
+    CHECK(list.back() == 6);
+}
+
+static void equal_elements_keep_insertion_order(void)
+{
+    typedef std::pair<int, int> entry;
+    auto by_key = [](const entry& a, const entry& b) { return a.first < b.first; };
+    mfpkg::sorted_forward_list<entry, decltype(by_key)> list(by_key);
+    list.insert({1, 0});
+    list.insert({0, 0});
+    list.insert({1, 1});
+    list.insert({1, 2});
+    CHECK(test::equal(list, {entry{0, 0}, entry{1, 0}, entry{1, 1}, entry{1, 2}}));
+
+    list.erase(std::next(list.begin(), 2));
+    CHECK(test::equal(list, {entry{0, 0}, entry{1, 0}, entry{1, 2}}));
+}
+
+static void matches_a_sorted_vector(void)
+{
+    std::mt19937 rng(3);
+    mfpkg::sorted_forward_list<int> list;
+    std::vector<int> reference;
+    for (int i = 0; i < 20000; ++i)
+    {
+        int x = int(rng() % 1000);
+        if(rng() % 3)
+        {
+            list.insert(x);
+            reference.insert(std::upper_bound(reference.begin(), reference.end(), x), x);
+        }
+        else
+        {
+            auto it = std::lower_bound(reference.begin(), reference.end(), x);
+            bool present = it != reference.end() && *it == x;
+            CHECK(list.erase(x) == present);
+            if(present)
+            {
+                reference.erase(it);
+            }
+        }
+    }
+    CHECK(list.size() == reference.size());
+    CHECK(std::equal(list.begin(), list.end(), reference.begin(), reference.end()));
+}
+
+static void built_from_a_sorted_forward_list(void)
+{
+    mfpkg::forward_list<int> source {1, 2, 2, 7};
+    mfpkg::sorted_forward_list<int> list(source);
+    CHECK(test::equal(list, {1, 2, 2, 7}));
+    std::vector<int> more {7, 8, 9};
+    list.insert_sorted(more.begin(), more.end());
+    CHECK(test::equal(list, {1, 2, 2, 7, 7, 8, 9}));
+
+    mfpkg::sorted_forward_list<int> copy(list);
+    mfpkg::sorted_forward_list<int> moved(std::move(list));
+    CHECK(list.empty());
+    CHECK(std::equal(copy.begin(), copy.end(), moved.begin(), moved.end()));
+}
+
+int main(void)
+{
+    elements_stay_ordered();
+    equal_elements_keep_insertion_order();
+    matches_a_sorted_vector();
+    built_from_a_sorted_forward_list();
+    return test::result();
+}
@@ -0,0 +1,119 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void every_task_runs_once(void)
+{
+    auto& pool = basic_mfpkg::task_pool::instance();
+    CHECK(pool.capacity() >= 1);
+
+    std::vector<std::atomic<int>> hits(1000);
+    pool.run(hits.size(), 4, [&](std::size_t i) { hits[i].fetch_add(1); });
+    bool once = true;
+    for (auto& h : hits)
+    {
+        once = once && h.load() == 1;
+    }
+    CHECK(once);
+
+    pool.run(0, 4, [&](std::size_t) { CHECK(false); });
+}
+
+static void task_exceptions_reach_the_caller(void)
+{
+    bool thrown = false;
+    try
+    {
+        basic_mfpkg::task_pool::instance().run(64, 4, [](std::size_t i)
+        {
+            if(i == 17)
+            {
+                throw std::runtime_error("task");
+            }
+        });
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+}
+
+static void parallel_algorithms(void)
+{
+    mfpkg::forward_list<long> list;
+    for (long i = 0; i < 100000; ++i)
+    {
+        list.push_back(i);
+    }
+
+    long expected = 99999L * 100000L / 2;
+    CHECK(mfpkg::parallel::reduce(list, 4) == expected);
+
+    mfpkg::parallel::transform_inplace(list, [](long x) { return x * 2; }, 4);
+    CHECK(mfpkg::parallel::reduce(list, 0L, std::plus<>(), 4) == 2 * expected);
+
+    std::atomic<long> seen(0);
+    mfpkg::parallel::for_each(list, [&](long& x) { seen.fetch_add(x); }, 4);
+    CHECK(seen.load() == 2 * expected);
+
+    CHECK(mfpkg::parallel::count_if(list, [](long x) { return x % 4 == 0; }, 4) == 50000);
+
+    auto it = mfpkg::parallel::find_if(list, [](long x) { return x > 1000; }, 4);
+    CHECK(it != list.end() && *it == 1002);
+    CHECK(mfpkg::parallel::find_if(list, [](long x) { return x < 0; }, 4) == list.end());
+
+    mfpkg::forward_list<long> empty;
+    CHECK(mfpkg::parallel::reduce(empty, 4) == 0);
+    CHECK(mfpkg::parallel::find_if(empty, [](long) { return true; }, 4) == empty.end());
+}
+
+/*
+ * Parallel calls made from inside a task run inline instead of waiting
+ * for the pool, which is busy with the outer job.
+ */
+static void nested_jobs_run_inline(void)
+{
+    mfpkg::forward_list<long> inner;
+    for (int i = 0; i < 1000; ++i)
+    {
+        inner.push_back(1);
+    }
+    mfpkg::forward_list<int> outer {1, 2, 3, 4, 5, 6, 7, 8};
+
+    std::atomic<long> total(0);
+    mfpkg::parallel::for_each(outer, [&](int& x)
+    {
+        total.fetch_add(x * mfpkg::parallel::reduce(inner, 4));
+    }, 4);
+    CHECK(total.load() == 36 * 1000);
+
+    bool thrown = false;
+    try
+    {
+        basic_mfpkg::task_pool::instance().run(2, 2, [](std::size_t)
+        {
+            basic_mfpkg::task_pool::instance().run(3, 2, [](std::size_t i)
+            {
+                if(i == 1)
+                {
+                    throw std::runtime_error("nested");
+                }
+            });
+        });
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(mfpkg::parallel::reduce(inner, 4) == 1000);
+}
+
+int main(void)
+{
+    every_task_runs_once();
+    task_exceptions_reach_the_caller();
+    parallel_algorithms();
+    nested_jobs_run_inline();
+    return test::result();
+}
@@ -0,0 +1,210 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <random>
+
+typedef mfpkg::timing_wheel<int> wheel_type;
+
+namespace
+{
+    /* Counts the values alive, and so the timer nodes holding them. */
+    struct alive
+    {
+        static inline long count = 0;
+
+        alive() noexcept { ++count; }
+        alive(const alive&) noexcept { ++count; }
+        alive(alive&&) noexcept { ++count; }
+        ~alive() { --count; }
+    };
+
+    std::vector<int> values(const wheel_type::expired_list& list)
+    {
+        std::vector<int> out;
+        for (const auto& e : list)
+        {
+            out.push_back(e.value);
+        }
+        return out;
+    }
+}
+
+static void timers_fall_due_in_deadline_order(void)
+{
+    wheel_type wheel;
+    wheel.schedule(5, 1);
+    wheel.schedule(300, 2);
+    wheel.schedule(70000, 3);
+    wheel.schedule_after(2, 0);
+    CHECK(wheel.pending() == 4);
+
+    CHECK(wheel.advance(1).empty());
+    CHECK((values(wheel.tick()) == std::vector<int>{0}));
+    CHECK((values(wheel.advance(299)) == std::vector<int>{1}));
+    auto due = wheel.advance(100000);
+    CHECK((values(due) == std::vector<int>{2, 3}));
+    CHECK(due.front().deadline == 300);
+    CHECK(wheel.now() == 100000 && wheel.empty());
+}
+
+static void overdue_timers_fire_on_the_next_tick(void)
+{
+    wheel_type wheel(1000);
+    wheel.schedule(10, 7);
+    CHECK((values(wheel.advance(1001)) == std::vector<int>{7}));
+}
+
+static void deadlines_on_turn_boundaries(void)
+{
+    wheel_type wheel;
+    wheel.schedule(256, 1);
+    wheel.schedule(65536, 2);
+    wheel.schedule(std::uint64_t(1) << 32, 3);
+    CHECK((values(wheel.advance(256)) == std::vector<int>{1}));
+    CHECK((values(wheel.advance(65536)) == std::vector<int>{2}));
+    CHECK((values(wheel.advance(std::uint64_t(1) << 32)) == std::vector<int>{3}));
+}
+
+static void cancelled_timers_never_fire(void)
+{
+    wheel_type wheel;
+    auto a = wheel.schedule(10, 1);
+    auto b = wheel.schedule(1 << 20, 2);
+    wheel.schedule(10, 3);
+    CHECK(wheel.cancel(a));
+    CHECK(!a);
+    CHECK(!wheel.cancel(a));
+    CHECK(wheel.cancel(b));
+    CHECK(wheel.pending() == 1);
+    CHECK((values(wheel.advance(1 << 21)) == std::vector<int>{3}));
+    CHECK(wheel.empty());
+}
+
+static void timers_beyond_the_last_ring(void)
+{
+    wheel_type wheel((std::uint64_t(1) << 32) - 10);
+    std::uint64_t far = std::uint64_t(1) << 40;
+    wheel.schedule(far, 1);
+    wheel.schedule((std::uint64_t(1) << 32) + 5, 0);
+    CHECK((values(wheel.advance(std::uint64_t(1) << 33)) == std::vector<int>{0}));
+    auto due = wheel.advance(far);
+    CHECK((values(due) == std::vector<int>{1}));
+    CHECK(!due.empty() && due.front().deadline == far);
+}
+
+/*
+ * Random schedules, cancellations and advances checked against a plain
+ * map of deadlines.
+ */
+static void matches_a_reference_model(void)
+{
+    std::mt19937_64 rng(11);
+    wheel_type wheel;
+    std::map<int, std::uint64_t> live;
+    std::vector<wheel_type::handle> handles;
+    for (int step = 0; step < 20000; ++step)
+    {
+        unsigned op = unsigned(rng() % 4);
+        if(op < 2)
+        {
+            std::uint64_t span[] = {256, 65536, std::uint64_t(1) << 24};
+            std::uint64_t deadline = wheel.now() + 1 + rng() % span[rng() % 3];
+            live[int(handles.size())] = deadline;
+            handles.push_back(wheel.schedule(deadline, int(handles.size())));
+        }
+        else if(op == 2 && !live.empty())
+        {
+            auto it = std::next(live.begin(), long(rng() % live.size()));
+            CHECK(wheel.cancel(handles[std::size_t(it->first)]));
+            live.erase(it);
+        }
+        else
+        {
+            std::uint64_t to = wheel.now() + rng() % 5000;
+            std::vector<std::pair<std::uint64_t, int>> expected;
+            for (auto& [id, deadline] : live)
+            {
+                if(deadline <= to)
+                {
+                    expected.push_back({deadline, id});
+                }
+            }
+            std::vector<std::pair<std::uint64_t, int>> got;
+            for (const auto& e : wheel.advance(to))
+            {
+                got.push_back({e.deadline, e.value});
+                live.erase(e.value);
+            }
+            std::sort(expected.begin(), expected.end());
+            CHECK(std::is_sorted(got.begin(), got.end(),
+                                 [](const auto& a, const auto& b) { return a.first < b.first; }));
+            std::sort(got.begin(), got.end());
+            CHECK(got == expected);
+        }
+        CHECK(wheel.pending() == live.size());
+    }
+}
+
+/*
+ * A timer cancelled before the wheel reaches its slot used to stay
+ * linked for good when the wheel then emptied and its clock jumped.
+ */
+static void cancelled_timers_are_reclaimed(void)
+{
+    {
+        mfpkg::timing_wheel<alive> wheel;
+        long peak = 0;
+        for (int i = 0; i < 10000; ++i)
+        {
+            auto h = wheel.schedule_after(std::uint64_t(1000 + i % 5) << (i % 4 * 8), alive());
+            CHECK(wheel.cancel(h) && alive::count == 1);
+            wheel.tick();
+            peak = std::max(peak, alive::count);
+        }
+        CHECK(peak == 0);
+        CHECK(wheel.empty());
+    }
+
+    // With live timers around, cancelled ones are swept once they
+    // outnumber the live ones and the slots of a ring.
+    {
+        mfpkg::timing_wheel<alive> wheel;
+        std::vector<mfpkg::timing_wheel<alive>::handle> keep;
+        for (int i = 0; i < 100; ++i)
+        {
+            keep.push_back(wheel.schedule(1 << 20, alive()));
+        }
+        long peak = 0;
+        for (int i = 0; i < 20000; ++i)
+        {
+            auto h = wheel.schedule_after(std::uint64_t(500 + i), alive());
+            CHECK(wheel.cancel(h));
+            if(i % 16 == 0)
+            {
+                wheel.tick();
+            }
+            peak = std::max(peak, alive::count);
+        }
+        CHECK(peak <= 100 + long(wheel_type::slots) + 1);
+        CHECK(wheel.pending() == 100);
+        CHECK(wheel.cancel(keep[3]) && wheel.pending() == 99);
+        CHECK(wheel.advance(1 << 20).size() == 99);
+        CHECK(alive::count == 0);
+
+        wheel.schedule_after(5, alive());
+        CHECK(wheel.advance(wheel.now() + 5).size() == 1);
+    }
+    CHECK(alive::count == 0);
+}
+
+int main(void)
+{
+    timers_fall_due_in_deadline_order();
+    overdue_timers_fire_on_the_next_tick();
+    deadlines_on_turn_boundaries();
+    cancelled_timers_never_fire();
+    timers_beyond_the_last_ring();
+    matches_a_reference_model();
+    cancelled_timers_are_reclaimed();
+    return test::result();
+}
@@ -0,0 +1,111 @@
+#include "mfpkg.h"
+#include "check.h"
+
+#include <cctype>
+#include <random>
+#include <unordered_set>
+
+static void first_occurrences_are_kept(void)
+{
+    mfpkg::forward_list<int> list {5, 1, 4, 1, 5, 9, 2, 6};
+    list.unique_all();
+    CHECK(test::equal(list, {5, 1, 4, 9, 2, 6}));
+    CHECK(list.size() == 6 && list.back() == 6);
+
+    mfpkg::forward_list<int> same {3, 3, 3, 3};
+    same.unique_all();
+    CHECK(test::equal(same, {3}) && same.back() == 3);
+    same.push_back(4);
+    CHECK(test::equal(same, {3, 4}));
+
+    mfpkg::forward_list<int> empty;
+    empty.unique_all();
+    CHECK(empty.empty());
+
+    mfpkg::forward_list<int> last {1, 2, 1};
+    last.unique_all();
+    CHECK(test::equal(last, {1, 2}) && last.back() == 2);
+    last.push_back(7);
+    CHECK(test::equal(last, {1, 2, 7}));
+}
+
+static void matches_a_set_filter(void)
+{
+    std::mt19937 engine(7);
+    for (std::size_t n : {std::size_t(1), std::size_t(10), std::size_t(1000), std::size_t(50000)})
+    {
+        std::uniform_int_distribution<int> pick(0, int(n / 2));
+        mfpkg::forward_list<int> list;
+        std::vector<int> expected;
+        std::unordered_set<int> seen;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            const int x = pick(engine);
+            list.push_back(x);
+            if(seen.insert(x).second)
+            {
+                expected.push_back(x);
+            }
+        }
+        list.unique_all();
+        CHECK(list.size() == expected.size());
+        CHECK(std::equal(expected.begin(), expected.end(), list.begin()));
+        CHECK(list.back() == expected.back());
+    }
+}
+
+namespace
+{
+    struct folded_hash
+    {
+        std::size_t operator()(const std::string& s) const
+        {
+            std::string folded(s);
+            for (char& c : folded)
+            {
+                c = char(std::tolower(static_cast<unsigned char>(c)));
+            }
+            return std::hash<std::string>()(folded);
+        }
+    };
+
+    struct folded_equal
+    {
+        bool operator()(const std::string& a, const std::string& b) const
+        {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y)
+            {
+                return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+            });
+        }
+    };
+}
+
+static void custom_hash_and_equality(void)
+{
+    mfpkg::forward_list<std::string> words {"Apple", "pear", "APPLE", "Pear", "fig", "apple"};
+    words.unique_all(folded_hash(), folded_equal());
+    CHECK(test::equal(words, {std::string("Apple"), std::string("pear"), std::string("fig")}));
+    CHECK(words.back() == "fig");
+}
+
+/*
+ * Elements are erased in place; the kept ones are neither copied nor moved.
+ */
+static void kept_elements_stay_put(void)
+{
+    mfpkg::forward_list<int> list {1, 2, 1, 3, 2};
+    const int* first = &list.front();
+    list.unique_all();
+    CHECK(&list.front() == first);
+    CHECK(test::equal(list, {1, 2, 3}));
+}
+
+int main(void)
+{
+    first_occurrences_are_kept();
+    matches_a_set_filter();
+    custom_hash_and_equality();
+    kept_elements_stay_put();
+    return test::result();
+}
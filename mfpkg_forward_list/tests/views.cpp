@@ -0,0 +1,80 @@
+#include "mfpkg.h"
+#include "check.h"
+
+static void pipelines_keep_element_order(void)
+{
+    mfpkg::forward_list<int> list {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    int last_seen = 0;
+    auto squares = list | mfpkg::views::filter([](int x) { return x % 2 == 0; })
+                        | mfpkg::views::transform([&](int x) { last_seen = x; return x * x; })
+                        | mfpkg::views::take_while([](int x) { return x < 50; })
+                        | mfpkg::views::to<mfpkg::forward_list>();
+    CHECK(test::equal(squares, {4, 16, 36}));
+    CHECK(squares.size() == 3 && squares.back() == 36);
+    CHECK(last_seen == 8);
+
+    auto words = list | mfpkg::views::transform([](int x) { return std::to_string(x); })
+                      | mfpkg::views::to<mfpkg::forward_list>();
+    CHECK(words.size() == 10 && words.front() == "1" && words.back() == "10");
+    words.push_back("11");
+    CHECK(words.back() == "11" && words.size() == 11);
+}
+
+static void chunks_cover_the_range(void)
+{
+    mfpkg::forward_list<int> list {1, 2, 3, 4, 5, 6, 7};
+    std::vector<int> sums;
+    std::vector<std::size_t> lengths;
+    for (auto part : list | mfpkg::views::chunk(3))
+    {
+        int sum = 0;
+        std::size_t n = 0;
+        for (int x : part)
+        {
+            sum += x;
+            ++n;
+        }
+        sums.push_back(sum);
+        lengths.push_back(n);
+    }
+    CHECK((sums == std::vector<int>{6, 15, 7}));
+    CHECK((lengths == std::vector<std::size_t>{3, 3, 1}));
+
+    std::size_t chunks = 0;
+    auto big = list | mfpkg::views::filter([](int x) { return x > 2; });
+    for (auto part : big | mfpkg::views::chunk(2))
+    {
+        (void)part;
+        ++chunks;
+    }
+    CHECK(chunks == 3);
+}
+
+static void empty_input(void)
+{
+    mfpkg::forward_list<int> empty;
+    auto none = empty | mfpkg::views::filter([](int) { return true; })
+                      | mfpkg::views::transform([](int x) { return x + 1; })
+                      | mfpkg::views::to<mfpkg::forward_list>();
+    CHECK(none.empty() && none.size() == 0);
+    none.push_back(1);
+    CHECK(none.back() == 1);
+
+    auto chunks = empty | mfpkg::views::chunk(4);
+    CHECK(chunks.begin() == chunks.end());
+
+    mfpkg::forward_list<int> list {1, 2, 3};
+    auto rejected = list | mfpkg::views::take_while([](int x) { return x > 5; })
+                         | mfpkg::views::to<mfpkg::forward_list>();
+    CHECK(rejected.empty());
+    auto filtered = list | mfpkg::views::filter([](int x) { return x > 5; });
+    CHECK(filtered.begin() == filtered.end());
+}
+
+int main(void)
+{
+    pipelines_keep_element_order();
+    chunks_cover_the_range();
+    empty_input();
+    return test::result();
+}